@@ -1,3 +1,4 @@
+#include <memory>
 #include "BasicBlock.h"
 #include "MemStream.h"
 #include "offsetof_def.h"
@@ -80,21 +81,19 @@ void CBasicBlock::Compile()
 
 	Framework::CMemStream stream;
 	{
-		static
-#ifdef AOT_BUILD_CACHE
-		    thread_local
-#endif
-		    CMipsJitter* jitter = nullptr;
-		if(jitter == nullptr)
+		//Each thread compiling blocks (ie.: one per virtual machine) needs its own jitter
+		static thread_local std::unique_ptr<CMipsJitter> jitter;
+		if(!jitter)
 		{
 			Jitter::CCodeGen* codeGen = Jitter::CreateCodeGen();
-			jitter = new CMipsJitter(codeGen);
+			jitter = std::make_unique<CMipsJitter>(codeGen);
 		}
 
 		jitter->GetCodeGen()->SetExternalSymbolReferencedHandler([&](auto symbol, auto offset, auto refType) { this->HandleExternalFunctionReference(symbol, offset, refType); });
 		jitter->SetStream(&stream);
+		jitter->SetClampingMode(m_context.m_clampingMode);
 		jitter->Begin();
-		CompileRange(jitter);
+		CompileRange(jitter.get());
 		jitter->End();
 	}
 
@@ -321,6 +320,225 @@ void CBasicBlock::CompileEpilog(CMipsJitter* jitter, bool loopsOnItself)
 	jitter->EndIf();
 }
 
+bool CBasicBlock::IsIdleLoopBlock(bool eeLoadsAllowed) const
+{
+	//Looks for a block branching on itself which only loads values and compares them,
+	//every iteration doing the same thing until something external changes memory
+	//(another processor, DMA, hardware registers or an interrupt handler).
+	enum OP
+	{
+		OP_SPECIAL = 0x00,
+		OP_REGIMM = 0x01,
+		OP_BEQ = 0x04,
+		OP_BNE = 0x05,
+		OP_BLEZ = 0x06,
+		OP_BGTZ = 0x07,
+		OP_ADDIU = 0x09,
+		OP_SLTI = 0x0A,
+		OP_SLTIU = 0x0B,
+		OP_ANDI = 0x0C,
+		OP_ORI = 0x0D,
+		OP_XORI = 0x0E,
+		OP_LUI = 0x0F,
+		OP_LQ = 0x1E,
+		OP_LB = 0x20,
+		OP_LH = 0x21,
+		OP_LW = 0x23,
+		OP_LBU = 0x24,
+		OP_LHU = 0x25,
+		OP_LWU = 0x27,
+		OP_LD = 0x37,
+	};
+
+	enum
+	{
+		OP_SPECIAL_SLL = 0x00,
+		OP_SPECIAL_SRL = 0x02,
+		OP_SPECIAL_SRA = 0x03,
+		OP_SPECIAL_ADDU = 0x21,
+		OP_SPECIAL_SUBU = 0x23,
+		OP_SPECIAL_AND = 0x24,
+		OP_SPECIAL_OR = 0x25,
+		OP_SPECIAL_XOR = 0x26,
+		OP_SPECIAL_NOR = 0x27,
+		OP_SPECIAL_SLT = 0x2A,
+		OP_SPECIAL_SLTU = 0x2B,
+	};
+
+	enum
+	{
+		OP_REGIMM_BLTZ = 0x00,
+		OP_REGIMM_BGEZ = 0x01,
+	};
+
+	//We need at least a branch and its delay slot
+	if(IsEmpty() || (m_end == m_begin)) return false;
+
+	uint32 endInstructionAddress = m_end - 4;
+	uint32 endInstruction = m_context.m_pMemoryMap->GetInstruction(endInstructionAddress);
+
+	//We need a branch at the end of the block
+	auto branchType = m_context.m_pArch->IsInstructionBranch(&m_context, endInstructionAddress, endInstruction);
+	if(branchType != MIPS_BRANCH_NORMAL) return false;
+
+	//Check that the branch target is ourself
+	uint32 branchTarget = m_context.m_pArch->GetInstructionEffectiveAddress(&m_context, endInstructionAddress, endInstruction);
+	if(branchTarget == MIPS_INVALID_PC) return false;
+	if(branchTarget != m_begin) return false;
+
+	//Check what kind of branching instruction we have
+	uint32 compareRs = (endInstruction >> 21) & 0x1F;
+	uint32 compareRt = 0;
+	bool alwaysTaken = false;
+	{
+		uint32 op = (endInstruction >> 26) & 0x3F;
+		uint32 rt = (endInstruction >> 16) & 0x1F;
+		switch(op)
+		{
+		case OP_BEQ:
+			//BEQ R0, R0 is an unconditional branch, waiting for an interrupt
+			alwaysTaken = (compareRs == rt);
+			[[fallthrough]];
+		case OP_BNE:
+			compareRt = rt;
+			break;
+		case OP_BLEZ:
+			alwaysTaken = (compareRs == 0);
+			break;
+		case OP_BGTZ:
+			break;
+		case OP_REGIMM:
+			if((rt != OP_REGIMM_BLTZ) && (rt != OP_REGIMM_BGEZ)) return false;
+			alwaysTaken = (rt == OP_REGIMM_BGEZ) && (compareRs == 0);
+			break;
+		default:
+			return false;
+		}
+	}
+
+	uint32 defState = 0; //Set of completely new definitions of registers within this block
+	uint32 useState = 0; //Set of previous state usage within this block
+
+	//Check all instructions inside to see if we can prove it's waiting for some kind of flag
+	for(uint32 address = m_begin; address <= m_end; address += 4)
+	{
+		//Don't check branch instruction as we've checked it already
+		if(address == endInstructionAddress) continue;
+
+		uint32 inst = m_context.m_pMemoryMap->GetInstruction(address);
+		if(inst == 0) continue;
+		uint32 special = inst & 0x3F;
+		uint32 rd = (inst >> 11) & 0x1F;
+		uint32 rt = (inst >> 16) & 0x1F;
+		uint32 rs = (inst >> 21) & 0x1F;
+		uint32 op = (inst >> 26) & 0x3F;
+
+		uint32 newDef = 0;
+		uint32 newUse = 0;
+
+		switch(op)
+		{
+		case OP_SPECIAL:
+			switch(special)
+			{
+			case OP_SPECIAL_SLL:
+			case OP_SPECIAL_SRL:
+			case OP_SPECIAL_SRA:
+				newUse = (1 << rt);
+				newDef = (1 << rd);
+				break;
+			case OP_SPECIAL_ADDU:
+			case OP_SPECIAL_SUBU:
+			case OP_SPECIAL_AND:
+			case OP_SPECIAL_OR:
+			case OP_SPECIAL_XOR:
+			case OP_SPECIAL_NOR:
+			case OP_SPECIAL_SLT:
+			case OP_SPECIAL_SLTU:
+				newUse = (1 << rs) | (1 << rt);
+				newDef = (1 << rd);
+				break;
+			default:
+				//We don't know what this does, let's not take a chance
+				return false;
+			}
+			break;
+		case OP_LUI:
+			newDef = (1 << rt);
+			break;
+		case OP_ADDIU:
+			//ADDIU R0, R0, $x is used for dynamic linking and raises an exception
+			if(rt == 0) return false;
+			[[fallthrough]];
+		case OP_SLTI:
+		case OP_SLTIU:
+		case OP_ANDI:
+		case OP_ORI:
+		case OP_XORI:
+		case OP_LB:
+		case OP_LH:
+		case OP_LW:
+		case OP_LBU:
+		case OP_LHU:
+			newUse = (1 << rs);
+			newDef = (1 << rt);
+			break;
+		case OP_LQ:
+		case OP_LWU:
+		case OP_LD:
+			//Only exist on the EE, these opcodes are reserved on the IOP
+			if(!eeLoadsAllowed) return false;
+			newUse = (1 << rs);
+			newDef = (1 << rt);
+			break;
+		default:
+			//We don't know what this does, let's not take a chance
+			return false;
+		}
+
+		//R0 always holds zero, it's never previous state
+		newUse &= ~1;
+		newDef &= ~1;
+
+		//Remove uses from defs within this block
+		newUse &= ~defState;
+		useState |= newUse;
+
+		//Bail if this defines any state that we previously used (including this instruction's own uses,
+		//ex.: ADDIU A0, A0, -1 is a counter, not something waiting for a flag)
+		if(useState & newDef)
+		{
+			return false;
+		}
+
+		defState |= newDef;
+	}
+
+	//Unless the branch is unconditional, the comparison must depend on something loaded within this block
+	bool compareRsDefined = defState & (1 << compareRs);
+	bool compareRtDefined = defState & (1 << compareRt);
+	if(!alwaysTaken && !compareRsDefined && !compareRtDefined)
+	{
+		return false;
+	}
+
+	return true;
+}
+
+void CBasicBlock::CompileIdleLoopCheck(CMipsJitter* jitter)
+{
+	//Only flag idleness when the loop is going around again, not when it's exiting.
+	//The branch being taken is enough since the loop's branch is the only one in the block.
+	jitter->PushCst(MIPS_INVALID_PC);
+	jitter->PushRel(offsetof(CMIPS, m_State.nDelayedJumpAddr));
+	jitter->BeginIf(Jitter::CONDITION_NE);
+	{
+		jitter->PushCst(MIPS_EXCEPTION_IDLE);
+		jitter->PullRel(offsetof(CMIPS, m_State.nHasException));
+	}
+	jitter->EndIf();
+}
+
 void CBasicBlock::Execute()
 {
 	m_function(&m_context);
@@ -473,6 +691,38 @@ void CBasicBlock::CopyFunctionFrom(const std::shared_ptr<CBasicBlock>& other)
 #endif
 }
 
+#ifndef AOT_USE_CACHE
+
+CBasicBlock::CodeTemplatePtr CBasicBlock::GetCodeTemplate()
+{
+	if(!m_codeTemplate)
+	{
+		//Links are patched in the code, the template must be taken before any is made
+#ifdef _DEBUG
+		for(uint32 i = 0; i < LINK_SLOT_MAX; i++)
+		{
+			assert(m_linkBlock[i] == nullptr);
+		}
+#endif
+		assert(IsCompiled());
+		auto codeTemplate = std::make_shared<CODE_TEMPLATE>();
+		codeTemplate->function = m_function.CreateInstance();
+		std::copy(std::begin(m_linkBlockTrampolineOffset), std::end(m_linkBlockTrampolineOffset), codeTemplate->linkBlockTrampolineOffset);
+		m_codeTemplate = std::move(codeTemplate);
+	}
+	return m_codeTemplate;
+}
+
+void CBasicBlock::CopyFunctionFrom(const CodeTemplatePtr& codeTemplate)
+{
+	m_function = codeTemplate->function.CreateInstance();
+	std::copy(std::begin(codeTemplate->linkBlockTrampolineOffset), std::end(codeTemplate->linkBlockTrampolineOffset), m_linkBlockTrampolineOffset);
+	//Keeps the template alive as long as blocks made from it exist
+	m_codeTemplate = codeTemplate;
+}
+
+#endif
+
 #ifdef DEBUGGER_INCLUDED
 
 bool CBasicBlock::HasBreakpoint() const
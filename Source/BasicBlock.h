@@ -97,6 +97,19 @@ public:
 
 	void CopyFunctionFrom(const std::shared_ptr<CBasicBlock>& basicBlock);
 
+#ifndef AOT_USE_CACHE
+	//Unlinked copy of a block's code, blocks with the same contents can be created from it without compiling
+	struct CODE_TEMPLATE
+	{
+		CMemoryFunction function;
+		uint32 linkBlockTrampolineOffset[LINK_SLOT_MAX];
+	};
+	typedef std::shared_ptr<CODE_TEMPLATE> CodeTemplatePtr;
+
+	CodeTemplatePtr GetCodeTemplate();
+	void CopyFunctionFrom(const CodeTemplatePtr&);
+#endif
+
 protected:
 	uint32 m_begin;
 	uint32 m_end;
@@ -106,6 +119,10 @@ protected:
 	virtual void CompileProlog(CMipsJitter*);
 	virtual void CompileEpilog(CMipsJitter*, bool);
 
+	//LQ, LD and LWU loads are only recognized if the EE loads flag is set
+	bool IsIdleLoopBlock(bool) const;
+	void CompileIdleLoopCheck(CMipsJitter*);
+
 private:
 	void HandleExternalFunctionReference(uintptr_t, uint32, Jitter::CCodeGen::SYMBOL_REF_TYPE);
 
@@ -122,6 +139,7 @@ private:
 
 #ifndef AOT_USE_CACHE
 	CMemoryFunction m_function;
+	CodeTemplatePtr m_codeTemplate;
 #else
 	void (*m_function)(void*);
 #endif
@@ -247,10 +247,11 @@ void CCOP_FPU::BC1TL()
 void CCOP_FPU::ADD_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_AddS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 }
 
@@ -258,10 +259,11 @@ void CCOP_FPU::ADD_S()
 void CCOP_FPU::SUB_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_SubS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 }
 
@@ -269,10 +271,11 @@ void CCOP_FPU::SUB_S()
 void CCOP_FPU::MUL_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_MulS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 }
 
@@ -290,10 +293,11 @@ void CCOP_FPU::DIV_S()
 	m_codeGen->Else();
 	{
 		m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-		m_codeGen->FP_ClampS();
+		m_codeGen->FP_ClampOperandS();
 		m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-		m_codeGen->FP_ClampS();
+		m_codeGen->FP_ClampOperandS();
 		m_codeGen->FP_DivS();
+		m_codeGen->FP_ClampResultS();
 		m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 	}
 	m_codeGen->EndIf();
@@ -303,9 +307,10 @@ void CCOP_FPU::DIV_S()
 void CCOP_FPU::SQRT_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_AbsS();
 	m_codeGen->FP_SqrtS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 }
 
@@ -354,11 +359,12 @@ void CCOP_FPU::RSQRT_S()
 	m_codeGen->Else();
 	{
 		m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-		m_codeGen->FP_ClampS();
+		m_codeGen->FP_ClampOperandS();
 		m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-		m_codeGen->FP_ClampS();
+		m_codeGen->FP_ClampOperandS();
 		m_codeGen->FP_RsqrtS();
 		m_codeGen->FP_MulS();
+		m_codeGen->FP_ClampResultS();
 		m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 	}
 	m_codeGen->EndIf();
@@ -368,10 +374,11 @@ void CCOP_FPU::RSQRT_S()
 void CCOP_FPU::ADDA_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_AddS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1A));
 }
 
@@ -379,10 +386,11 @@ void CCOP_FPU::ADDA_S()
 void CCOP_FPU::SUBA_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_SubS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1A));
 }
 
@@ -390,10 +398,11 @@ void CCOP_FPU::SUBA_S()
 void CCOP_FPU::MULA_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_MulS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1A));
 }
 
@@ -401,13 +410,14 @@ void CCOP_FPU::MULA_S()
 void CCOP_FPU::MADD_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1A));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_MulS();
 	m_codeGen->FP_AddS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 }
 
@@ -415,13 +425,14 @@ void CCOP_FPU::MADD_S()
 void CCOP_FPU::MSUB_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1A));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_MulS();
 	m_codeGen->FP_SubS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 }
 
@@ -429,13 +440,14 @@ void CCOP_FPU::MSUB_S()
 void CCOP_FPU::MADDA_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1A));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_MulS();
 	m_codeGen->FP_AddS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1A));
 }
 
@@ -443,13 +455,14 @@ void CCOP_FPU::MADDA_S()
 void CCOP_FPU::MSUBA_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1A));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_MulS();
 	m_codeGen->FP_SubS();
+	m_codeGen->FP_ClampResultS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1A));
 }
 
@@ -467,9 +480,9 @@ void CCOP_FPU::CVT_W_S()
 void CCOP_FPU::MAX_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_MaxS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 }
@@ -478,9 +491,9 @@ void CCOP_FPU::MAX_S()
 void CCOP_FPU::MIN_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 	m_codeGen->FP_MinS();
 	m_codeGen->FP_PullRel32(offsetof(CMIPS, m_State.nCOP1[m_fd]));
 }
@@ -496,10 +509,10 @@ void CCOP_FPU::C_F_S()
 void CCOP_FPU::C_EQ_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 
 	m_codeGen->FP_CmpS(Jitter::CONDITION_EQ);
 
@@ -510,10 +523,10 @@ void CCOP_FPU::C_EQ_S()
 void CCOP_FPU::C_LT_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 
 	m_codeGen->FP_CmpS(Jitter::CONDITION_BL);
 
@@ -524,10 +537,10 @@ void CCOP_FPU::C_LT_S()
 void CCOP_FPU::C_LE_S()
 {
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_fs]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 
 	m_codeGen->FP_PushRel32(offsetof(CMIPS, m_State.nCOP1[m_ft]));
-	m_codeGen->FP_ClampS();
+	m_codeGen->FP_ClampOperandS();
 
 	m_codeGen->FP_CmpS(Jitter::CONDITION_BE);
 
@@ -8,6 +8,7 @@
 #include "discimages/CsoImageStream.h"
 #include "discimages/CueSheet.h"
 #include "discimages/IszImageStream.h"
+#include "discimages/MappedImageStream.h"
 #include "discimages/MdsDiscImage.h"
 #include "StdStream.h"
 #include "StdStreamUtils.h"
@@ -70,6 +71,26 @@ static std::unique_ptr<Framework::CStream> CreateImageStream(const fs::path& ima
 #endif
 }
 
+//Uncompressed images are mapped in memory when possible, saves a copy and a system call for every sector read
+static std::unique_ptr<Framework::CStream> CreateRawImageStream(const fs::path& imagePath)
+{
+#if !defined(_WIN32) && !defined(__EMSCRIPTEN__)
+	std::error_code errorCode;
+	if(fs::is_regular_file(imagePath, errorCode))
+	{
+		try
+		{
+			return std::make_unique<CMappedImageStream>(imagePath);
+		}
+		catch(...)
+		{
+			//Failed to map (ex.: not enough address space on 32-bit platforms), use a regular stream instead
+		}
+	}
+#endif
+	return CreateImageStream(imagePath);
+}
+
 static DiskUtils::OpticalMediaPtr CreateOpticalMediaFromCueSheet(const fs::path& imagePath)
 {
 	auto currentPath = imagePath.parent_path();
@@ -82,7 +103,7 @@ static DiskUtils::OpticalMediaPtr CreateOpticalMediaFromCueSheet(const fs::path&
 		{
 			assert(fileCommand->filetype == "BINARY");
 			auto filePath = currentPath / fileCommand->filename;
-			fileStream = std::shared_ptr<Framework::CStream>(CreateImageStream(filePath));
+			fileStream = std::shared_ptr<Framework::CStream>(CreateRawImageStream(filePath));
 			break;
 		}
 	}
@@ -101,7 +122,7 @@ static DiskUtils::OpticalMediaPtr CreateOpticalMediaFromMds(const fs::path& imag
 	//Create image data path
 	auto imageDataPath = imagePath;
 	imageDataPath.replace_extension("mdf");
-	auto imageDataStream = std::shared_ptr<Framework::CStream>(CreateImageStream(imageDataPath));
+	auto imageDataStream = std::shared_ptr<Framework::CStream>(CreateRawImageStream(imageDataPath));
 
 	return COpticalMedia::CreateDvd(imageDataStream, discImage.IsDualLayer(), discImage.GetLayerBreak());
 }
@@ -185,7 +206,7 @@ DiskUtils::OpticalMediaPtr DiskUtils::CreateOpticalMediaFromPath(const fs::path&
 	//If it's null after all that, just feed it to a StdStream
 	if(!stream)
 	{
-		stream = std::shared_ptr<Framework::CStream>(CreateImageStream(imagePath));
+		stream = std::shared_ptr<Framework::CStream>(CreateRawImageStream(imagePath));
 	}
 
 	return COpticalMedia::CreateAuto(stream, opticalMediaCreateFlags);
@@ -6,6 +6,16 @@ class CMipsJitter;
 
 namespace FpUtils
 {
+	enum CLAMPING_MODE
+	{
+		//Don't clamp anything, INF/NaN values behave like on the host
+		CLAMPING_MODE_NONE,
+		//Only clamp results of arithmetic operations
+		CLAMPING_MODE_RESULT,
+		//Clamp operands of arithmetic operations
+		CLAMPING_MODE_FULL,
+	};
+
 	void SetDenormalHandlingMode();
 	void EnableFpExceptions();
 
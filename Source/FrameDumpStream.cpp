@@ -0,0 +1,423 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include "zstd_zlibwrapper.h"
+#include "FrameDumpStream.h"
+
+using namespace FrameDumpStream;
+
+//Register writes are serialized as packed (register, value) pairs
+static const uint32 g_registerWriteSize = sizeof(uint8) + sizeof(uint64);
+
+static const uint32 g_deflateBufferSize = 0x10000;
+static const uint32 g_keyFramePageCount = CGSHandler::RAMSIZE / KEYFRAME_PAGE_SIZE;
+
+CFrameDumpStreamWriter::CFrameDumpStreamWriter(StreamPtr stream, uint32 keyFrameInterval, uint32 fullKeyFrameInterval)
+    : m_stream(std::move(stream))
+    , m_keyFrameInterval(std::max<uint32>(keyFrameInterval, 1))
+    , m_fullKeyFrameInterval(std::max<uint32>(fullKeyFrameInterval, 1))
+    , m_deflateBuffer(g_deflateBufferSize)
+{
+	m_stream->Write32(STREAM_MAGIC);
+	m_stream->Write32(STREAM_VERSION);
+}
+
+CFrameDumpStreamWriter::~CFrameDumpStreamWriter()
+{
+	if(m_deflateStream)
+	{
+		deflateEnd(m_deflateStream.get());
+	}
+}
+
+bool CFrameDumpStreamWriter::IsKeyFrameNeeded() const
+{
+	if(!m_hasKeyFrame) return true;
+	return (m_frameIndex - m_lastKeyFrameIndex) >= m_keyFrameInterval;
+}
+
+void CFrameDumpStreamWriter::WriteKeyFrame(const uint8* gsRam, const uint64* gsRegisters, uint64 smode2)
+{
+	if(m_blockActive)
+	{
+		EndBlock();
+	}
+
+	bool fullKeyFrame = (m_keyFrameCount % m_fullKeyFrameInterval) == 0;
+	if(fullKeyFrame)
+	{
+		m_keyFrameRam.assign(gsRam, gsRam + CGSHandler::RAMSIZE);
+	}
+
+	BeginBlock(BLOCK_TYPE_KEYFRAME, fullKeyFrame ? BLOCK_FLAG_FULL_KEYFRAME : 0);
+	WriteBlockData(gsRegisters, sizeof(uint64) * CGSHandler::REGISTER_MAX);
+	WriteBlockData(&smode2, sizeof(uint64));
+	for(uint32 pageIndex = 0; pageIndex < g_keyFramePageCount; pageIndex++)
+	{
+		uint32 pageOffset = pageIndex * KEYFRAME_PAGE_SIZE;
+		const uint8* page = gsRam + pageOffset;
+		uint8* prevPage = m_keyFrameRam.data() + pageOffset;
+		if(!fullKeyFrame)
+		{
+			if(!memcmp(page, prevPage, KEYFRAME_PAGE_SIZE)) continue;
+			memcpy(prevPage, page, KEYFRAME_PAGE_SIZE);
+		}
+		WriteBlockData(&pageIndex, sizeof(uint32));
+		WriteBlockData(page, KEYFRAME_PAGE_SIZE);
+	}
+	EndBlock();
+
+	m_hasKeyFrame = true;
+	m_lastKeyFrameIndex = m_frameIndex;
+	m_keyFrameCount++;
+
+	BeginBlock(BLOCK_TYPE_PACKETS);
+}
+
+void CFrameDumpStreamWriter::AddRegisterPacket(const CGSHandler::RegisterWrite* registerWrites, uint32 count, const CGsPacketMetadata* metadata)
+{
+	if(!m_hasKeyFrame) return;
+	uint32 pathIndex = metadata ? metadata->pathIndex : 0;
+	m_recordBuffer.resize(count * g_registerWriteSize);
+	uint8* recordPtr = m_recordBuffer.data();
+	for(uint32 i = 0; i < count; i++)
+	{
+		const auto& registerWrite = registerWrites[i];
+		recordPtr[0] = registerWrite.first;
+		memcpy(recordPtr + 1, &registerWrite.second, sizeof(uint64));
+		recordPtr += g_registerWriteSize;
+	}
+	WriteRecordHeader(RECORD_TYPE_REGISTERS, sizeof(uint32) + m_recordBuffer.size());
+	WriteBlockData(&pathIndex, sizeof(uint32));
+	WriteBlockData(m_recordBuffer.data(), m_recordBuffer.size());
+}
+
+void CFrameDumpStreamWriter::AddImagePacket(const uint8* imageData, uint32 size)
+{
+	if(!m_hasKeyFrame) return;
+	WriteRecordHeader(RECORD_TYPE_IMAGE, size);
+	WriteBlockData(imageData, size);
+}
+
+void CFrameDumpStreamWriter::EndFrame()
+{
+	if(!m_hasKeyFrame) return;
+	WriteRecordHeader(RECORD_TYPE_FRAME_END, 0);
+	m_blockHeader.frameCount++;
+	m_frameIndex++;
+}
+
+void CFrameDumpStreamWriter::Finish()
+{
+	if(m_blockActive)
+	{
+		EndBlock();
+	}
+}
+
+void CFrameDumpStreamWriter::BeginBlock(BLOCK_TYPE type, uint32 flags)
+{
+	assert(!m_blockActive);
+
+	m_blockHeader = BLOCK_HEADER();
+	m_blockHeader.type = type;
+	m_blockHeader.flags = flags;
+	m_blockHeader.frameIndex = m_frameIndex;
+
+	//Header is written again with the final sizes when the block ends. A block
+	//with a zero compressed size is considered incomplete by the reader.
+	m_blockHeaderPosition = m_stream->Tell();
+	m_stream->Write(&m_blockHeader, sizeof(BLOCK_HEADER));
+
+	if(!m_deflateStream)
+	{
+		m_deflateStream = std::make_unique<z_stream>();
+	}
+	auto deflateStream = m_deflateStream.get();
+	memset(deflateStream, 0, sizeof(z_stream));
+	if(deflateInit(deflateStream, Z_DEFAULT_COMPRESSION) != Z_OK)
+	{
+		throw std::runtime_error("Failed to initialize frame dump stream compression.");
+	}
+	m_blockActive = true;
+}
+
+void CFrameDumpStreamWriter::WriteBlockData(const void* data, uint64 size)
+{
+	assert(m_blockActive);
+	auto deflateStream = m_deflateStream.get();
+	deflateStream->next_in = reinterpret_cast<Bytef*>(const_cast<void*>(data));
+	deflateStream->avail_in = static_cast<uInt>(size);
+	while(deflateStream->avail_in != 0)
+	{
+		deflateStream->next_out = m_deflateBuffer.data();
+		deflateStream->avail_out = g_deflateBufferSize;
+		deflate(deflateStream, Z_NO_FLUSH);
+		uint32 outputSize = g_deflateBufferSize - deflateStream->avail_out;
+		m_stream->Write(m_deflateBuffer.data(), outputSize);
+		m_blockHeader.compressedSize += outputSize;
+	}
+	m_blockHeader.uncompressedSize += size;
+}
+
+void CFrameDumpStreamWriter::EndBlock()
+{
+	assert(m_blockActive);
+	auto deflateStream = m_deflateStream.get();
+	deflateStream->next_in = nullptr;
+	deflateStream->avail_in = 0;
+	int result = Z_OK;
+	while(result != Z_STREAM_END)
+	{
+		deflateStream->next_out = m_deflateBuffer.data();
+		deflateStream->avail_out = g_deflateBufferSize;
+		result = deflate(deflateStream, Z_FINISH);
+		if((result != Z_OK) && (result != Z_STREAM_END))
+		{
+			throw std::runtime_error("Failed to compress frame dump stream block.");
+		}
+		uint32 outputSize = g_deflateBufferSize - deflateStream->avail_out;
+		m_stream->Write(m_deflateBuffer.data(), outputSize);
+		m_blockHeader.compressedSize += outputSize;
+	}
+	deflateEnd(deflateStream);
+
+	uint64 blockEndPosition = m_stream->Tell();
+	m_stream->Seek(m_blockHeaderPosition, Framework::STREAM_SEEK_SET);
+	m_stream->Write(&m_blockHeader, sizeof(BLOCK_HEADER));
+	m_stream->Seek(blockEndPosition, Framework::STREAM_SEEK_SET);
+
+	m_blockActive = false;
+}
+
+void CFrameDumpStreamWriter::WriteRecordHeader(RECORD_TYPE type, uint32 size)
+{
+	uint32 recordHeader[2] = {static_cast<uint32>(type), size};
+	WriteBlockData(recordHeader, sizeof(recordHeader));
+}
+
+CFrameDumpStreamReader::CFrameDumpStreamReader(Framework::CStream& stream)
+    : m_stream(stream)
+{
+	uint32 magic = m_stream.Read32();
+	uint32 version = m_stream.Read32();
+	if(magic != STREAM_MAGIC)
+	{
+		throw std::runtime_error("Not a frame dump stream.");
+	}
+	if(version != STREAM_VERSION)
+	{
+		throw std::runtime_error("Unsupported frame dump stream version.");
+	}
+	ScanBlocks();
+}
+
+uint32 CFrameDumpStreamReader::GetFrameCount() const
+{
+	return m_frameCount;
+}
+
+uint32 CFrameDumpStreamReader::ReadFrame(uint32 frameIndex, CFrameDump& frameDump)
+{
+	if(frameIndex >= m_frameCount)
+	{
+		throw std::runtime_error("Frame index out of range.");
+	}
+
+	auto packetBlockIterator = std::find_if(m_packetBlocks.begin(), m_packetBlocks.end(),
+	                                        [frameIndex](const BLOCK& block) {
+		                                        return (frameIndex >= block.header.frameIndex) &&
+		                                               (frameIndex < (block.header.frameIndex + block.header.frameCount));
+	                                        });
+	assert(packetBlockIterator != m_packetBlocks.end());
+	const auto& packetBlock = *packetBlockIterator;
+
+	//Find the keyframe that starts this packet block and the full keyframe it builds upon
+	auto keyFrameIterator = std::find_if(m_keyFrameBlocks.rbegin(), m_keyFrameBlocks.rend(),
+	                                     [&packetBlock](const BLOCK& block) {
+		                                     return block.header.frameIndex == packetBlock.header.frameIndex;
+	                                     });
+	if(keyFrameIterator == m_keyFrameBlocks.rend())
+	{
+		throw std::runtime_error("Missing keyframe for frame.");
+	}
+	auto fullKeyFrameIterator = std::find_if(keyFrameIterator, m_keyFrameBlocks.rend(),
+	                                         [](const BLOCK& block) {
+		                                         return (block.header.flags & BLOCK_FLAG_FULL_KEYFRAME) != 0;
+	                                         });
+	if(fullKeyFrameIterator == m_keyFrameBlocks.rend())
+	{
+		throw std::runtime_error("Missing full keyframe for frame.");
+	}
+
+	frameDump.Reset();
+	for(auto blockIterator = fullKeyFrameIterator.base() - 1; blockIterator != keyFrameIterator.base(); blockIterator++)
+	{
+		ApplyKeyFrame(*blockIterator, frameDump);
+	}
+
+	auto blockData = ReadBlockData(packetBlock);
+	uint32 targetFrame = frameIndex - packetBlock.header.frameIndex;
+	uint32 currentFrame = 0;
+	uint32 leadInPacketCount = 0;
+	uint32 packetCount = 0;
+	std::vector<CGSHandler::RegisterWrite> registerWrites;
+	uint64 position = 0;
+	while((position + (sizeof(uint32) * 2)) <= blockData.size())
+	{
+		uint32 recordHeader[2] = {};
+		memcpy(recordHeader, blockData.data() + position, sizeof(recordHeader));
+		position += sizeof(recordHeader);
+		uint32 recordType = recordHeader[0];
+		uint32 recordSize = recordHeader[1];
+		if((position + recordSize) > blockData.size())
+		{
+			throw std::runtime_error("Corrupted frame dump stream record.");
+		}
+		const uint8* recordData = blockData.data() + position;
+		position += recordSize;
+
+		switch(recordType)
+		{
+		case RECORD_TYPE_REGISTERS:
+		{
+			assert(recordSize >= sizeof(uint32));
+			CGsPacketMetadata metadata;
+			uint32 pathIndex = 0;
+			memcpy(&pathIndex, recordData, sizeof(uint32));
+			metadata.pathIndex = pathIndex;
+			uint32 writeCount = (recordSize - sizeof(uint32)) / g_registerWriteSize;
+			const uint8* writePtr = recordData + sizeof(uint32);
+			registerWrites.resize(writeCount);
+			for(auto& registerWrite : registerWrites)
+			{
+				registerWrite.first = writePtr[0];
+				memcpy(&registerWrite.second, writePtr + 1, sizeof(uint64));
+				writePtr += g_registerWriteSize;
+			}
+			frameDump.AddRegisterPacket(registerWrites.data(), writeCount, &metadata);
+			packetCount++;
+		}
+		break;
+		case RECORD_TYPE_IMAGE:
+			frameDump.AddImagePacket(recordData, recordSize);
+			packetCount++;
+			break;
+		case RECORD_TYPE_FRAME_END:
+			if(currentFrame == targetFrame)
+			{
+				return leadInPacketCount;
+			}
+			currentFrame++;
+			leadInPacketCount = packetCount;
+			break;
+		default:
+			assert(false);
+			break;
+		}
+	}
+
+	throw std::runtime_error("Frame not found in frame dump stream block.");
+}
+
+void CFrameDumpStreamReader::ScanBlocks()
+{
+	m_stream.Seek(0, Framework::STREAM_SEEK_END);
+	uint64 streamSize = m_stream.Tell();
+	uint64 position = sizeof(uint32) * 2;
+	uint32 nextFrameIndex = 0;
+	while((position + sizeof(BLOCK_HEADER)) <= streamSize)
+	{
+		BLOCK block;
+		m_stream.Seek(position, Framework::STREAM_SEEK_SET);
+		m_stream.Read(&block.header, sizeof(BLOCK_HEADER));
+		block.dataPosition = position + sizeof(BLOCK_HEADER);
+
+		//Incomplete block, capture was interrupted
+		if(block.header.compressedSize == 0) break;
+		if((block.dataPosition + block.header.compressedSize) > streamSize) break;
+
+		switch(block.header.type)
+		{
+		case BLOCK_TYPE_KEYFRAME:
+			m_keyFrameBlocks.push_back(block);
+			break;
+		case BLOCK_TYPE_PACKETS:
+			assert(block.header.frameIndex == nextFrameIndex);
+			nextFrameIndex = block.header.frameIndex + block.header.frameCount;
+			m_packetBlocks.push_back(block);
+			break;
+		default:
+			assert(false);
+			break;
+		}
+
+		position = block.dataPosition + block.header.compressedSize;
+	}
+	m_frameCount = nextFrameIndex;
+}
+
+std::vector<uint8> CFrameDumpStreamReader::ReadBlockData(const BLOCK& block)
+{
+	std::vector<uint8> compressedData(block.header.compressedSize);
+	m_stream.Seek(block.dataPosition, Framework::STREAM_SEEK_SET);
+	m_stream.Read(compressedData.data(), compressedData.size());
+
+	std::vector<uint8> data(block.header.uncompressedSize);
+
+	z_stream inflateStream;
+	memset(&inflateStream, 0, sizeof(z_stream));
+	if(inflateInit(&inflateStream) != Z_OK)
+	{
+		throw std::runtime_error("Failed to initialize frame dump stream decompression.");
+	}
+
+	inflateStream.next_in = compressedData.data();
+	inflateStream.avail_in = static_cast<uInt>(compressedData.size());
+	inflateStream.next_out = data.data();
+	inflateStream.avail_out = static_cast<uInt>(data.size());
+
+	int result = inflate(&inflateStream, Z_FINISH);
+	inflateEnd(&inflateStream);
+	if((result != Z_STREAM_END) || (inflateStream.total_out != data.size()))
+	{
+		throw std::runtime_error("Failed to decompress frame dump stream block.");
+	}
+
+	return data;
+}
+
+void CFrameDumpStreamReader::ApplyKeyFrame(const BLOCK& block, CFrameDump& frameDump)
+{
+	assert(block.header.type == BLOCK_TYPE_KEYFRAME);
+	auto blockData = ReadBlockData(block);
+	const uint32 registersSize = sizeof(uint64) * CGSHandler::REGISTER_MAX;
+	if(blockData.size() < (registersSize + sizeof(uint64)))
+	{
+		throw std::runtime_error("Corrupted frame dump stream keyframe.");
+	}
+
+	uint64 position = 0;
+	memcpy(frameDump.GetInitialGsRegisters(), blockData.data() + position, registersSize);
+	position += registersSize;
+
+	uint64 smode2 = 0;
+	memcpy(&smode2, blockData.data() + position, sizeof(uint64));
+	frameDump.SetInitialSMODE2(smode2);
+	position += sizeof(uint64);
+
+	uint8* gsRam = frameDump.GetInitialGsRam();
+	while((position + sizeof(uint32) + KEYFRAME_PAGE_SIZE) <= blockData.size())
+	{
+		uint32 pageIndex = 0;
+		memcpy(&pageIndex, blockData.data() + position, sizeof(uint32));
+		position += sizeof(uint32);
+		if(pageIndex >= g_keyFramePageCount)
+		{
+			throw std::runtime_error("Corrupted frame dump stream keyframe.");
+		}
+		memcpy(gsRam + (pageIndex * KEYFRAME_PAGE_SIZE), blockData.data() + position, KEYFRAME_PAGE_SIZE);
+		position += KEYFRAME_PAGE_SIZE;
+	}
+}
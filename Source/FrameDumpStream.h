@@ -0,0 +1,140 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+#include "Types.h"
+#include "Stream.h"
+#include "FrameDump.h"
+
+//Streaming frame dump format, used for captures spanning many frames.
+//
+//The stream is a sequence of independently compressed blocks:
+//- Keyframe blocks hold the GS registers and the GS RAM pages that changed since the
+//  previous keyframe (or all of GS RAM for full keyframes).
+//- Packet blocks hold the packets submitted to the GS from a keyframe up to the next one.
+//
+//Blocks are written as soon as they're complete, which keeps the writer's memory usage
+//bounded and lets the reader recover every complete block from a truncated capture.
+
+namespace FrameDumpStream
+{
+	enum
+	{
+		STREAM_MAGIC = 0x53444650, //'PFDS'
+		STREAM_VERSION = 1,
+	};
+
+	enum
+	{
+		KEYFRAME_PAGE_SIZE = 0x2000,
+	};
+
+	enum BLOCK_TYPE
+	{
+		BLOCK_TYPE_KEYFRAME = 1,
+		BLOCK_TYPE_PACKETS = 2,
+	};
+
+	enum RECORD_TYPE
+	{
+		RECORD_TYPE_REGISTERS = 1,
+		RECORD_TYPE_IMAGE = 2,
+		RECORD_TYPE_FRAME_END = 3,
+	};
+
+	enum BLOCK_FLAG
+	{
+		BLOCK_FLAG_FULL_KEYFRAME = 0x01,
+	};
+
+	struct BLOCK_HEADER
+	{
+		uint32 type = 0;
+		uint32 flags = 0;
+		uint32 frameIndex = 0;
+		uint32 frameCount = 0;
+		uint64 uncompressedSize = 0;
+		uint64 compressedSize = 0;
+	};
+	static_assert(sizeof(BLOCK_HEADER) == 0x20, "BLOCK_HEADER size must be 0x20 bytes.");
+}
+
+struct z_stream_s;
+
+class CFrameDumpStreamWriter
+{
+public:
+	enum
+	{
+		DEFAULT_KEYFRAME_INTERVAL = 30,
+		DEFAULT_FULL_KEYFRAME_INTERVAL = 10,
+	};
+
+	typedef std::unique_ptr<Framework::CStream> StreamPtr;
+
+	CFrameDumpStreamWriter(StreamPtr, uint32 keyFrameInterval = DEFAULT_KEYFRAME_INTERVAL, uint32 fullKeyFrameInterval = DEFAULT_FULL_KEYFRAME_INTERVAL);
+	virtual ~CFrameDumpStreamWriter();
+
+	//A keyframe is needed when the next frame starts a new block. GS RAM must be up to date when it's written.
+	bool IsKeyFrameNeeded() const;
+	void WriteKeyFrame(const uint8* gsRam, const uint64* gsRegisters, uint64 smode2);
+
+	void AddRegisterPacket(const CGSHandler::RegisterWrite*, uint32, const CGsPacketMetadata*);
+	void AddImagePacket(const uint8*, uint32);
+	void EndFrame();
+
+	void Finish();
+
+private:
+	void BeginBlock(FrameDumpStream::BLOCK_TYPE, uint32 flags = 0);
+	void WriteBlockData(const void*, uint64);
+	void EndBlock();
+	void WriteRecordHeader(FrameDumpStream::RECORD_TYPE, uint32);
+
+	StreamPtr m_stream;
+	uint32 m_keyFrameInterval = DEFAULT_KEYFRAME_INTERVAL;
+	uint32 m_fullKeyFrameInterval = DEFAULT_FULL_KEYFRAME_INTERVAL;
+
+	uint32 m_frameIndex = 0;
+	uint32 m_lastKeyFrameIndex = 0;
+	uint32 m_keyFrameCount = 0;
+	bool m_hasKeyFrame = false;
+	std::vector<uint8> m_keyFrameRam;
+
+	bool m_blockActive = false;
+	uint64 m_blockHeaderPosition = 0;
+	FrameDumpStream::BLOCK_HEADER m_blockHeader;
+	std::unique_ptr<z_stream_s> m_deflateStream;
+	std::vector<uint8> m_deflateBuffer;
+	std::vector<uint8> m_recordBuffer;
+};
+
+class CFrameDumpStreamReader
+{
+public:
+	CFrameDumpStreamReader(Framework::CStream&);
+	virtual ~CFrameDumpStreamReader() = default;
+
+	uint32 GetFrameCount() const;
+
+	//Fills the frame dump with the state at the closest keyframe preceding the frame and
+	//the packets from that keyframe up to the end of the frame. Returns the number of
+	//packets that come before the requested frame's own packets.
+	uint32 ReadFrame(uint32 frameIndex, CFrameDump&);
+
+private:
+	struct BLOCK
+	{
+		FrameDumpStream::BLOCK_HEADER header;
+		uint64 dataPosition = 0;
+	};
+
+	void ScanBlocks();
+	std::vector<uint8> ReadBlockData(const BLOCK&);
+	void ApplyKeyFrame(const BLOCK&, CFrameDump&);
+
+	Framework::CStream& m_stream;
+	std::vector<BLOCK> m_keyFrameBlocks;
+	std::vector<BLOCK> m_packetBlocks;
+	uint32 m_frameCount = 0;
+};
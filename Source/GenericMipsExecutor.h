@@ -3,6 +3,7 @@
 #include <unordered_set>
 #include "MIPS.h"
 #include "BasicBlock.h"
+#include "SharedBlockCache.h"
 
 #include "BlockLookupOneWay.h"
 #include "BlockLookupTwoWay.h"
@@ -86,6 +87,11 @@ public:
 		return m_blockLookup.FindBlockAt(address);
 	}
 
+	void SetSharedBlockCache(CSharedBlockCache* sharedBlockCache) override
+	{
+		m_sharedBlockCache = sharedBlockCache;
+	}
+
 	void Reset() override
 	{
 		m_blockLookup.Clear();
@@ -127,6 +133,15 @@ public:
 protected:
 	typedef std::unordered_set<BasicBlockPtr> BlockStore;
 
+	enum SHARED_BLOCK_FLAG : uint32
+	{
+		SHARED_BLOCK_FLAG_CLAMPING_MODE_MASK = 0xFF,
+		SHARED_BLOCK_FLAG_PAGE_LOOKUP = 0x100,
+		SHARED_BLOCK_FLAG_TLB_CHECK = 0x200,
+		//Free for executors to describe state specific to their blocks
+		SHARED_BLOCK_FLAG_EXECUTOR = 0x10000,
+	};
+
 	bool HasBlockAt(uint32 address) const
 	{
 		auto block = m_blockLookup.FindBlockAt(address);
@@ -157,10 +172,41 @@ protected:
 		return result;
 	}
 
+	//Uses the code compiled by another executor for a block with the same contents if there's one,
+	//otherwise compiles the block and makes its code available to others.
+	//Blocks containing breakpoints must not go through here since their code depends on the debugger.
+	void CompileSharedBlock(CBasicBlock* block, const uint128& hash, uint32 size, uint32 executorFlags)
+	{
+#if !defined(AOT_BUILD_CACHE) && !defined(AOT_USE_CACHE)
+		if(m_sharedBlockCache)
+		{
+			CSharedBlockCache::KEY key;
+			key.category = m_blockCategory;
+			key.maxAddress = m_maxAddress;
+			key.hash = hash;
+			key.size = size;
+			key.flags = executorFlags | m_context.m_clampingMode;
+			if(m_context.m_pageLookup) key.flags |= SHARED_BLOCK_FLAG_PAGE_LOOKUP;
+			if(m_context.m_TLBExceptionChecker) key.flags |= SHARED_BLOCK_FLAG_TLB_CHECK;
+
+			if(auto codeTemplate = m_sharedBlockCache->Find(key))
+			{
+				block->CopyFunctionFrom(codeTemplate);
+				return;
+			}
+			block->Compile();
+			m_sharedBlockCache->Publish(key, block->GetCodeTemplate());
+			return;
+		}
+#endif
+		block->Compile();
+	}
+
 	void SetupBlockLinks(uint32 startAddress, uint32 endAddress, uint32 branchAddress)
 	{
 		auto block = m_blockLookup.FindBlockAt(startAddress);
 
+		if(block->HasLinkSlot(LINK_SLOT_NEXT))
 		{
 			uint32 nextBlockAddress = (endAddress + 4) & m_addressMask;
 			const auto linkSlot = LINK_SLOT_NEXT;
@@ -324,6 +370,7 @@ protected:
 	uint32 m_maxAddress = 0;
 	uint32 m_addressMask = 0;
 	BLOCK_CATEGORY m_blockCategory = BLOCK_CATEGORY_UNKNOWN;
+	CSharedBlockCache* m_sharedBlockCache = nullptr;
 
 	BlockLookupType m_blockLookup;
 
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cassert>
+#include "string_format.h"
+#include "GuestProfiler.h"
+#include "MIPS.h"
+
+void CGuestProfiler::SetContext(CONTEXT context, const char* name, CMIPS* ctx)
+{
+	assert(context < CONTEXT_COUNT);
+	auto& contextInfo = m_contexts[context];
+	contextInfo.name = name;
+	contextInfo.ctx = ctx;
+}
+
+void CGuestProfiler::SetSymbols(CONTEXT context, SymbolMap symbols)
+{
+	assert(context < CONTEXT_COUNT);
+	m_contexts[context].symbols = std::move(symbols);
+}
+
+void CGuestProfiler::Start(uint32 samplingInterval)
+{
+	Clear();
+	m_samplingInterval = std::max<uint32>(samplingInterval, 1);
+	m_samplingCounter = m_samplingInterval;
+	m_active = true;
+}
+
+void CGuestProfiler::Stop()
+{
+	m_active = false;
+}
+
+void CGuestProfiler::Clear()
+{
+	for(auto& contextInfo : m_contexts)
+	{
+		contextInfo.callStacks.clear();
+		contextInfo.idleCount = 0;
+	}
+}
+
+void CGuestProfiler::SampleCallStack(CONTEXT context, bool idle)
+{
+	assert(context < CONTEXT_COUNT);
+	auto& contextInfo = m_contexts[context];
+	if(idle)
+	{
+		contextInfo.idleCount++;
+		return;
+	}
+
+	auto ctx = contextInfo.ctx;
+	assert(ctx);
+	auto callStackItems = CMIPSAnalysis::GetCallStack(ctx, ctx->m_State.nPC,
+	                                                  ctx->m_State.nGPR[CMIPS::SP].nV0, ctx->m_State.nGPR[CMIPS::RA].nV0, MAX_STACK_DEPTH);
+	if(callStackItems.empty())
+	{
+		callStackItems.push_back(ctx->m_State.nPC);
+	}
+
+	//Call stacks are given from the innermost function, reports start from the outermost one
+	m_sampleCallStack.clear();
+	for(auto itemIterator = callStackItems.rbegin(); itemIterator != callStackItems.rend(); itemIterator++)
+	{
+		m_sampleCallStack.push_back(GetFunctionAddress(contextInfo, *itemIterator));
+	}
+	contextInfo.callStacks[m_sampleCallStack]++;
+}
+
+void CGuestProfiler::SampleAddress(CONTEXT context)
+{
+	assert(context < CONTEXT_COUNT);
+	auto& contextInfo = m_contexts[context];
+	auto ctx = contextInfo.ctx;
+	assert(ctx);
+
+	m_sampleCallStack.clear();
+	m_sampleCallStack.push_back(GetFunctionAddress(contextInfo, ctx->m_State.nPC));
+	contextInfo.callStacks[m_sampleCallStack]++;
+}
+
+uint64 CGuestProfiler::GetSampleCount() const
+{
+	uint64 sampleCount = 0;
+	for(const auto& contextInfo : m_contexts)
+	{
+		sampleCount += contextInfo.idleCount;
+		for(const auto& callStackPair : contextInfo.callStacks)
+		{
+			sampleCount += callStackPair.second;
+		}
+	}
+	return sampleCount;
+}
+
+void CGuestProfiler::WriteFoldedStacks(Framework::CStream& stream) const
+{
+	auto writeLine = [&stream](const std::string& line) {
+		stream.Write(line.data(), line.size());
+	};
+
+	for(const auto& contextInfo : m_contexts)
+	{
+		if(contextInfo.idleCount != 0)
+		{
+			writeLine(string_format("%s;[idle] %llu\n", contextInfo.name.c_str(), static_cast<unsigned long long>(contextInfo.idleCount)));
+		}
+		for(const auto& callStackPair : contextInfo.callStacks)
+		{
+			std::string line = contextInfo.name;
+			for(uint32 address : callStackPair.first)
+			{
+				line += ';';
+				line += GetFunctionName(contextInfo, address);
+			}
+			line += string_format(" %llu\n", static_cast<unsigned long long>(callStackPair.second));
+			writeLine(line);
+		}
+	}
+}
+
+uint32 CGuestProfiler::GetFunctionAddress(const CONTEXT_INFO& contextInfo, uint32 address) const
+{
+	if(contextInfo.ctx->m_analysis)
+	{
+		if(auto subroutine = contextInfo.ctx->m_analysis->FindSubroutine(address))
+		{
+			return subroutine->start;
+		}
+	}
+
+	auto symbolIterator = contextInfo.symbols.upper_bound(address);
+	if(symbolIterator != std::begin(contextInfo.symbols))
+	{
+		symbolIterator--;
+		if(address < symbolIterator->second.end)
+		{
+			return symbolIterator->first;
+		}
+	}
+
+	return address;
+}
+
+std::string CGuestProfiler::GetFunctionName(const CONTEXT_INFO& contextInfo, uint32 address) const
+{
+	if(auto tag = contextInfo.ctx->m_Functions.Find(address))
+	{
+		return tag;
+	}
+
+	auto symbolIterator = contextInfo.symbols.find(address);
+	if(symbolIterator != std::end(contextInfo.symbols))
+	{
+		return symbolIterator->second.name;
+	}
+
+	return string_format("sub_%08X", address);
+}
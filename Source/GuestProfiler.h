@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <string>
+#include <vector>
+#include "Types.h"
+#include "Stream.h"
+
+class CMIPS;
+
+//Samples the guest code running on each processor and keeps how many times every call stack was seen.
+//Reports are written as folded stacks ("EE;main;func 123"), which flamegraph tools can use directly.
+class CGuestProfiler
+{
+public:
+	enum CONTEXT
+	{
+		CONTEXT_EE,
+		CONTEXT_IOP,
+		CONTEXT_VU0,
+		CONTEXT_VU1,
+		CONTEXT_COUNT,
+	};
+
+	enum
+	{
+		DEFAULT_SAMPLING_INTERVAL = 64,
+		MAX_STACK_DEPTH = 32,
+	};
+
+	struct FUNCTION_SYMBOL
+	{
+		uint32 end = 0;
+		std::string name;
+	};
+
+	//Maps function start addresses to symbols, used when no tag is available for a function
+	typedef std::map<uint32, FUNCTION_SYMBOL> SymbolMap;
+
+	void SetContext(CONTEXT, const char*, CMIPS*);
+	void SetSymbols(CONTEXT, SymbolMap);
+
+	void Start(uint32 = DEFAULT_SAMPLING_INTERVAL);
+	void Stop();
+	void Clear();
+
+	inline bool IsActive() const
+	{
+		return m_active;
+	}
+
+	//Called once per emulation cycle, tells if contexts need to be sampled on this cycle
+	inline bool IsSamplingDue()
+	{
+		if(!m_active) return false;
+		if(--m_samplingCounter != 0) return false;
+		m_samplingCounter = m_samplingInterval;
+		return true;
+	}
+
+	void SampleCallStack(CONTEXT, bool);
+	void SampleAddress(CONTEXT);
+
+	uint64 GetSampleCount() const;
+	void WriteFoldedStacks(Framework::CStream&) const;
+
+private:
+	typedef std::vector<uint32> CallStack;
+	typedef std::map<CallStack, uint64> CallStackCountMap;
+
+	struct CONTEXT_INFO
+	{
+		std::string name;
+		CMIPS* ctx = nullptr;
+		SymbolMap symbols;
+		CallStackCountMap callStacks;
+		uint64 idleCount = 0;
+	};
+
+	uint32 GetFunctionAddress(const CONTEXT_INFO&, uint32) const;
+	std::string GetFunctionName(const CONTEXT_INFO&, uint32) const;
+
+	std::array<CONTEXT_INFO, CONTEXT_COUNT> m_contexts;
+	bool m_active = false;
+	uint32 m_samplingInterval = DEFAULT_SAMPLING_INTERVAL;
+	uint32 m_samplingCounter = DEFAULT_SAMPLING_INTERVAL;
+	CallStack m_sampleCallStack;
+};
@@ -2,8 +2,10 @@
 
 #include <memory>
 #include <cassert>
+#include <cstring>
 #include "Types.h"
 #include "Stream.h"
+#include "discimages/MappedImageStream.h"
 
 namespace ISO9660
 {
@@ -20,6 +22,12 @@ namespace ISO9660
 		virtual void ReadRawBlock(uint32, void*) = 0;
 		virtual uint32 GetBlockCount() = 0;
 		virtual uint32 GetRawBlockSize() const = 0;
+
+		//Returns a pointer to the block's data if it can be accessed directly, nullptr otherwise
+		virtual const uint8* GetBlockData(uint32)
+		{
+			return nullptr;
+		}
 	};
 
 	class CBlockProvider2048 : public CBlockProvider
@@ -29,12 +37,18 @@ namespace ISO9660
 
 		CBlockProvider2048(const StreamPtr& stream, uint32 offset = 0)
 		    : m_stream(stream)
+		    , m_mappedStream(dynamic_cast<CMappedImageStream*>(stream.get()))
 		    , m_offset(offset)
 		{
 		}
 
 		void ReadBlock(uint32 address, void* block) override
 		{
+			if(auto blockData = GetBlockData(address))
+			{
+				memcpy(block, blockData, BLOCKSIZE);
+				return;
+			}
 			m_stream->Seek(static_cast<uint64>(address + m_offset) * BLOCKSIZE, Framework::STREAM_SEEK_SET);
 			m_stream->Read(block, BLOCKSIZE);
 		}
@@ -56,8 +70,15 @@ namespace ISO9660
 			return BLOCKSIZE;
 		}
 
+		const uint8* GetBlockData(uint32 address) override
+		{
+			if(!m_mappedStream) return nullptr;
+			return m_mappedStream->GetData(static_cast<uint64>(address + m_offset) * BLOCKSIZE, BLOCKSIZE);
+		}
+
 	private:
 		StreamPtr m_stream;
+		CMappedImageStream* m_mappedStream = nullptr;
 		uint32 m_offset = 0;
 	};
 
@@ -69,11 +90,17 @@ namespace ISO9660
 
 		CBlockProviderCustom(const StreamPtr& stream)
 		    : m_stream(stream)
+		    , m_mappedStream(dynamic_cast<CMappedImageStream*>(stream.get()))
 		{
 		}
 
 		void ReadBlock(uint32 address, void* block) override
 		{
+			if(auto blockData = GetBlockData(address))
+			{
+				memcpy(block, blockData, BLOCKSIZE);
+				return;
+			}
 			m_stream->Seek((static_cast<uint64>(address) * INTERNAL_BLOCKSIZE) + BLOCKHEADER_SIZE, Framework::STREAM_SEEK_SET);
 			m_stream->Read(block, BLOCKSIZE);
 		}
@@ -96,8 +123,15 @@ namespace ISO9660
 			return INTERNAL_BLOCKSIZE;
 		}
 
+		const uint8* GetBlockData(uint32 address) override
+		{
+			if(!m_mappedStream) return nullptr;
+			return m_mappedStream->GetData((static_cast<uint64>(address) * INTERNAL_BLOCKSIZE) + BLOCKHEADER_SIZE, BLOCKSIZE);
+		}
+
 	private:
 		StreamPtr m_stream;
+		CMappedImageStream* m_mappedStream = nullptr;
 	};
 
 	typedef CBlockProviderCustom<0x930ULL, 0x18ULL> CBlockProviderCDROMXA;
@@ -21,6 +21,13 @@ CISO9660::~CISO9660()
 
 void CISO9660::ReadBlock(uint32 address, void* data)
 {
+	//Blocks of mapped images can be copied straight to their destination
+	if(auto blockData = m_blockProvider->GetBlockData(address))
+	{
+		memcpy(data, blockData, CBlockProvider::BLOCKSIZE);
+		return;
+	}
+
 	//The buffer is needed to make sure exception handlers
 	//are properly called as some system calls (ie.: ReadFile)
 	//won't generate an exception when trying to write to
@@ -261,12 +261,25 @@ void CMA_MIPSIV::CompileInstruction(uint32 address, CMipsJitter* codeGen, CMIPS*
 	m_nSA = (uint8)((m_nOpcode >> 6) & 0x1F);
 	m_nImmediate = (uint16)(m_nOpcode & 0xFFFF);
 
+	uint32 instrIndex = instrPosition / 4;
+	m_compileHints = (instrIndex < m_blockCompileHints.size()) ? m_blockCompileHints[instrIndex] : 0;
+
 	if(m_nOpcode)
 	{
 		m_pOpGeneral[(m_nOpcode >> 26)]();
 	}
 }
 
+void CMA_MIPSIV::SetBlockCompileHints(std::vector<uint32> blockCompileHints)
+{
+	m_blockCompileHints = std::move(blockCompileHints);
+}
+
+bool CMA_MIPSIV::MustWriteUpperHalf() const
+{
+	return (m_regSize == MIPS_REGSIZE_64) && ((m_compileHints & COMPILEHINT_SKIPUPPERHALF) == 0);
+}
+
 void CMA_MIPSIV::SPECIAL()
 {
 	m_pOpSpecial[m_nImmediate & 0x3F]();
@@ -354,7 +367,7 @@ void CMA_MIPSIV::ADDI()
 	m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nRS].nV[0]));
 	m_codeGen->PushCst(static_cast<int16>(m_nImmediate));
 	m_codeGen->Add();
-	if(m_regSize == MIPS_REGSIZE_64)
+	if(MustWriteUpperHalf())
 	{
 		m_codeGen->PushTop();
 		m_codeGen->SignExt();
@@ -385,7 +398,7 @@ void CMA_MIPSIV::ADDIU()
 		m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nRS].nV[0]));
 		m_codeGen->PushCst(static_cast<int16>(m_nImmediate));
 		m_codeGen->Add();
-		if(m_regSize == MIPS_REGSIZE_64)
+		if(MustWriteUpperHalf())
 		{
 			m_codeGen->PushTop();
 			m_codeGen->SignExt();
@@ -418,7 +431,7 @@ void CMA_MIPSIV::ANDI()
 	m_codeGen->And();
 	m_codeGen->PullRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[0]));
 
-	if(m_regSize == MIPS_REGSIZE_64)
+	if(MustWriteUpperHalf())
 	{
 		m_codeGen->PushCst(0);
 		m_codeGen->PullRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[1]));
@@ -466,7 +479,7 @@ void CMA_MIPSIV::LUI()
 	if(m_nRT == 0) return;
 
 	m_codeGen->PushCst(m_nImmediate << 16);
-	if(m_regSize == MIPS_REGSIZE_64)
+	if(MustWriteUpperHalf())
 	{
 		m_codeGen->PushCst((m_nImmediate & 0x8000) ? 0xFFFFFFFF : 0x00000000);
 		m_codeGen->PullRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[1]));
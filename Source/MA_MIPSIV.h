@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <vector>
 #include "MIPSArchitecture.h"
 #include "MIPSReflection.h"
 
@@ -15,6 +16,14 @@ public:
 	MIPS_BRANCH_TYPE IsInstructionBranch(CMIPS*, uint32, uint32) override;
 	uint32 GetInstructionEffectiveAddress(CMIPS*, uint32, uint32) override;
 
+	enum COMPILEHINT
+	{
+		//Sign extended upper half of the 32-bit result is overwritten before being read
+		COMPILEHINT_SKIPUPPERHALF = 0x01,
+	};
+
+	void SetBlockCompileHints(std::vector<uint32>);
+
 protected:
 	enum
 	{
@@ -70,6 +79,9 @@ protected:
 	uint8 m_nSA;
 	uint16 m_nImmediate;
 
+	uint32 m_compileHints = 0;
+	std::vector<uint32> m_blockCompileHints;
+
 protected:
 	struct MemoryAccessTraits
 	{
@@ -104,6 +116,7 @@ protected:
 	typedef std::function<void()> TemplateOperationFunctionType;
 
 	bool Ensure64BitRegs();
+	bool MustWriteUpperHalf() const;
 
 	void Template_Add32(bool);
 	void Template_Add64(bool);
@@ -12,7 +12,7 @@ void CMA_MIPSIV::Template_Add32(bool isSigned)
 
 	m_codeGen->Add();
 
-	if(m_regSize == MIPS_REGSIZE_64)
+	if(MustWriteUpperHalf())
 	{
 		m_codeGen->PushTop();
 		m_codeGen->SignExt();
@@ -42,7 +42,7 @@ void CMA_MIPSIV::Template_Sub32(bool isSigned)
 
 	m_codeGen->Sub();
 
-	if(m_regSize == MIPS_REGSIZE_64)
+	if(MustWriteUpperHalf())
 	{
 		m_codeGen->PushTop();
 		m_codeGen->SignExt();
@@ -78,7 +78,7 @@ void CMA_MIPSIV::Template_Load32Idx(const MemoryAccessIdxTraits& traits)
 		    }
 
 		    //Sign extend to whole 64-bits
-		    if(m_regSize == MIPS_REGSIZE_64)
+		    if(MustWriteUpperHalf())
 		    {
 			    if(traits.upper64BitSignExtend)
 			    {
@@ -175,7 +175,7 @@ void CMA_MIPSIV::Template_ShiftCst32(const TemplateParamedOperationFunctionType&
 	m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nRT].nV[0]));
 	Function(m_nSA);
 
-	if(m_regSize == MIPS_REGSIZE_64)
+	if(MustWriteUpperHalf())
 	{
 		m_codeGen->PushTop();
 		m_codeGen->SignExt();
@@ -193,7 +193,7 @@ void CMA_MIPSIV::Template_ShiftVar32(const TemplateOperationFunctionType& functi
 	m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nRS].nV[0]));
 	function();
 
-	if(m_regSize == MIPS_REGSIZE_64)
+	if(MustWriteUpperHalf())
 	{
 		m_codeGen->PushTop();
 		m_codeGen->SignExt();
@@ -8,6 +8,7 @@
 #include "MIPSAnalysis.h"
 #include "MIPSTags.h"
 #include "uint128.h"
+#include "FpUtils.h"
 #include <set>
 
 struct REGISTER_PIPELINE
@@ -187,6 +188,9 @@ public:
 	AddressTranslator m_pAddrTranslator = nullptr;
 	TLBExceptionChecker m_TLBExceptionChecker = nullptr;
 
+	//Float clamping used when compiling code for this CPU
+	FpUtils::CLAMPING_MODE m_clampingMode = FpUtils::CLAMPING_MODE_FULL;
+
 	enum REGISTER
 	{
 		R0 = 0,
@@ -502,7 +502,7 @@ static bool IsValidProgramAddress(uint32 address)
 	return (address != 0) && ((address & 0x03) == 0);
 }
 
-CMIPSAnalysis::CallStackItemArray CMIPSAnalysis::GetCallStack(CMIPS* context, uint32 pc, uint32 sp, uint32 ra)
+CMIPSAnalysis::CallStackItemArray CMIPSAnalysis::GetCallStack(CMIPS* context, uint32 pc, uint32 sp, uint32 ra, uint32 maxDepth)
 {
 	uint32 physicalSp = context->m_pAddrTranslator(context, sp);
 
@@ -551,6 +551,7 @@ CMIPSAnalysis::CallStackItemArray CMIPSAnalysis::GetCallStack(CMIPS* context, ui
 	{
 		//Add the current function
 		result.push_back(pc);
+		if(result.size() >= maxDepth) break;
 
 		//Go to previous routine
 		pc = ra;
@@ -32,7 +32,7 @@ public:
 	void ChangeSubroutineStart(uint32, uint32);
 	void ChangeSubroutineEnd(uint32, uint32);
 
-	static CallStackItemArray GetCallStack(CMIPS*, uint32 pc, uint32 sp, uint32 ra);
+	static CallStackItemArray GetCallStack(CMIPS*, uint32 pc, uint32 sp, uint32 ra, uint32 maxDepth = -1);
 	static bool TryGetStringAtAddress(CMIPS*, uint32, std::string&);
 	static bool TryGetSJISLatinStringAtAddress(CMIPS*, uint32, std::string&);
 
@@ -2,6 +2,8 @@
 
 #include "Types.h"
 
+class CSharedBlockCache;
+
 class CMipsExecutor
 {
 public:
@@ -10,6 +12,9 @@ public:
 	virtual int Execute(int) = 0;
 	virtual void ClearActiveBlocksInRange(uint32 start, uint32 end, bool executing) = 0;
 
+	//nullptr disables sharing compiled code with other executors
+	virtual void SetSharedBlockCache(CSharedBlockCache*) = 0;
+
 #ifdef DEBUGGER_INCLUDED
 	virtual bool MustBreak() const = 0;
 	virtual void DisableBreakpointsOnce() = 0;
@@ -95,6 +95,48 @@ void CMipsJitter::MarkLastBlockLabel()
 	}
 }
 
+FpUtils::CLAMPING_MODE CMipsJitter::GetClampingMode() const
+{
+	return m_clampingMode;
+}
+
+void CMipsJitter::SetClampingMode(FpUtils::CLAMPING_MODE clampingMode)
+{
+	m_clampingMode = clampingMode;
+}
+
+void CMipsJitter::MD_ClampOperandS()
+{
+	if(m_clampingMode == FpUtils::CLAMPING_MODE_FULL)
+	{
+		MD_ClampS();
+	}
+}
+
+void CMipsJitter::MD_ClampResultS()
+{
+	if(m_clampingMode == FpUtils::CLAMPING_MODE_RESULT)
+	{
+		MD_ClampS();
+	}
+}
+
+void CMipsJitter::FP_ClampOperandS()
+{
+	if(m_clampingMode == FpUtils::CLAMPING_MODE_FULL)
+	{
+		FP_ClampS();
+	}
+}
+
+void CMipsJitter::FP_ClampResultS()
+{
+	if(m_clampingMode == FpUtils::CLAMPING_MODE_RESULT)
+	{
+		FP_ClampS();
+	}
+}
+
 void CMipsJitter::SetVariableAsConstant(size_t variableId, uint32 value)
 {
 	VARIABLESTATUS status;
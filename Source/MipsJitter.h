@@ -2,6 +2,7 @@
 
 #include <map>
 #include "Jitter.h"
+#include "FpUtils.h"
 
 class CMipsJitter : public Jitter::CJitter
 {
@@ -15,6 +16,15 @@ public:
 
 	void SetVariableAsConstant(size_t, uint32);
 
+	FpUtils::CLAMPING_MODE GetClampingMode() const;
+	void SetClampingMode(FpUtils::CLAMPING_MODE);
+
+	//Clamp values on top of the stack according to the clamping mode
+	void MD_ClampOperandS();
+	void MD_ClampResultS();
+	void FP_ClampOperandS();
+	void FP_ClampResultS();
+
 	LABEL GetFirstBlockLabel();
 	LABEL GetLastBlockLabel();
 
@@ -36,4 +46,5 @@ private:
 	VariableStatusMap m_variableStatus;
 	LABEL m_firstBlockLabel = -1;
 	LABEL m_lastBlockLabel = -1;
+	FpUtils::CLAMPING_MODE m_clampingMode = FpUtils::CLAMPING_MODE_FULL;
 };
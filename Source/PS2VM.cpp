@@ -1,4 +1,5 @@
 #include <cstdio>
+#include <chrono>
 #include <exception>
 #include <memory>
 #include <climits>
@@ -10,11 +11,14 @@
 #include "PS2VM_Preferences.h"
 #include "ee/PS2OS.h"
 #include "ee/EeExecutor.h"
+#include "SharedBlockCache.h"
 #include "Ps2Const.h"
 #include "iop/Iop_SifManPs2.h"
 #include "iop/UsbBuzzerDevice.h"
 #include "StdStream.h"
 #include "StdStreamUtils.h"
+#include "MemStream.h"
+#include "PtrStream.h"
 #include "states/MemoryStateFile.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
@@ -37,6 +41,7 @@
 #define LOG_NAME ("ps2vm")
 
 #define THREAD_NAME ("PS2VM Thread")
+#define STATE_WRITER_THREAD_NAME ("PS2VM State Writer Thread")
 
 #define STATE_VM_TIMING_XML ("vm_timing.xml")
 #define STATE_VM_TIMING_VBLANK_TICKS ("vblankTicks")
@@ -92,11 +97,18 @@ CPS2VM::CPS2VM()
 	Framework::PathUtils::EnsurePathExists(GetStateDirectoryPath());
 
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE, true);
-	ReloadFrameRateLimit();
+	ReloadFrameRateLimitImpl();
 
 	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_AUDIO_SPUBLOCKCOUNT, 100);
 	ReloadSpuBlockCountImpl();
 
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_SHARED_BLOCK_CACHE_ENABLED, false);
+
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_REWIND_ENABLED, false);
+	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_PS2_REWIND_INTERVAL, 10);
+	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_PS2_REWIND_MEMORY_BUDGET, 256);
+	ReloadRewindSettingsImpl();
+
 	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_ARCADE_IO_SERVER_ENABLED, false);
 	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_PS2_ARCADE_IO_SERVER_PORT, 9876);
 }
@@ -221,12 +233,20 @@ void CPS2VM::DestroySoundHandler()
 
 void CPS2VM::SetEeFrequencyScale(uint32 numerator, uint32 denominator)
 {
-	m_eeFreqScaleNumerator = numerator;
-	m_eeFreqScaleDenominator = denominator;
-	ReloadFrameRateLimit();
+	m_mailBox.SendCall(
+	    [this, numerator, denominator]() {
+		    m_eeFreqScaleNumerator = numerator;
+		    m_eeFreqScaleDenominator = denominator;
+		    ReloadFrameRateLimitImpl();
+	    });
 }
 
 void CPS2VM::ReloadFrameRateLimit()
+{
+	m_mailBox.SendCall([this]() { ReloadFrameRateLimitImpl(); });
+}
+
+void CPS2VM::ReloadFrameRateLimitImpl()
 {
 	uint32 hRefreshRate = PS2::GS_NTSC_HSYNC_FREQ;
 	uint32 vRefreshRate = 60;
@@ -235,7 +255,7 @@ void CPS2VM::ReloadFrameRateLimit()
 		hRefreshRate = m_ee->m_gs->GetCrtHSyncFrequency();
 		vRefreshRate = m_ee->m_gs->GetCrtFrameRate();
 	}
-	bool limitFrameRate = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE);
+	bool limitFrameRate = !m_turboMode && CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE);
 	m_frameLimiter.SetFrameRate(limitFrameRate ? vRefreshRate : 0);
 
 	//At 1x scale, IOP runs 8 times slower than EE
@@ -252,6 +272,31 @@ void CPS2VM::ReloadFrameRateLimit()
 	m_spuUpdateTicksTotal *= static_cast<int64>(SAMPLES_PER_UPDATE);
 }
 
+void CPS2VM::SetTurboMode(bool enabled, bool skipPresentation)
+{
+	m_mailBox.SendCall(
+	    [this, enabled, skipPresentation]() {
+		    m_turboMode = enabled;
+		    m_turboModeSkipPresentation = enabled && skipPresentation;
+		    ReloadFrameRateLimitImpl();
+		    if(m_ee->m_gs)
+		    {
+			    m_ee->m_gs->SetPresentationEnabled(!m_turboModeSkipPresentation);
+		    }
+	    },
+	    true);
+}
+
+bool CPS2VM::IsTurboModeEnabled() const
+{
+	return m_turboMode;
+}
+
+float CPS2VM::GetEmulatedFrameRate() const
+{
+	return m_emulatedFrameRate;
+}
+
 CVirtualMachine::STATUS CPS2VM::GetStatus() const
 {
 	return m_nStatus;
@@ -325,12 +370,18 @@ void CPS2VM::Initialize()
 	m_nEnd = false;
 	m_thread = std::thread([&]() { EmuThread(); });
 	Framework::ThreadUtils::SetThreadName(m_thread, THREAD_NAME);
+	m_stateWriterEnd = false;
+	m_stateWriterThread = std::thread([&]() { StateWriterThread(); });
+	Framework::ThreadUtils::SetThreadName(m_stateWriterThread, STATE_WRITER_THREAD_NAME);
 }
 
 void CPS2VM::Destroy()
 {
 	m_mailBox.SendCall(std::bind(&CPS2VM::DestroyImpl, this));
 	m_thread.join();
+	//Pending state writes are completed before the writer stops
+	m_stateWriterMailBox.SendCall([this]() { m_stateWriterEnd = true; });
+	m_stateWriterThread.join();
 	DestroyVM();
 }
 
@@ -351,8 +402,7 @@ std::future<bool> CPS2VM::SaveState(const fs::path& statePath)
 	auto future = promise->get_future();
 	m_mailBox.SendCall(
 	    [this, promise, statePath]() {
-		    auto result = SaveVMState(statePath);
-		    promise->set_value(result);
+		    SaveVMState(statePath, promise);
 	    });
 	return future;
 }
@@ -369,11 +419,84 @@ std::future<bool> CPS2VM::LoadState(const fs::path& statePath)
 	return future;
 }
 
+std::future<CPS2VM::StateSnapshotPtr> CPS2VM::CaptureStateSnapshot()
+{
+	auto promise = std::make_shared<std::promise<StateSnapshotPtr>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise]() {
+		    auto result = CaptureVMStateSnapshot();
+		    promise->set_value(result);
+	    });
+	return future;
+}
+
+std::future<bool> CPS2VM::RestoreStateSnapshot(StateSnapshotPtr snapshot)
+{
+	auto promise = std::make_shared<std::promise<bool>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise, snapshot]() {
+		    auto result = RestoreVMStateSnapshot(snapshot);
+		    promise->set_value(result);
+	    });
+	return future;
+}
+
+std::future<bool> CPS2VM::Rewind()
+{
+	auto promise = std::make_shared<std::promise<bool>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise]() {
+		    auto result = RewindImpl();
+		    promise->set_value(result);
+	    });
+	return future;
+}
+
+void CPS2VM::ReloadRewindSettings()
+{
+	m_mailBox.SendCall([this]() { ReloadRewindSettingsImpl(); });
+}
+
+CPS2VM::REWIND_INFO CPS2VM::GetRewindInfo() const
+{
+	return m_rewindInfo;
+}
+
 CPS2VM::CPU_UTILISATION_INFO CPS2VM::GetCpuUtilisationInfo() const
 {
 	return m_cpuUtilisation;
 }
 
+CPS2VM::EXECUTION_STATS CPS2VM::GetExecutionStats() const
+{
+	return m_executionStats;
+}
+
+void CPS2VM::StartGuestProfiling(uint32 samplingInterval)
+{
+	m_mailBox.SendCall([this, samplingInterval]() { StartGuestProfilingImpl(samplingInterval); });
+}
+
+void CPS2VM::StopGuestProfiling()
+{
+	m_mailBox.SendCall([this]() { m_guestProfiler.Stop(); });
+}
+
+std::future<bool> CPS2VM::SaveGuestProfile(const fs::path& profilePath)
+{
+	auto promise = std::make_shared<std::promise<bool>>();
+	auto future = promise->get_future();
+	m_mailBox.SendCall(
+	    [this, promise, profilePath]() {
+		    auto result = SaveGuestProfileImpl(profilePath);
+		    promise->set_value(result);
+	    });
+	return future;
+}
+
 #ifdef DEBUGGER_INCLUDED
 
 #define TAGS_SECTION_TAGS ("tags")
@@ -475,6 +598,12 @@ void CPS2VM::CreateVM()
 	m_ee = std::make_unique<Ee::CSubSystem>(m_iop->m_ram, *iopOs);
 	m_OnRequestLoadExecutableConnection = m_ee->m_os->OnRequestLoadExecutable.Connect(std::bind(&CPS2VM::ReloadExecutable, this, std::placeholders::_1, std::placeholders::_2));
 	m_OnCrtModeChangeConnection = m_ee->m_os->OnCrtModeChange.Connect(std::bind(&CPS2VM::OnCrtModeChange, this));
+	m_OnExecutableChangeConnection = m_ee->m_os->OnExecutableChange.Connect(std::bind(&CPS2VM::OnExecutableChange, this));
+
+	m_guestProfiler.SetContext(CGuestProfiler::CONTEXT_EE, "EE", &m_ee->m_EE);
+	m_guestProfiler.SetContext(CGuestProfiler::CONTEXT_IOP, "IOP", &m_iop->m_cpu);
+	m_guestProfiler.SetContext(CGuestProfiler::CONTEXT_VU0, "VU0", &m_ee->m_VU0);
+	m_guestProfiler.SetContext(CGuestProfiler::CONTEXT_VU1, "VU1", &m_ee->m_VU1);
 
 	ResetVM();
 }
@@ -490,6 +619,16 @@ void CPS2VM::ResetVM()
 	m_ee->Reset(m_eeRamSize);
 	m_iop->Reset();
 
+	{
+		//Lets other virtual machines of this process reuse the code compiled by this one (and vice versa)
+		bool sharedBlockCacheEnabled = CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_SHARED_BLOCK_CACHE_ENABLED);
+		auto sharedBlockCache = sharedBlockCacheEnabled ? &CSharedBlockCache::GetInstance() : nullptr;
+		m_ee->m_EE.m_executor->SetSharedBlockCache(sharedBlockCache);
+		m_ee->m_VU0.m_executor->SetSharedBlockCache(sharedBlockCache);
+		m_ee->m_VU1.m_executor->SetSharedBlockCache(sharedBlockCache);
+		m_iop->m_cpu.m_executor->SetSharedBlockCache(sharedBlockCache);
+	}
+
 	if(m_ee->m_gs != NULL)
 	{
 		m_ee->m_gs->Reset();
@@ -526,6 +665,8 @@ void CPS2VM::ResetVM()
 	m_eeExecutionTicks = 0;
 	m_iopExecutionTicks = 0;
 
+	m_executionStats = EXECUTION_STATS();
+
 	m_currentSpuBlock = 0;
 	m_iop->m_spuCore0.SetDestinationSamplingRate(DST_SAMPLE_RATE);
 	m_iop->m_spuCore1.SetDestinationSamplingRate(DST_SAMPLE_RATE);
@@ -533,31 +674,83 @@ void CPS2VM::ResetVM()
 	RegisterModulesInPadHandler();
 	m_gunListener = nullptr;
 	m_touchListener = nullptr;
+
+	m_rewindBuffer.Clear();
+	m_rewindInfo.maxCaptureTime = 0;
+	m_rewindFrameCount = 0;
+	m_rewindCapturePending = false;
+	UpdateRewindInfo();
 }
 
 void CPS2VM::DestroyVM()
 {
 	CDROM0_Reset();
+	m_stateSnapshotBase.reset();
+	m_rewindBuffer.Clear();
+	m_rewindInfo.maxCaptureTime = 0;
+	UpdateRewindInfo();
 }
 
-bool CPS2VM::SaveVMState(const fs::path& statePath)
+void CPS2VM::SaveVMState(const fs::path& statePath, const SaveStatePromisePtr& promise)
 {
 	if(m_ee->m_gs == NULL)
 	{
 		printf("PS2VM: GS Handler was not instancied. Cannot save state.\r\n");
-		return false;
+		promise->set_value(false);
+		return;
 	}
 
+	//Only copy the state here, compression and I/O are done by the state writer
+	StateSnapshotPtr snapshot;
+	auto regions = GetStateMemoryRegions();
 	try
 	{
-		auto stateStream = Framework::CreateOutputStdStream(statePath.native());
+		auto archiveData = SaveVMStateArchive();
+		snapshot = CStateSnapshot::CreateFull(std::move(archiveData), regions);
+	}
+	catch(...)
+	{
+		promise->set_value(false);
+		return;
+	}
+
+	m_stateWriterMailBox.SendCall(
+	    [promise, statePath, snapshot, regions]() {
+		    auto result = WriteStateSnapshot(statePath, snapshot, regions);
+		    promise->set_value(result);
+	    });
+}
+
+bool CPS2VM::WriteStateSnapshot(const fs::path& statePath, const StateSnapshotPtr& snapshot, const StateMemoryRegionList& regions)
+{
+	try
+	{
+		//Files of the snapshot's archive are moved to the state file along with the memory regions
+		const auto& archiveData = snapshot->GetArchiveData();
+		Framework::CPtrStream snapshotArchiveStream(archiveData.data(), archiveData.size());
+		Framework::CZipArchiveReader snapshotArchive(snapshotArchiveStream);
+
 		Framework::CZipArchiveWriter archive;
+		std::vector<std::vector<uint8>> fileContents;
+		for(const auto& fileHeaderPair : snapshotArchive.GetFileHeaders())
+		{
+			const auto& fileName = fileHeaderPair.first;
+			std::vector<uint8> contents(fileHeaderPair.second.uncompressedSize);
+			snapshotArchive.BeginReadFile(fileName.c_str())->Read(contents.data(), contents.size());
+			archive.InsertFile(std::make_unique<CMemoryStateFile>(fileName.c_str(), contents.data(), contents.size()));
+			fileContents.push_back(std::move(contents));
+		}
 
-		m_ee->SaveState(archive);
-		m_iop->SaveState(archive);
-		m_ee->m_gs->SaveState(archive);
-		SaveVmTimingState(archive);
+		std::vector<uint8> regionBuffer;
+		for(const auto& region : regions)
+		{
+			//Full snapshots give out their own copy, which stays valid until the archive is written
+			auto contents = snapshot->GetRegionContents(region, regionBuffer);
+			assert(snapshot->IsFull());
+			archive.InsertFile(std::make_unique<CMemoryStateFile>(region.name, contents, region.size));
+		}
 
+		auto stateStream = Framework::CreateOutputStdStream(statePath.native());
 		archive.Write(stateStream);
 	}
 	catch(...)
@@ -576,6 +769,9 @@ bool CPS2VM::LoadVMState(const fs::path& statePath)
 		return false;
 	}
 
+	//Make sure the state isn't still being written
+	m_stateWriterMailBox.FlushCalls();
+
 	try
 	{
 		auto stateStream = Framework::CreateInputStdStream(statePath.native());
@@ -588,7 +784,7 @@ bool CPS2VM::LoadVMState(const fs::path& statePath)
 			m_ee->m_gs->LoadState(archive);
 			LoadVmTimingState(archive);
 
-			ReloadFrameRateLimit();
+			ReloadFrameRateLimitImpl();
 		}
 		catch(...)
 		{
@@ -628,6 +824,271 @@ void CPS2VM::LoadVmTimingState(Framework::CZipArchiveReader& archive)
 	m_spuUpdateTicks = registerFile.GetRegister64(STATE_VM_TIMING_SPU_UPDATE_TICKS);
 }
 
+StateMemoryRegionList CPS2VM::GetStateMemoryRegions() const
+{
+	StateMemoryRegionList regions;
+	for(const auto& regionList : {m_ee->GetStateMemoryRegions(), m_iop->GetStateMemoryRegions(), m_ee->m_gs->GetStateMemoryRegions()})
+	{
+		regions.insert(std::end(regions), std::begin(regionList), std::end(regionList));
+	}
+	return regions;
+}
+
+std::vector<uint8> CPS2VM::SaveVMStateArchive()
+{
+	//Memory regions are kept out of the archive. This needs to be done before
+	//accessing the regions since it syncs GS memory.
+	Framework::CMemStream archiveStream;
+	{
+		Framework::CZipArchiveWriter archive;
+
+		m_ee->SaveState(archive, false);
+		m_iop->SaveState(archive, false);
+		m_ee->m_gs->SaveState(archive, false);
+		SaveVmTimingState(archive);
+
+		archive.Write(archiveStream);
+	}
+	return std::vector<uint8>(archiveStream.GetBuffer(), archiveStream.GetBuffer() + archiveStream.GetSize());
+}
+
+bool CPS2VM::LoadVMStateArchive(const std::vector<uint8>& archiveData, const StateMemoryRegionSource& regionSource)
+{
+	try
+	{
+		Framework::CPtrStream archiveStream(archiveData.data(), archiveData.size());
+		Framework::CZipArchiveReader archive(archiveStream);
+
+		try
+		{
+			m_ee->LoadState(archive, regionSource);
+			m_iop->LoadState(archive, regionSource);
+			m_ee->m_gs->LoadState(archive, regionSource);
+			LoadVmTimingState(archive);
+
+			ReloadFrameRateLimitImpl();
+		}
+		catch(...)
+		{
+			//Any error that occurs in the previous block is critical
+			PauseImpl();
+			throw;
+		}
+	}
+	catch(...)
+	{
+		return false;
+	}
+
+	OnMachineStateChange();
+
+	return true;
+}
+
+CPS2VM::StateSnapshotPtr CPS2VM::CaptureVMStateSnapshot()
+{
+	if(m_ee->m_gs == NULL)
+	{
+		printf("PS2VM: GS Handler was not instancied. Cannot capture state.\r\n");
+		return StateSnapshotPtr();
+	}
+
+	try
+	{
+		auto archiveData = SaveVMStateArchive();
+		auto regions = GetStateMemoryRegions();
+		if(m_stateSnapshotBase && m_stateSnapshotBase->IsCompatible(regions))
+		{
+			auto snapshot = CStateSnapshot::CreateDelta(archiveData, regions, m_stateSnapshotBase);
+			if(snapshot->GetDirtyPageCount() <= (snapshot->GetPageCount() / STATE_SNAPSHOT_REBASE_RATIO))
+			{
+				return snapshot;
+			}
+		}
+
+		m_stateSnapshotBase = CStateSnapshot::CreateFull(std::move(archiveData), regions);
+		return m_stateSnapshotBase;
+	}
+	catch(...)
+	{
+		return StateSnapshotPtr();
+	}
+}
+
+bool CPS2VM::RestoreVMStateSnapshot(const StateSnapshotPtr& snapshot)
+{
+	if(m_ee->m_gs == NULL)
+	{
+		printf("PS2VM: GS Handler was not instancied. Cannot restore state.\r\n");
+		return false;
+	}
+
+	if(!snapshot)
+	{
+		return false;
+	}
+
+	std::vector<uint8> regionBuffer;
+	return LoadVMStateArchive(snapshot->GetArchiveData(),
+	                          [&](const STATE_MEMORY_REGION& region) {
+		                          return snapshot->GetRegionContents(region, regionBuffer);
+	                          });
+}
+
+void CPS2VM::ReloadRewindSettingsImpl()
+{
+	ValidateThreadContext();
+	auto& config = CAppConfig::GetInstance();
+	m_rewindInfo.enabled = config.GetPreferenceBoolean(PREF_PS2_REWIND_ENABLED);
+	m_rewindInterval = std::max<int>(config.GetPreferenceInteger(PREF_PS2_REWIND_INTERVAL), 1);
+	m_rewindBuffer.SetMemoryBudget(static_cast<uint64>(std::max<int>(config.GetPreferenceInteger(PREF_PS2_REWIND_MEMORY_BUDGET), 0)) * 1024 * 1024);
+	if(!m_rewindInfo.enabled)
+	{
+		m_rewindBuffer.Clear();
+		m_rewindInfo.maxCaptureTime = 0;
+		m_rewindCapturePending = false;
+	}
+	UpdateRewindInfo();
+}
+
+void CPS2VM::CaptureRewindState()
+{
+	if(m_ee->m_gs == NULL) return;
+
+	auto captureStartTime = std::chrono::high_resolution_clock::now();
+	try
+	{
+		auto archiveData = SaveVMStateArchive();
+		m_rewindInfo.lastCaptureSize = m_rewindBuffer.Capture(std::move(archiveData), GetStateMemoryRegions());
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to capture rewind state: %s\r\n", exception.what());
+		m_rewindInfo.lastCaptureSize = 0;
+	}
+	auto captureDuration = std::chrono::high_resolution_clock::now() - captureStartTime;
+	m_rewindInfo.lastCaptureTime = static_cast<uint32>(std::chrono::duration_cast<std::chrono::microseconds>(captureDuration).count());
+	m_rewindInfo.maxCaptureTime = std::max(m_rewindInfo.maxCaptureTime, m_rewindInfo.lastCaptureTime);
+	UpdateRewindInfo();
+}
+
+bool CPS2VM::RewindImpl()
+{
+	if(m_ee->m_gs == NULL)
+	{
+		printf("PS2VM: GS Handler was not instancied. Cannot rewind.\r\n");
+		return false;
+	}
+
+	if(m_rewindBuffer.IsEmpty())
+	{
+		return false;
+	}
+
+	bool result = LoadVMStateArchive(m_rewindBuffer.GetArchiveData(),
+	                                 [this](const STATE_MEMORY_REGION& region) {
+		                                 return m_rewindBuffer.GetRegionContents(region);
+	                                 });
+	if(result)
+	{
+		try
+		{
+			m_rewindBuffer.StepBack();
+		}
+		catch(const std::exception& exception)
+		{
+			CLog::GetInstance().Warn(LOG_NAME, "Failed to step back in rewind buffer: %s\r\n", exception.what());
+		}
+	}
+
+	//Start counting frames from the restored state
+	m_rewindFrameCount = 0;
+	m_rewindCapturePending = false;
+	UpdateRewindInfo();
+
+	return result;
+}
+
+void CPS2VM::UpdateRewindInfo()
+{
+	m_rewindInfo.stateCount = m_rewindBuffer.GetStateCount();
+	m_rewindInfo.memoryUsage = m_rewindBuffer.GetMemoryUsage();
+	m_rewindInfo.memoryBudget = m_rewindBuffer.GetMemoryBudget();
+}
+
+void CPS2VM::StartGuestProfilingImpl(uint32 samplingInterval)
+{
+	LoadGuestProfilerSymbols();
+	m_guestProfiler.Start(samplingInterval);
+}
+
+void CPS2VM::LoadGuestProfilerSymbols()
+{
+	CGuestProfiler::SymbolMap symbols;
+	if(auto elf = m_ee->m_os->GetELF())
+	{
+		elf->EnumerateSymbols([&](const ELF::ELFSYMBOL32& symbol, uint8 type, uint8, const char* name) {
+			if((type != ELF::STT_FUNC) || (symbol.nValue == 0) || (name[0] == 0)) return;
+			CGuestProfiler::FUNCTION_SYMBOL functionSymbol;
+			functionSymbol.end = symbol.nValue + std::max<uint32>(symbol.nSize, 4);
+			functionSymbol.name = name;
+			symbols[symbol.nValue] = std::move(functionSymbol);
+		});
+
+		//Subroutines are only analysed when the executable is loaded in debugger builds
+		uint32 entryPoint = elf->GetHeader().nEntryPoint;
+		if(!m_ee->m_EE.m_analysis->FindSubroutine(entryPoint))
+		{
+			auto executableRange = m_ee->m_os->GetExecutableRange();
+			m_ee->m_EE.m_analysis->Analyse(executableRange.first, executableRange.second & ~0x03, entryPoint);
+		}
+	}
+	m_guestProfiler.SetSymbols(CGuestProfiler::CONTEXT_EE, std::move(symbols));
+}
+
+void CPS2VM::SampleGuestCode()
+{
+	m_guestProfiler.SampleCallStack(CGuestProfiler::CONTEXT_EE, m_ee->IsCpuIdle());
+	m_guestProfiler.SampleCallStack(CGuestProfiler::CONTEXT_IOP, m_iop->IsCpuIdle());
+
+	//Microprograms don't have call stacks, only sample them while they run
+	if(m_ee->m_vpu0->IsVuRunning())
+	{
+		m_guestProfiler.SampleAddress(CGuestProfiler::CONTEXT_VU0);
+	}
+	if(m_ee->m_vpu1->IsVuRunning())
+	{
+		m_guestProfiler.SampleAddress(CGuestProfiler::CONTEXT_VU1);
+	}
+}
+
+bool CPS2VM::SaveGuestProfileImpl(const fs::path& profilePath)
+{
+	try
+	{
+		auto stream = Framework::CreateOutputStdStream(profilePath.native());
+		m_guestProfiler.WriteFoldedStacks(stream);
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to save guest profile: %s\r\n", exception.what());
+		return false;
+	}
+	return true;
+}
+
+void CPS2VM::StateWriterThread()
+{
+	while(!m_stateWriterEnd)
+	{
+		m_stateWriterMailBox.WaitForCall();
+		while(m_stateWriterMailBox.IsPending())
+		{
+			m_stateWriterMailBox.ReceiveCall();
+		}
+	}
+}
+
 void CPS2VM::PauseImpl()
 {
 	m_nStatus = PAUSED;
@@ -640,6 +1101,8 @@ void CPS2VM::ResumeImpl()
 	m_iop->m_cpu.m_executor->DisableBreakpointsOnce();
 	m_ee->m_VU1.m_executor->DisableBreakpointsOnce();
 #endif
+	m_emulatedFrameCount = 0;
+	m_emulatedFrameRateTime = std::chrono::steady_clock::now();
 	m_nStatus = RUNNING;
 }
 
@@ -657,6 +1120,8 @@ void CPS2VM::CreateGsHandlerImpl(const CGSHandler::FactoryFunction& factoryFunct
 	m_ee->m_gs = factoryFunction();
 	m_ee->m_gs->SetIntc(&m_ee->m_intc);
 	m_ee->m_gs->Initialize();
+	m_ee->m_gs->SetExecutableName(m_ee->m_os->GetExecutableName());
+	m_ee->m_gs->SetPresentationEnabled(!m_turboModeSkipPresentation);
 	m_ee->m_gs->SendGSCall([this]() {
 		static_cast<CEeExecutor*>(m_ee->m_EE.m_executor.get())->AttachExceptionHandlerToThread();
 	});
@@ -723,9 +1188,14 @@ void CPS2VM::UpdateEe()
 		if(m_ee->IsCpuIdle())
 		{
 			m_cpuUtilisation.eeIdleTicks += (m_eeExecutionTicks - executed);
+			m_executionStats.eeIdleTicks += (m_eeExecutionTicks - executed);
 			executed = m_eeExecutionTicks;
 		}
 		m_cpuUtilisation.eeTotalTicks += executed;
+		m_executionStats.eeTotalTicks += executed;
+
+		if(m_ee->m_vpu0->IsVuRunning()) m_executionStats.vu0RunningTicks += executed;
+		if(m_ee->m_vpu1->IsVuRunning()) m_executionStats.vu1RunningTicks += executed;
 
 		m_ee->m_vpu0->Execute(m_singleStepVu0 ? 1 : executed);
 		m_ee->m_vpu1->Execute(m_singleStepVu1 ? 1 : executed);
@@ -755,9 +1225,11 @@ void CPS2VM::UpdateIop()
 		if(m_iop->IsCpuIdle())
 		{
 			m_cpuUtilisation.iopIdleTicks += (m_iopExecutionTicks - executed);
+			m_executionStats.iopIdleTicks += (m_iopExecutionTicks - executed);
 			executed = m_iopExecutionTicks;
 		}
 		m_cpuUtilisation.iopTotalTicks += executed;
+		m_executionStats.iopTotalTicks += executed;
 
 		m_iopExecutionTicks -= executed;
 		m_iop->CountTicks(executed);
@@ -797,7 +1269,8 @@ void CPS2VM::UpdateSpu()
 	m_currentSpuBlock++;
 	if(m_currentSpuBlock == m_spuBlockCount)
 	{
-		if(m_soundHandler)
+		//Samples are produced faster than they can be played in turbo mode, they are still rendered to keep SPU state coherent
+		if(m_soundHandler && !m_turboMode)
 		{
 			m_soundHandler->RecycleBuffers();
 			m_soundHandler->Write(m_samples, BLOCK_SIZE * m_spuBlockCount, DST_SAMPLE_RATE);
@@ -806,6 +1279,19 @@ void CPS2VM::UpdateSpu()
 	}
 }
 
+void CPS2VM::UpdateEmulatedFrameRate()
+{
+	m_emulatedFrameCount++;
+	auto currentTime = std::chrono::steady_clock::now();
+	auto elapsed = std::chrono::duration<float>(currentTime - m_emulatedFrameRateTime);
+	if(elapsed >= std::chrono::seconds(1))
+	{
+		m_emulatedFrameRate = static_cast<float>(m_emulatedFrameCount) / elapsed.count();
+		m_emulatedFrameCount = 0;
+		m_emulatedFrameRateTime = currentTime;
+	}
+}
+
 void CPS2VM::CDROM0_SyncPath()
 {
 	//TODO: Check if there's an m_cdrom0 already
@@ -883,7 +1369,19 @@ void CPS2VM::ReloadExecutable(const char* executablePath, const CPS2OS::Argument
 
 void CPS2VM::OnCrtModeChange()
 {
-	ReloadFrameRateLimit();
+	ReloadFrameRateLimitImpl();
+}
+
+void CPS2VM::OnExecutableChange()
+{
+	if(m_ee->m_gs)
+	{
+		m_ee->m_gs->SetExecutableName(m_ee->m_os->GetExecutableName());
+	}
+	if(m_guestProfiler.IsActive())
+	{
+		LoadGuestProfilerSymbols();
+	}
 }
 
 void CPS2VM::EmuThread()
@@ -914,6 +1412,12 @@ void CPS2VM::EmuThread()
 		}
 		if(m_nStatus == RUNNING)
 		{
+			if(m_rewindCapturePending)
+			{
+				m_rewindCapturePending = false;
+				CaptureRewindState();
+			}
+
 			if(m_spuUpdateTicks <= 0)
 			{
 				UpdateSpu();
@@ -957,10 +1461,19 @@ void CPS2VM::EmuThread()
 						CProfiler::GetInstance().CountCurrentZone();
 #endif
 						OnNewFrame();
+						UpdateEmulatedFrameRate();
+						m_executionStats.frameCount++;
 #ifdef PROFILE
 						CProfiler::GetInstance().Reset();
 #endif
 						m_cpuUtilisation = CPU_UTILISATION_INFO();
+
+						//Capture is done at the beginning of the next cycle, where states are normally saved
+						if(m_rewindInfo.enabled && (++m_rewindFrameCount >= m_rewindInterval))
+						{
+							m_rewindFrameCount = 0;
+							m_rewindCapturePending = true;
+						}
 					}
 					else
 					{
@@ -981,6 +1494,11 @@ void CPS2VM::EmuThread()
 
 				UpdateEe();
 				UpdateIop();
+
+				if(m_guestProfiler.IsSamplingDue())
+				{
+					SampleGuestCode();
+				}
 			}
 #ifdef DEBUGGER_INCLUDED
 			if(
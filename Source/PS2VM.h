@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 #include <future>
 #include "filesystem_def.h"
@@ -12,9 +14,12 @@
 #include "VirtualMachine.h"
 #include "ee/Ee_SubSystem.h"
 #include "iop/Iop_SubSystem.h"
+#include "states/StateSnapshot.h"
+#include "states/RewindBuffer.h"
 #include "../tools/PsfPlayer/Source/SoundHandler.h"
 #include "FrameLimiter.h"
 #include "Profiler.h"
+#include "GuestProfiler.h"
 
 class CPS2VM : public CVirtualMachine
 {
@@ -28,11 +33,41 @@ public:
 		int32 iopIdleTicks = 0;
 	};
 
+	//Accumulated since the last reset, unlike the utilisation info which is cleared every frame
+	struct EXECUTION_STATS
+	{
+		uint64 eeTotalTicks = 0;
+		uint64 eeIdleTicks = 0;
+
+		uint64 iopTotalTicks = 0;
+		uint64 iopIdleTicks = 0;
+
+		//EE ticks during which each VU was running a micro program
+		uint64 vu0RunningTicks = 0;
+		uint64 vu1RunningTicks = 0;
+
+		uint32 frameCount = 0;
+	};
+
+	struct REWIND_INFO
+	{
+		bool enabled = false;
+		uint32 stateCount = 0;
+		uint64 memoryUsage = 0;
+		uint64 memoryBudget = 0;
+
+		//Cost of the last capture
+		uint32 lastCaptureTime = 0; //In microseconds
+		uint64 lastCaptureSize = 0; //In bytes
+		uint32 maxCaptureTime = 0;  //In microseconds, since the rewind buffer was last cleared
+	};
+
 	typedef std::unique_ptr<COpticalMedia> OpticalMediaPtr;
 	typedef std::unique_ptr<Ee::CSubSystem> EeSubSystemPtr;
 	typedef std::unique_ptr<Iop::CSubSystem> IopSubSystemPtr;
 	typedef Framework::CSignal<void()> NewFrameEvent;
 	typedef std::function<void(CPS2VM*)> ExecutableReloadedHandler;
+	typedef CStateSnapshot::SnapshotPtr StateSnapshotPtr;
 
 	CPS2VM();
 	virtual ~CPS2VM() = default;
@@ -71,13 +106,38 @@ public:
 	void SetEeFrequencyScale(uint32, uint32);
 	void ReloadFrameRateLimit();
 
+	//Runs as fast as possible, without limiting the frame rate or pacing audio output.
+	//Presentation of frames can also be skipped, the GS still processes everything it receives.
+	void SetTurboMode(bool, bool = false);
+	bool IsTurboModeEnabled() const;
+
+	//Emulated frames per second of host time, updated every second
+	float GetEmulatedFrameRate() const;
+
 	static fs::path GetStateDirectoryPath();
 	fs::path GenerateStatePath(unsigned int) const;
 
 	std::future<bool> SaveState(const fs::path&);
 	std::future<bool> LoadState(const fs::path&);
 
+	//Captures the machine state in memory. Captures after the first one only keep the pages that
+	//changed since the last full capture, which is taken again when too much memory changed.
+	std::future<StateSnapshotPtr> CaptureStateSnapshot();
+	std::future<bool> RestoreStateSnapshot(StateSnapshotPtr);
+
+	//Goes back to the latest state kept for rewinding. Calling this again goes further back.
+	std::future<bool> Rewind();
+	void ReloadRewindSettings();
+	REWIND_INFO GetRewindInfo() const;
+
 	CPU_UTILISATION_INFO GetCpuUtilisationInfo() const;
+	//Only consistent while the virtual machine is paused
+	EXECUTION_STATS GetExecutionStats() const;
+
+	//Samples guest code every n emulation cycles, saved profiles are folded stacks for flamegraph tools
+	void StartGuestProfiling(uint32 = CGuestProfiler::DEFAULT_SAMPLING_INTERVAL);
+	void StopGuestProfiling();
+	std::future<bool> SaveGuestProfile(const fs::path&);
 
 #ifdef DEBUGGER_INCLUDED
 	fs::path MakeDebugTagsPackagePath(const char*);
@@ -116,14 +176,34 @@ private:
 
 	void ResetVM();
 	void DestroyVM();
-	bool SaveVMState(const fs::path&);
+	typedef std::shared_ptr<std::promise<bool>> SaveStatePromisePtr;
+
+	void SaveVMState(const fs::path&, const SaveStatePromisePtr&);
 	bool LoadVMState(const fs::path&);
+	static bool WriteStateSnapshot(const fs::path&, const StateSnapshotPtr&, const StateMemoryRegionList&);
 
 	void SaveVmTimingState(Framework::CZipArchiveWriter&);
 	void LoadVmTimingState(Framework::CZipArchiveReader&);
 
+	StateMemoryRegionList GetStateMemoryRegions() const;
+	std::vector<uint8> SaveVMStateArchive();
+	bool LoadVMStateArchive(const std::vector<uint8>&, const StateMemoryRegionSource&);
+	StateSnapshotPtr CaptureVMStateSnapshot();
+	bool RestoreVMStateSnapshot(const StateSnapshotPtr&);
+
+	void ReloadRewindSettingsImpl();
+	void CaptureRewindState();
+	bool RewindImpl();
+	void UpdateRewindInfo();
+
+	void StartGuestProfilingImpl(uint32);
+	void LoadGuestProfilerSymbols();
+	void SampleGuestCode();
+	bool SaveGuestProfileImpl(const fs::path&);
+
 	void ReloadExecutable(const char*, const CPS2OS::ArgumentList&);
 	void OnCrtModeChange();
+	void OnExecutableChange();
 
 	void PauseImpl();
 	void DestroyImpl();
@@ -138,16 +218,19 @@ private:
 	void DestroySoundHandlerImpl();
 
 	void ReloadSpuBlockCountImpl();
+	void ReloadFrameRateLimitImpl();
 
 	void UpdateEe();
 	void UpdateIop();
 	void UpdateSpu();
+	void UpdateEmulatedFrameRate();
 
 	void SetIopOpticalMedia(COpticalMedia*);
 
 	void RegisterModulesInPadHandler();
 
 	void EmuThread();
+	void StateWriterThread();
 
 	std::thread m_thread;
 	STATUS m_nStatus = PAUSED;
@@ -171,7 +254,34 @@ private:
 	int m_iopTickStep = 0;
 	CFrameLimiter m_frameLimiter;
 
+	bool m_turboMode = false;
+	bool m_turboModeSkipPresentation = false;
+
+	std::atomic<float> m_emulatedFrameRate = 0;
+	uint32 m_emulatedFrameCount = 0;
+	std::chrono::steady_clock::time_point m_emulatedFrameRateTime;
+
 	CPU_UTILISATION_INFO m_cpuUtilisation;
+	EXECUTION_STATS m_executionStats;
+
+	//A new full snapshot is captured when more than 1/n of the pages differ from the current one
+	enum
+	{
+		STATE_SNAPSHOT_REBASE_RATIO = 4,
+	};
+
+	StateSnapshotPtr m_stateSnapshotBase;
+
+	CRewindBuffer m_rewindBuffer;
+	REWIND_INFO m_rewindInfo;
+	uint32 m_rewindInterval = 1;
+	uint32 m_rewindFrameCount = 0;
+	bool m_rewindCapturePending = false;
+
+	//Compresses and writes save states while emulation goes on
+	std::thread m_stateWriterThread;
+	CMailBox m_stateWriterMailBox;
+	bool m_stateWriterEnd = false;
 
 	bool m_singleStepEe = false;
 	bool m_singleStepIop = false;
@@ -196,6 +306,8 @@ private:
 	CScreenPositionListener* m_gunListener = nullptr;
 	CScreenPositionListener* m_touchListener = nullptr;
 
+	CGuestProfiler m_guestProfiler;
+
 	CProfiler::ZoneHandle m_eeProfilerZone = 0;
 	CProfiler::ZoneHandle m_iopProfilerZone = 0;
 	CProfiler::ZoneHandle m_spuProfilerZone = 0;
@@ -204,4 +316,5 @@ private:
 
 	CPS2OS::RequestLoadExecutableEvent::Connection m_OnRequestLoadExecutableConnection;
 	Framework::CSignal<void()>::Connection m_OnCrtModeChangeConnection;
+	Framework::CSignal<void()>::Connection m_OnExecutableChangeConnection;
 };
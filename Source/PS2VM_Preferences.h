@@ -9,11 +9,21 @@
 #define PREF_PS2_HDD_DIRECTORY ("ps2.hdd.directory")
 #define PREF_PS2_ARCADEROMS_DIRECTORY ("ps2.arcaderoms.directory")
 
+#define PREF_PS2_MC_DIRECTORYINDEX_WATCH_ENABLED ("ps2.mc.directoryindex.watch.enabled")
+
 #define PREF_PS2_ARCADE_IO_SERVER_ENABLED ("ps2.arcade.ioserver.enabled")
 #define PREF_PS2_ARCADE_IO_SERVER_PORT ("ps2.arcade.ioserver.port")
 
 #define PREF_PS2_LIMIT_FRAMERATE ("ps2.limitframerate")
 
+#define PREF_PS2_EE_LIBCHLE_ENABLED ("ps2.ee.libchle.enabled")
+
+#define PREF_PS2_SHARED_BLOCK_CACHE_ENABLED ("ps2.sharedblockcache.enabled")
+
+#define PREF_PS2_REWIND_ENABLED ("ps2.rewind.enabled")
+#define PREF_PS2_REWIND_INTERVAL ("ps2.rewind.interval")
+#define PREF_PS2_REWIND_MEMORY_BUDGET ("ps2.rewind.memorybudget")
+
 #define PREF_AUDIO_SPUBLOCKCOUNT ("audio.spublockcount")
 
 #define PREF_SYSTEM_LANGUAGE ("system.language")
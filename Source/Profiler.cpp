@@ -1,5 +1,6 @@
 #include "Profiler.h"
 
+#include <algorithm>
 #include <cassert>
 
 CProfiler::CProfiler()
@@ -10,19 +11,25 @@ CProfiler::~CProfiler()
 {
 }
 
+std::mutex CProfiler::m_zoneNamesMutex;
+CProfiler::ZoneNameArray CProfiler::m_zoneNames;
+
+CProfiler& CProfiler::GetInstance()
+{
+	static thread_local CProfiler profiler;
+	return profiler;
+}
+
 CProfiler::ZoneHandle CProfiler::RegisterZone(const char* name)
 {
 #ifdef PROFILE
-	for(unsigned int i = 0; i < m_zones.size(); i++)
+	std::lock_guard<std::mutex> zoneNamesLock(m_zoneNamesMutex);
+	for(unsigned int i = 0; i < m_zoneNames.size(); i++)
 	{
-		const auto& zone(m_zones[i]);
-		if(zone.name == name) return i;
+		if(m_zoneNames[i] == name) return i;
 	}
-	auto newZone = ZONE();
-	newZone.name = name;
-	newZone.totalTime = 0;
-	m_zones.push_back(newZone);
-	return static_cast<CProfiler::ZoneHandle>(m_zones.size() - 1);
+	m_zoneNames.push_back(name);
+	return static_cast<CProfiler::ZoneHandle>(m_zoneNames.size() - 1);
 #else
 	return 0;
 #endif
@@ -71,16 +78,21 @@ void CProfiler::ExitZone()
 CProfiler::ZoneArray CProfiler::GetStats() const
 {
 	assert(std::this_thread::get_id() == m_workThreadId);
-	return m_zones;
+	std::lock_guard<std::mutex> zoneNamesLock(m_zoneNamesMutex);
+	ZoneArray zones(m_zoneNames.size());
+	for(unsigned int i = 0; i < zones.size(); i++)
+	{
+		auto& zone = zones[i];
+		zone.name = m_zoneNames[i];
+		zone.totalTime = (i < m_zoneTimes.size()) ? m_zoneTimes[i] : 0;
+	}
+	return zones;
 }
 
 void CProfiler::Reset()
 {
 	assert(std::this_thread::get_id() == m_workThreadId);
-	for(auto& zone : m_zones)
-	{
-		zone.totalTime = 0;
-	}
+	std::fill(std::begin(m_zoneTimes), std::end(m_zoneTimes), 0);
 }
 
 void CProfiler::SetWorkThread()
@@ -92,9 +104,11 @@ void CProfiler::SetWorkThread()
 
 void CProfiler::AddTimeToZone(ZoneHandle zoneHandle, uint64 timeNs)
 {
-	assert(m_zones.size() > zoneHandle);
-	auto& zone = m_zones[zoneHandle];
-	zone.totalTime += timeNs;
+	if(zoneHandle >= m_zoneTimes.size())
+	{
+		m_zoneTimes.resize(zoneHandle + 1);
+	}
+	m_zoneTimes[zoneHandle] += timeNs;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -3,12 +3,14 @@
 #include <string>
 #include <stack>
 #include <thread>
+#include <mutex>
 #include <vector>
 #include <chrono>
-#include "Singleton.h"
 #include "Types.h"
 
-class CProfiler : public CSingleton<CProfiler>
+//Zones are shared by all threads, but every thread has its own profiler instance
+//accumulating time, allowing many virtual machines to run at once.
+class CProfiler
 {
 public:
 	typedef uint32 ZoneHandle;
@@ -25,6 +27,8 @@ public:
 	CProfiler();
 	virtual ~CProfiler();
 
+	static CProfiler& GetInstance();
+
 	ZoneHandle RegisterZone(const char*);
 
 	void CountCurrentZone();
@@ -39,10 +43,14 @@ public:
 
 private:
 	typedef std::stack<ZoneHandle> ZoneStack;
+	typedef std::vector<std::string> ZoneNameArray;
 
 	void AddTimeToZone(ZoneHandle, uint64);
 
-	ZoneArray m_zones;
+	static std::mutex m_zoneNamesMutex;
+	static ZoneNameArray m_zoneNames;
+
+	std::vector<uint64> m_zoneTimes;
 	ZoneStack m_zoneStack;
 	TimePoint m_currentTime;
 
@@ -0,0 +1,49 @@
+#include <mutex>
+#include <tuple>
+#include "SharedBlockCache.h"
+
+bool CSharedBlockCache::KEY::operator<(const KEY& k2) const
+{
+	const auto& k1 = (*this);
+	return std::tie(k1.category, k1.maxAddress, k1.hash, k1.size, k1.flags) <
+	       std::tie(k2.category, k2.maxAddress, k2.hash, k2.size, k2.flags);
+}
+
+CBasicBlock::CodeTemplatePtr CSharedBlockCache::Find(const KEY& key)
+{
+	std::shared_lock<std::shared_mutex> lock(m_mutex);
+	auto templateIterator = m_templates.find(key);
+	if(templateIterator == std::end(m_templates)) return CBasicBlock::CodeTemplatePtr();
+	return templateIterator->second.lock();
+}
+
+void CSharedBlockCache::Publish(const KEY& key, CBasicBlock::CodeTemplatePtr codeTemplate)
+{
+	std::unique_lock<std::shared_mutex> lock(m_mutex);
+	//Another executor might have published the same code in the meantime, keep the live one
+	auto& entry = m_templates[key];
+	if(entry.expired())
+	{
+		entry = codeTemplate;
+	}
+	if(++m_publishCount == PRUNE_INTERVAL)
+	{
+		m_publishCount = 0;
+		PruneExpiredTemplates();
+	}
+}
+
+void CSharedBlockCache::PruneExpiredTemplates()
+{
+	for(auto templateIterator = std::begin(m_templates); templateIterator != std::end(m_templates);)
+	{
+		if(templateIterator->second.expired())
+		{
+			templateIterator = m_templates.erase(templateIterator);
+		}
+		else
+		{
+			templateIterator++;
+		}
+	}
+}
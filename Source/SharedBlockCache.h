@@ -0,0 +1,42 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include "Singleton.h"
+#include "BasicBlock.h"
+
+//Compiled code shared by the executors of every virtual machine running in the process.
+//Templates are only weakly referenced here: they are freed when the last block created from them goes away.
+class CSharedBlockCache : public CSingleton<CSharedBlockCache>
+{
+public:
+	struct KEY
+	{
+		BLOCK_CATEGORY category;
+		uint32 maxAddress;
+		uint128 hash;
+		uint32 size;
+		//Processor state the generated code depends on (ie.: float clamping mode)
+		uint32 flags;
+
+		bool operator<(const KEY&) const;
+	};
+
+	CBasicBlock::CodeTemplatePtr Find(const KEY&);
+	void Publish(const KEY&, CBasicBlock::CodeTemplatePtr);
+
+private:
+	typedef std::map<KEY, std::weak_ptr<CBasicBlock::CODE_TEMPLATE>> TemplateMap;
+
+	enum
+	{
+		PRUNE_INTERVAL = 0x1000,
+	};
+
+	void PruneExpiredTemplates();
+
+	std::shared_mutex m_mutex;
+	TemplateMap m_templates;
+	uint32 m_publishCount = 0;
+};
@@ -0,0 +1,141 @@
+#include "MappedImageStream.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+CMappedImageStream::CMappedImageStream(const fs::path& path)
+{
+#ifdef _WIN32
+	throw std::runtime_error("Mapped image streams are not supported on this platform.");
+#else
+	int fd = open(path.c_str(), O_RDONLY);
+	if(fd < 0)
+	{
+		throw std::runtime_error("Failed to open image file.");
+	}
+
+	struct stat fileStat = {};
+	if((fstat(fd, &fileStat) < 0) || (fileStat.st_size <= 0) ||
+	   (static_cast<uint64>(fileStat.st_size) > static_cast<uint64>(SIZE_MAX)))
+	{
+		close(fd);
+		throw std::runtime_error("Invalid image file size.");
+	}
+	m_size = fileStat.st_size;
+
+	void* data = mmap(nullptr, static_cast<size_t>(m_size), PROT_READ, MAP_PRIVATE, fd, 0);
+	//Mapping stays valid after the file is closed
+	close(fd);
+	if(data == MAP_FAILED)
+	{
+		throw std::runtime_error("Failed to map image file.");
+	}
+	m_data = reinterpret_cast<uint8*>(data);
+#endif
+}
+
+CMappedImageStream::~CMappedImageStream()
+{
+#ifndef _WIN32
+	if(m_data)
+	{
+		munmap(m_data, static_cast<size_t>(m_size));
+	}
+#endif
+}
+
+const uint8* CMappedImageStream::GetData(uint64 position, uint64 size)
+{
+	if((position > m_size) || (size > (m_size - position)))
+	{
+		return nullptr;
+	}
+	AdviseAccess(position, size);
+	return m_data + position;
+}
+
+void CMappedImageStream::Seek(int64 position, Framework::STREAM_SEEK_DIRECTION whence)
+{
+	switch(whence)
+	{
+	case Framework::STREAM_SEEK_SET:
+		m_position = position;
+		break;
+	case Framework::STREAM_SEEK_CUR:
+		m_position += position;
+		break;
+	case Framework::STREAM_SEEK_END:
+		m_position = m_size + position;
+		break;
+	}
+	m_isEof = false;
+}
+
+uint64 CMappedImageStream::Tell()
+{
+	return m_position;
+}
+
+uint64 CMappedImageStream::Read(void* buffer, uint64 size)
+{
+	if(m_position >= m_size)
+	{
+		m_isEof = true;
+		return 0;
+	}
+	size = std::min<uint64>(size, m_size - m_position);
+	AdviseAccess(m_position, size);
+	memcpy(buffer, m_data + m_position, size);
+	m_position += size;
+	return size;
+}
+
+uint64 CMappedImageStream::Write(const void*, uint64)
+{
+	throw std::runtime_error("Unable to write to mapped image, read only.");
+}
+
+bool CMappedImageStream::IsEOF()
+{
+	return m_isEof;
+}
+
+void CMappedImageStream::AdviseAccess(uint64 position, uint64 size)
+{
+	bool isSequential = (position >= m_nextSequentialPosition) && ((position - m_nextSequentialPosition) <= SEQUENTIAL_MAX_GAP);
+	m_nextSequentialPosition = position + size;
+	if(!isSequential)
+	{
+		//Random access, let the system handle it on its own
+		m_readAheadEnd = 0;
+		return;
+	}
+
+	//Wait until we're halfway through the previous window before requesting the next one
+	uint64 accessEnd = position + size;
+	if((accessEnd + (READAHEAD_SIZE / 2)) < m_readAheadEnd)
+	{
+		return;
+	}
+
+#ifndef _WIN32
+	static const uint64 pageSize = sysconf(_SC_PAGESIZE);
+	uint64 readAheadStart = std::max<uint64>(accessEnd, m_readAheadEnd) & ~(pageSize - 1);
+	uint64 readAheadEnd = std::min<uint64>(accessEnd + READAHEAD_SIZE, m_size);
+	if(readAheadStart < readAheadEnd)
+	{
+		auto readAheadSize = static_cast<size_t>(readAheadEnd - readAheadStart);
+		madvise(m_data + readAheadStart, readAheadSize, MADV_SEQUENTIAL);
+		madvise(m_data + readAheadStart, readAheadSize, MADV_WILLNEED);
+	}
+#endif
+	m_readAheadEnd = accessEnd + READAHEAD_SIZE;
+}
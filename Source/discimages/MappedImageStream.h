@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Stream.h"
+#include "filesystem_def.h"
+
+//Read only stream over an image file mapped in memory, lets block providers access sectors without copying them.
+//Sequential reads ask the system to fetch the data ahead of the read position.
+class CMappedImageStream : public Framework::CStream
+{
+public:
+	//Throws if the file can't be mapped (ex.: not enough address space on 32-bit platforms)
+	CMappedImageStream(const fs::path&);
+	virtual ~CMappedImageStream();
+
+	//Returns nullptr if the range is outside of the image
+	const uint8* GetData(uint64, uint64);
+
+	void Seek(int64, Framework::STREAM_SEEK_DIRECTION) override;
+	uint64 Tell() override;
+	uint64 Read(void*, uint64) override;
+	uint64 Write(const void*, uint64) override;
+	bool IsEOF() override;
+
+private:
+	enum
+	{
+		READAHEAD_SIZE = 0x200000,
+		//Allows skipping sector headers (ex.: CD-ROM XA) and still be considered sequential
+		SEQUENTIAL_MAX_GAP = 0x1000,
+	};
+
+	void AdviseAccess(uint64, uint64);
+
+	uint8* m_data = nullptr;
+	uint64 m_size = 0;
+	uint64 m_position = 0;
+	bool m_isEof = false;
+
+	uint64 m_nextSequentialPosition = ~0ULL;
+	uint64 m_readAheadEnd = 0;
+};
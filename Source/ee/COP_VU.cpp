@@ -51,6 +51,11 @@ void CCOP_VU::CompileInstruction(uint32 nAddress, CMipsJitter* codeGen, CMIPS* p
 	m_nImm5 = m_nID;
 	m_nImm15 = (uint16)((m_nOpcode >> 6) & 0x7FFF);
 
+	{
+		uint32 instrIndex = instrPosition / 4;
+		m_compileHints = (instrIndex < m_blockCompileHints.size()) ? m_blockCompileHints[instrIndex] : 0;
+	}
+
 	switch((m_nOpcode >> 26) & 0x3F)
 	{
 	case 0x12:
@@ -71,6 +76,97 @@ void CCOP_VU::CompileInstruction(uint32 nAddress, CMipsJitter* codeGen, CMIPS* p
 	}
 }
 
+void CCOP_VU::SetBlockCompileHints(std::vector<uint32> hints)
+{
+	m_blockCompileHints = std::move(hints);
+}
+
+CCOP_VU::MACFLAG_ACCESS CCOP_VU::GetMacFlagAccess(uint32 opcode)
+{
+	enum
+	{
+		OP_COP2 = 0x12,
+		COP2_CFC2 = 0x02,
+		COP2_CTC2 = 0x06,
+		COP2_V = 0x10,
+	};
+
+	if(((opcode >> 26) & 0x3F) != OP_COP2) return MACFLAG_ACCESS_NONE;
+
+	uint32 fmt = (opcode >> 21) & 0x1F;
+	uint32 fs = (opcode >> 11) & 0x1F;
+	switch(fmt)
+	{
+	case COP2_CFC2:
+		return ((fs == CTRL_REG_STATUS) || (fs == CTRL_REG_MAC)) ? MACFLAG_ACCESS_READ : MACFLAG_ACCESS_NONE;
+	case COP2_CTC2:
+		//Writes to these can change VU state in ways we don't track
+		return ((fs == CTRL_REG_STATUS) || (fs == CTRL_REG_FBRST) || (fs == CTRL_REG_CMSAR1)) ? MACFLAG_ACCESS_READ : MACFLAG_ACCESS_NONE;
+	default:
+		if(fmt < COP2_V) return MACFLAG_ACCESS_NONE;
+		break;
+	}
+
+	uint32 vectorOp = opcode & 0x3F;
+	if(vectorOp < 0x3C)
+	{
+		switch(vectorOp)
+		{
+		case 0x10:
+		case 0x11:
+		case 0x12:
+		case 0x13:
+		case 0x14:
+		case 0x15:
+		case 0x16:
+		case 0x17:
+		case 0x1D:
+		case 0x1F:
+		case 0x2B:
+		case 0x2F:
+			//MAX/MINI
+			return MACFLAG_ACCESS_NONE;
+		case 0x38:
+		case 0x39:
+			//VCALLMS/VCALLMSR, micro program receives our flag pipeline
+			return MACFLAG_ACCESS_READ;
+		default:
+			return (vectorOp < 0x30) ? MACFLAG_ACCESS_WRITE : MACFLAG_ACCESS_NONE;
+		}
+	}
+	else
+	{
+		uint32 vxOp = (opcode >> 6) & 0x1F;
+		switch(vxOp)
+		{
+		case 0x00:
+		case 0x01:
+		case 0x02:
+		case 0x03:
+		case 0x06:
+			//xxxAbc
+			return MACFLAG_ACCESS_WRITE;
+		case 0x07:
+			//MULAq, MULAi
+			return ((vectorOp == 0x3C) || (vectorOp == 0x3E)) ? MACFLAG_ACCESS_WRITE : MACFLAG_ACCESS_NONE;
+		case 0x08:
+			//ADDAq, MADDAq, ADDAi, MADDAi
+			return MACFLAG_ACCESS_WRITE;
+		case 0x09:
+			//MSUBAq, SUBAi, MSUBAi
+			return (vectorOp != 0x3C) ? MACFLAG_ACCESS_WRITE : MACFLAG_ACCESS_NONE;
+		case 0x0A:
+			//ADDA, MADDA, MULA
+			return (vectorOp != 0x3F) ? MACFLAG_ACCESS_WRITE : MACFLAG_ACCESS_NONE;
+		case 0x0B:
+			//SUBA, MSUBA
+			return ((vectorOp == 0x3C) || (vectorOp == 0x3D)) ? MACFLAG_ACCESS_WRITE : MACFLAG_ACCESS_NONE;
+		default:
+			return MACFLAG_ACCESS_NONE;
+		}
+	}
+}
+
 //////////////////////////////////////////////////
 //General Instructions
 //////////////////////////////////////////////////
@@ -154,11 +250,8 @@ void CCOP_VU::QMFC2()
 {
 	if(m_nFT == 0) return;
 
-	for(unsigned int i = 0; i < 4; i++)
-	{
-		m_codeGen->PushRel(offsetof(CMIPS, m_State.nCOP2[m_nFS].nV[i]));
-		m_codeGen->PullRel(offsetof(CMIPS, m_State.nGPR[m_nFT].nV[i]));
-	}
+	m_codeGen->MD_PushRel(offsetof(CMIPS, m_State.nCOP2[m_nFS]));
+	m_codeGen->MD_PullRel(offsetof(CMIPS, m_State.nGPR[m_nFT]));
 }
 
 //02
@@ -223,11 +316,8 @@ void CCOP_VU::QMTC2()
 {
 	if(m_nFS == 0) return;
 
-	for(unsigned int i = 0; i < 4; i++)
-	{
-		m_codeGen->PushRel(offsetof(CMIPS, m_State.nGPR[m_nFT].nV[i]));
-		m_codeGen->PullRel(offsetof(CMIPS, m_State.nCOP2[m_nFS].nV[i]));
-	}
+	m_codeGen->MD_PushRel(offsetof(CMIPS, m_State.nGPR[m_nFT]));
+	m_codeGen->MD_PullRel(offsetof(CMIPS, m_State.nCOP2[m_nFS]));
 }
 
 //06
@@ -361,7 +451,7 @@ void CCOP_VU::V()
 //03
 void CCOP_VU::VADDbc()
 {
-	VUShared::ADDbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::ADDbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //04
@@ -370,7 +460,7 @@ void CCOP_VU::VADDbc()
 //07
 void CCOP_VU::VSUBbc()
 {
-	VUShared::SUBbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::SUBbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //08
@@ -379,7 +469,7 @@ void CCOP_VU::VSUBbc()
 //0B
 void CCOP_VU::VMADDbc()
 {
-	VUShared::MADDbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::MADDbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //0C
@@ -388,7 +478,7 @@ void CCOP_VU::VMADDbc()
 //0F
 void CCOP_VU::VMSUBbc()
 {
-	VUShared::MSUBbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::MSUBbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //10
@@ -415,13 +505,13 @@ void CCOP_VU::VMINIbc()
 //1B
 void CCOP_VU::VMULbc()
 {
-	VUShared::MULbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::MULbc(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //1C
 void CCOP_VU::VMULq()
 {
-	VUShared::MULq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::MULq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //1D
@@ -433,7 +523,7 @@ void CCOP_VU::VMAXi()
 //1E
 void CCOP_VU::VMULi()
 {
-	VUShared::MULi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::MULi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //1F
@@ -445,67 +535,67 @@ void CCOP_VU::VMINIi()
 //20
 void CCOP_VU::VADDq()
 {
-	VUShared::ADDq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::ADDq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //21
 void CCOP_VU::VMADDq()
 {
-	VUShared::MADDq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::MADDq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //22
 void CCOP_VU::VADDi()
 {
-	VUShared::ADDi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::ADDi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //23
 void CCOP_VU::VMADDi()
 {
-	VUShared::MADDi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::MADDi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //24
 void CCOP_VU::VSUBq()
 {
-	VUShared::SUBq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::SUBq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //25
 void CCOP_VU::VMSUBq()
 {
-	VUShared::MSUBq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::MSUBq(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //26
 void CCOP_VU::VSUBi()
 {
-	VUShared::SUBi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::SUBi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //27
 void CCOP_VU::VMSUBi()
 {
-	VUShared::MSUBi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, 0);
+	VUShared::MSUBi(m_codeGen, m_nDest, m_nFD, m_nFS, 0, m_compileHints);
 }
 
 //28
 void CCOP_VU::VADD()
 {
-	VUShared::ADD(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, 0);
+	VUShared::ADD(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //29
 void CCOP_VU::VMADD()
 {
-	VUShared::MADD(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, 0);
+	VUShared::MADD(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //2A
 void CCOP_VU::VMUL()
 {
-	VUShared::MUL(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, 0);
+	VUShared::MUL(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //2B
@@ -517,19 +607,19 @@ void CCOP_VU::VMAX()
 //2C
 void CCOP_VU::VSUB()
 {
-	VUShared::SUB(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, 0);
+	VUShared::SUB(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //2D
 void CCOP_VU::VMSUB()
 {
-	VUShared::MSUB(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, 0);
+	VUShared::MSUB(m_codeGen, m_nDest, m_nFD, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //2E
 void CCOP_VU::VOPMSUB()
 {
-	VUShared::OPMSUB(m_codeGen, m_nFD, m_nFS, m_nFT, 0, 0);
+	VUShared::OPMSUB(m_codeGen, m_nFD, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //2F
@@ -626,31 +716,31 @@ void CCOP_VU::VX3()
 //
 void CCOP_VU::VADDAbc()
 {
-	VUShared::ADDAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::ADDAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //
 void CCOP_VU::VSUBAbc()
 {
-	VUShared::SUBAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::SUBAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //
 void CCOP_VU::VMADDAbc()
 {
-	VUShared::MADDAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::MADDAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //
 void CCOP_VU::VMSUBAbc()
 {
-	VUShared::MSUBAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::MSUBAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //
 void CCOP_VU::VMULAbc()
 {
-	VUShared::MULAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, 0);
+	VUShared::MULAbc(m_codeGen, m_nDest, m_nFS, m_nFT, m_nBc, 0, m_compileHints);
 }
 
 //////////////////////////////////////////////////
@@ -672,25 +762,25 @@ void CCOP_VU::VFTOI0()
 //07
 void CCOP_VU::VMULAq()
 {
-	VUShared::MULAq(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::MULAq(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //08
 void CCOP_VU::VADDAq()
 {
-	VUShared::ADDAq(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::ADDAq(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //0A
 void CCOP_VU::VADDA()
 {
-	VUShared::ADDA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, 0);
+	VUShared::ADDA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //0B
 void CCOP_VU::VSUBA()
 {
-	VUShared::SUBA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, 0);
+	VUShared::SUBA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //0C
@@ -749,25 +839,25 @@ void CCOP_VU::VABS()
 //08
 void CCOP_VU::VMADDAq()
 {
-	VUShared::MADDAq(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::MADDAq(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //09
 void CCOP_VU::VMSUBAq()
 {
-	VUShared::MSUBAq(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::MSUBAq(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //0A
 void CCOP_VU::VMADDA()
 {
-	VUShared::MADDA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, 0);
+	VUShared::MADDA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //0B
 void CCOP_VU::VMSUBA()
 {
-	VUShared::MSUBA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, 0);
+	VUShared::MSUBA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //0C
@@ -820,25 +910,25 @@ void CCOP_VU::VFTOI12()
 //07
 void CCOP_VU::VMULAi()
 {
-	VUShared::MULAi(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::MULAi(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //08
 void CCOP_VU::VADDAi()
 {
-	VUShared::ADDAi(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::ADDAi(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //09
 void CCOP_VU::VSUBAi()
 {
-	VUShared::SUBAi(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::SUBAi(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //0A
 void CCOP_VU::VMULA()
 {
-	VUShared::MULA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, 0);
+	VUShared::MULA(m_codeGen, m_nDest, m_nFS, m_nFT, 0, m_compileHints);
 }
 
 //0B
@@ -897,13 +987,13 @@ void CCOP_VU::VCLIP()
 //08
 void CCOP_VU::VMADDAi()
 {
-	VUShared::MADDAi(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::MADDAi(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //09
 void CCOP_VU::VMSUBAi()
 {
-	VUShared::MSUBAi(m_codeGen, m_nDest, m_nFS, 0, 0);
+	VUShared::MSUBAi(m_codeGen, m_nDest, m_nFS, 0, m_compileHints);
 }
 
 //0B
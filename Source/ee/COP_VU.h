@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "../MIPSCoprocessor.h"
 #include "../MIPSReflection.h"
 #include "../Ps2Const.h"
@@ -15,6 +16,18 @@ public:
 	uint32 GetEffectiveAddress(uint32, uint32) override;
 	MIPS_BRANCH_TYPE IsBranch(uint32) override;
 
+	enum MACFLAG_ACCESS
+	{
+		MACFLAG_ACCESS_NONE,
+		MACFLAG_ACCESS_READ,
+		MACFLAG_ACCESS_WRITE,
+	};
+
+	static MACFLAG_ACCESS GetMacFlagAccess(uint32);
+
+	//Hints for the block being compiled, indexed by instruction position
+	void SetBlockCompileHints(std::vector<uint32>);
+
 protected:
 	typedef void (CCOP_VU::*InstructionFuncConstant)();
 
@@ -186,6 +199,8 @@ private:
 	uint8 m_nID = 0;
 	uint8 m_nImm5 = 0;
 	uint16 m_nImm15 = 0;
+	uint32 m_compileHints = 0;
+	std::vector<uint32> m_blockCompileHints;
 	static const uint32 m_vuMemAddressMask = (PS2::VUMEM0SIZE - 1);
 
 	//Reflection tables
@@ -1,135 +1,210 @@
 #include "EeBasicBlock.h"
 #include "offsetof_def.h"
+#include "COP_VU.h"
+#include "VUShared.h"
+#include "../MA_MIPSIV.h"
+
+void CEeBasicBlock::CompileRange(CMipsJitter* jitter)
+{
+	auto arch = static_cast<CMA_MIPSIV*>(m_context.m_pArch);
+	auto cop2 = static_cast<CCOP_VU*>(m_context.m_pCOP[2]);
+	if(!IsEmpty())
+	{
+		arch->SetBlockCompileHints(ComputeGprUpperHalfCompileHints());
+		cop2->SetBlockCompileHints(ComputeCop2CompileHints());
+	}
+	CBasicBlock::CompileRange(jitter);
+	arch->SetBlockCompileHints(std::vector<uint32>());
+	cop2->SetBlockCompileHints(std::vector<uint32>());
+}
 
 void CEeBasicBlock::CompileEpilog(CMipsJitter* jitter, bool loopsOnItself)
 {
-	if(IsIdleLoopBlock())
+	if(IsIdleLoopBlock(true))
 	{
-		jitter->PushCst(MIPS_EXCEPTION_IDLE);
-		jitter->PullRel(offsetof(CMIPS, m_State.nHasException));
+		CompileIdleLoopCheck(jitter);
 	}
 
 	CBasicBlock::CompileEpilog(jitter, loopsOnItself);
 }
 
-bool CEeBasicBlock::IsIdleLoopBlock() const
+std::vector<uint32> CEeBasicBlock::ComputeCop2CompileHints() const
+{
+	//Macro mode instructions that write MAC flags can skip queuing their result
+	//if another instruction of this block overwrites it before anything can read it.
+	//The last writer of the block is always kept since successors might read it.
+	uint32 instructionCount = ((m_end - m_begin) / 4) + 1;
+	std::vector<uint32> hints(instructionCount, 0);
+
+	bool macFlagsOverwritten = false;
+	for(uint32 instructionIndex = instructionCount; instructionIndex != 0; instructionIndex--)
+	{
+		uint32 address = m_begin + ((instructionIndex - 1) * 4);
+		uint32 opcode = m_context.m_pMemoryMap->GetInstruction(address);
+		switch(CCOP_VU::GetMacFlagAccess(opcode))
+		{
+		case CCOP_VU::MACFLAG_ACCESS_WRITE:
+			if(macFlagsOverwritten)
+			{
+				hints[instructionIndex - 1] |= VUShared::COMPILEHINT_SKIPFMACUPDATE;
+			}
+			macFlagsOverwritten = true;
+			break;
+		case CCOP_VU::MACFLAG_ACCESS_READ:
+			macFlagsOverwritten = false;
+			break;
+		default:
+			break;
+		}
+	}
+
+	return hints;
+}
+
+std::vector<uint32> CEeBasicBlock::ComputeGprUpperHalfCompileHints() const
 {
+	//32-bit operations don't need to write the sign extended upper half of their result
+	//if another instruction of this block overwrites it before anything can read it.
+	//Instructions we don't know about are assumed to read the whole register file.
+	//Not done when TLB exceptions are enabled since loads and stores could leave the block early.
 	enum OP
 	{
-		OP_BEQ = 0x04,
-		OP_BNE = 0x05,
-		OP_SLTIU = 0x0B,
+		OP_SPECIAL = 0x00,
+		OP_ADDI = 0x08,
+		OP_ADDIU = 0x09,
 		OP_ANDI = 0x0C,
+		OP_ORI = 0x0D,
 		OP_XORI = 0x0E,
 		OP_LUI = 0x0F,
-		OP_LQ = 0x1E,
+		OP_LB = 0x20,
+		OP_LH = 0x21,
 		OP_LW = 0x23,
 		OP_LBU = 0x24,
+		OP_LHU = 0x25,
+		OP_SB = 0x28,
+		OP_SH = 0x29,
+		OP_SW = 0x2B,
 	};
 
 	enum
 	{
-		OP_SPECIAL_SLT = 0x2A,
-		OP_SPECIAL_SLTU = 0x2B,
+		OP_SPECIAL_SLL = 0x00,
+		OP_SPECIAL_SRL = 0x02,
+		OP_SPECIAL_SRA = 0x03,
+		OP_SPECIAL_SLLV = 0x04,
+		OP_SPECIAL_SRLV = 0x06,
+		OP_SPECIAL_SRAV = 0x07,
+		OP_SPECIAL_ADD = 0x20,
+		OP_SPECIAL_ADDU = 0x21,
+		OP_SPECIAL_SUB = 0x22,
+		OP_SPECIAL_SUBU = 0x23,
 	};
 
-	uint32 endInstructionAddress = m_end - 4;
-	uint32 endInstruction = m_context.m_pMemoryMap->GetWord(endInstructionAddress);
-
-	//We need a branch at the end of the block
-	auto branchType = m_context.m_pArch->IsInstructionBranch(&m_context, endInstructionAddress, endInstruction);
-	if(branchType != MIPS_BRANCH_NORMAL) return false;
-
-	//Check that the branch target is ourself
-	uint32 branchTarget = m_context.m_pArch->GetInstructionEffectiveAddress(&m_context, endInstructionAddress, endInstruction);
-	if(branchTarget == MIPS_INVALID_PC) return false;
-	if(branchTarget != m_begin) return false;
-
-	uint32 compareRs = 0;
-	uint32 compareRt = 0;
+	uint32 instructionCount = ((m_end - m_begin) / 4) + 1;
+	std::vector<uint32> hints(instructionCount, 0);
 
-	//Check what kind of branching instruction we have.
+	if(m_context.m_TLBExceptionChecker != nullptr)
 	{
-		uint32 op = (endInstruction >> 26) & 0x3F;
-		uint32 rt = (endInstruction >> 16) & 0x1F;
-		uint32 rs = (endInstruction >> 21) & 0x1F;
-
-		//We want a BEQ or BNE
-		if((op != OP_BEQ) && (op != OP_BNE)) return false;
-
-		compareRs = rs;
-		compareRt = rt;
+		return hints;
 	}
 
-	uint32 defState = 0; //Set of completely new definitions of registers within this block
-	uint32 useState = 0; //Set of previous state usage within this block
-
-	//Check all instructions inside to see if we can prove it's waiting for some kind of flag
-	for(uint32 address = m_begin; address <= m_end; address += 4)
+	//Registers which upper half might be read after the current instruction
+	uint32 liveUpperHalves = ~0U;
+	for(uint32 instructionIndex = instructionCount; instructionIndex != 0; instructionIndex--)
 	{
-		//Don't check branch instruction as we've checked it already
-		if(address == endInstructionAddress) continue;
+		uint32 address = m_begin + ((instructionIndex - 1) * 4);
+		uint32 opcode = m_context.m_pMemoryMap->GetInstruction(address);
 
-		uint32 inst = m_context.m_pMemoryMap->GetWord(address);
-		if(inst == 0) continue;
-		uint32 special = inst & 0x3F;
-		uint32 rd = (inst >> 11) & 0x1F;
-		uint32 rt = (inst >> 16) & 0x1F;
-		uint32 rs = (inst >> 21) & 0x1F;
-		uint32 op = (inst >> 26) & 0x3F;
+		uint32 op = (opcode >> 26) & 0x3F;
+		uint32 rs = (opcode >> 21) & 0x1F;
+		uint32 rt = (opcode >> 16) & 0x1F;
+		uint32 rd = (opcode >> 11) & 0x1F;
 
-		uint32 newDef = 0;
-		uint32 newUse = 0;
+		bool known = true;
+		bool canSkipUpperHalf = false;
+		uint32 writeReg = 0;
+		uint32 readUpperHalves = 0;
 
 		switch(op)
 		{
-		case 0x00:
-			switch(special)
+		case OP_SPECIAL:
+			switch(opcode & 0x3F)
 			{
-			case OP_SPECIAL_SLT:
-			case OP_SPECIAL_SLTU:
-				newUse = (1 << rs) | (1 << rt);
-				newDef = (1 << rd);
+			case OP_SPECIAL_SLL:
+			case OP_SPECIAL_SRL:
+			case OP_SPECIAL_SRA:
+			case OP_SPECIAL_SLLV:
+			case OP_SPECIAL_SRLV:
+			case OP_SPECIAL_SRAV:
+			case OP_SPECIAL_ADD:
+			case OP_SPECIAL_ADDU:
+			case OP_SPECIAL_SUB:
+			case OP_SPECIAL_SUBU:
+				writeReg = rd;
+				canSkipUpperHalf = true;
 				break;
 			default:
-				//We don't know what this does, let's not take a chance
-				return false;
+				known = false;
+				break;
 			}
 			break;
+		case OP_ADDIU:
+			//ADDIU R0, R0, $x is used for dynamic linking and raises an exception
+			if((rs == 0) && (rt == 0))
+			{
+				known = false;
+				break;
+			}
+			[[fallthrough]];
+		case OP_ADDI:
+		case OP_ANDI:
 		case OP_LUI:
-			newDef = (1 << rt);
-			break;
+		case OP_LB:
+		case OP_LH:
 		case OP_LW:
-		case OP_LQ:
 		case OP_LBU:
-		case OP_SLTIU:
+		case OP_LHU:
+			writeReg = rt;
+			canSkipUpperHalf = true;
+			break;
+		case OP_ORI:
+			//Upper half is left untouched when source and destination are the same
+			if(rs != rt)
+			{
+				writeReg = rt;
+				readUpperHalves = (1 << rs);
+			}
+			break;
 		case OP_XORI:
-			newUse = (1 << rs);
-			newDef = (1 << rt);
+			writeReg = rt;
+			readUpperHalves = (1 << rs);
+			break;
+		case OP_SB:
+		case OP_SH:
+		case OP_SW:
 			break;
 		default:
-			//We don't know what this does, let's not take a chance
-			return false;
+			known = false;
+			break;
 		}
 
-		//Bail if this defines any state that we previously used
-		if(useState & newDef)
+		if(!known)
 		{
-			return false;
+			liveUpperHalves = ~0U;
+			continue;
 		}
 
-		//Remove uses from defs within this block
-		newUse &= ~defState;
-
-		defState |= newDef;
-		useState |= newUse;
+		if(writeReg != 0)
+		{
+			uint32 writeMask = (1 << writeReg);
+			if(canSkipUpperHalf && ((liveUpperHalves & writeMask) == 0))
+			{
+				hints[instructionIndex - 1] |= CMA_MIPSIV::COMPILEHINT_SKIPUPPERHALF;
+			}
+			liveUpperHalves &= ~writeMask;
+		}
+		liveUpperHalves |= readUpperHalves;
 	}
 
-	//Just make sure that we've at least defined our comparision register
-	FRAMEWORK_MAYBE_UNUSED bool compareRsDefined = defState & (1 << compareRs);
-	FRAMEWORK_MAYBE_UNUSED bool compareRtDefined = defState & (1 << compareRt);
-
-	assert(compareRsDefined || compareRtDefined);
-
-	return true;
+	return hints;
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <vector>
 #include "BasicBlock.h"
 
 class CEeBasicBlock : public CBasicBlock
@@ -7,9 +8,13 @@ class CEeBasicBlock : public CBasicBlock
 public:
 	using CBasicBlock::CBasicBlock;
 
+	void CompileRange(CMipsJitter*) override;
+
 protected:
 	void CompileEpilog(CMipsJitter*, bool) override;
 
+	std::vector<uint32> ComputeGprUpperHalfCompileHints() const;
+
 private:
-	bool IsIdleLoopBlock() const;
+	std::vector<uint32> ComputeCop2CompileHints() const;
 };
@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 #include "EeExecutor.h"
 #include "../Ps2Const.h"
 #include "AlignedAlloc.h"
 #include "EeBasicBlock.h"
+#include "EeHleBasicBlock.h"
 #include "xxhash.h"
 
 #if defined(__unix__) || defined(__ANDROID__) || defined(__APPLE__)
@@ -31,7 +37,43 @@
 
 #endif
 
-static CEeExecutor* g_eeExecutor = nullptr;
+#if defined(_WIN32) || defined(__unix__) || defined(__ANDROID__)
+#define USE_EXECUTOR_REGISTRY
+#endif
+
+#ifdef USE_EXECUTOR_REGISTRY
+
+//Every virtual machine running in the process has its own executor, but faults are
+//reported to a single process-wide handler that needs to find which one owns the address.
+//The handler can't take locks, slots are thus atomic and only written while holding the mutex.
+//Handlers running on other threads might still use an executor after its slot was cleared,
+//the in-flight count lets us wait for them before the executor goes away.
+#define MAX_EE_EXECUTORS (64)
+
+static std::atomic<CEeExecutor*> g_eeExecutors[MAX_EE_EXECUTORS] = {};
+static std::atomic<unsigned int> g_eeExecutorHandlersInFlight = 0;
+static std::mutex g_eeExecutorsMutex;
+static unsigned int g_eeExecutorCount = 0;
+
+class CExecutorHandlerInFlight
+{
+public:
+	CExecutorHandlerInFlight()
+	{
+		g_eeExecutorHandlersInFlight++;
+	}
+
+	~CExecutorHandlerInFlight()
+	{
+		g_eeExecutorHandlersInFlight--;
+	}
+};
+
+#if defined(_WIN32)
+static LPVOID g_exceptionHandler = NULL;
+#endif
+
+#endif
 
 CEeExecutor::CEeExecutor(CMIPS& context, uint8* ram)
     : CGenericMipsExecutor(context, 0x20000000, BLOCK_CATEGORY_PS2_EE)
@@ -42,16 +84,29 @@ CEeExecutor::CEeExecutor(CMIPS& context, uint8* ram)
 
 void CEeExecutor::AddExceptionHandler()
 {
-	assert(g_eeExecutor == nullptr);
-	g_eeExecutor = this;
-
 #ifdef DISABLE_PROTECTION
 	return;
 #endif
 
+#ifdef USE_EXECUTOR_REGISTRY
+	std::lock_guard<std::mutex> registryLock(g_eeExecutorsMutex);
+	auto slotIterator = std::find_if(std::begin(g_eeExecutors), std::end(g_eeExecutors),
+	                                 [](const std::atomic<CEeExecutor*>& slot) { return slot.load() == nullptr; });
+	if(slotIterator == std::end(g_eeExecutors))
+	{
+		throw std::runtime_error("Too many EE executors running in this process.");
+	}
+	slotIterator->store(this);
+	if(g_eeExecutorCount++ != 0)
+	{
+		//Process-wide handler is already installed
+		return;
+	}
+#endif
+
 #if defined(_WIN32)
-	m_handler = AddVectoredExceptionHandler(TRUE, &CEeExecutor::HandleException);
-	assert(m_handler != NULL);
+	g_exceptionHandler = AddVectoredExceptionHandler(TRUE, &CEeExecutor::HandleException);
+	assert(g_exceptionHandler != NULL);
 #elif defined(__unix__) || defined(__ANDROID__)
 	struct sigaction sigAction;
 	sigAction.sa_handler = nullptr;
@@ -78,16 +133,33 @@ void CEeExecutor::RemoveExceptionHandler()
 {
 #ifndef DISABLE_PROTECTION
 
+#ifdef USE_EXECUTOR_REGISTRY
+	std::lock_guard<std::mutex> registryLock(g_eeExecutorsMutex);
+	auto slotIterator = std::find_if(std::begin(g_eeExecutors), std::end(g_eeExecutors),
+	                                 [this](const std::atomic<CEeExecutor*>& slot) { return slot.load() == this; });
+	if(slotIterator == std::end(g_eeExecutors)) return;
+	slotIterator->store(nullptr);
+	assert(g_eeExecutorCount != 0);
+	g_eeExecutorCount--;
+	//Handlers that started after this point can't see us anymore
+	while(g_eeExecutorHandlersInFlight.load() != 0)
+	{
+		std::this_thread::yield();
+	}
+#endif
+
 #if defined(_WIN32)
-	RemoveVectoredExceptionHandler(m_handler);
+	if(g_eeExecutorCount == 0)
+	{
+		RemoveVectoredExceptionHandler(g_exceptionHandler);
+		g_exceptionHandler = NULL;
+	}
 #elif defined(__APPLE__)
 	m_running = false;
 	m_handlerThread.join();
 #endif
 
 #endif //!DISABLE_PROTECTION
-
-	g_eeExecutor = nullptr;
 }
 
 void CEeExecutor::AttachExceptionHandlerToThread()
@@ -114,6 +186,13 @@ void CEeExecutor::Reset()
 	CGenericMipsExecutor::Reset();
 }
 
+void CEeExecutor::SetHleFunctions(Ee::LibcHle::FunctionMap hleFunctions)
+{
+	m_hleFunctions = std::move(hleFunctions);
+	//Blocks might have been compiled at the location of those functions already
+	Reset();
+}
+
 void CEeExecutor::ClearActiveBlocksInRange(uint32 start, uint32 end, bool executing)
 {
 	uint32 rangeSize = end - start;
@@ -133,6 +212,23 @@ BasicBlockPtr CEeExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end
 		SetMemoryProtected(m_ram + start, blockSize, true);
 	}
 
+#if !defined(AOT_BUILD_CACHE) && !defined(AOT_USE_CACHE)
+	//Replaced routines are checked again since the executable might have loaded other code over them.
+	//Handlers don't raise TLB exceptions, so they are only used when those can't happen.
+	auto hleFunctionIterator = m_hleFunctions.find(start);
+	if((hleFunctionIterator != std::end(m_hleFunctions)) && (m_context.m_TLBExceptionChecker == nullptr) &&
+	   !m_context.HasBreakpointInRange(start, end))
+	{
+		const auto& hleFunction = hleFunctionIterator->second;
+		if(Ee::LibcHle::IsFunctionAt(hleFunction, m_ram, PS2::EE_RAM_SIZE, start))
+		{
+			auto result = std::make_shared<CEeHleBasicBlock>(context, start, end, m_blockCategory, hleFunction.handler);
+			result->Compile();
+			return result;
+		}
+	}
+#endif
+
 	auto blockMemory = reinterpret_cast<uint32*>(alloca(blockSize));
 	for(uint32 address = start; address <= end; address += 4)
 	{
@@ -145,7 +241,7 @@ BasicBlockPtr CEeExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end
 	uint128 hash;
 	memcpy(&hash, &xxHash, sizeof(xxHash));
 	static_assert(sizeof(hash) == sizeof(xxHash));
-	auto blockKey = std::make_pair(hash, blockSize);
+	auto blockKey = std::make_tuple(hash, blockSize, m_context.m_clampingMode);
 
 	bool hasBreakpoint = m_context.HasBreakpointInRange(start, end);
 	if(!hasBreakpoint)
@@ -170,11 +266,15 @@ BasicBlockPtr CEeExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end
 	}
 
 	auto result = std::make_shared<CEeBasicBlock>(context, start, end, m_blockCategory);
-	result->Compile();
 	if(!hasBreakpoint)
 	{
+		CompileSharedBlock(result.get(), hash, blockSize, 0);
 		m_cachedBlocks.insert(std::make_pair(blockKey, result));
 	}
+	else
+	{
+		result->Compile();
+	}
 	return result;
 }
 
@@ -217,7 +317,17 @@ void CEeExecutor::SetMemoryProtected(void* addr, size_t size, bool protect)
 
 LONG WINAPI CEeExecutor::HandleException(_EXCEPTION_POINTERS* exceptionInfo)
 {
-	return g_eeExecutor->HandleExceptionInternal(exceptionInfo);
+	CExecutorHandlerInFlight handlerInFlight;
+	for(const auto& slot : g_eeExecutors)
+	{
+		auto executor = slot.load();
+		if(executor == nullptr) continue;
+		if(executor->HandleExceptionInternal(exceptionInfo) == EXCEPTION_CONTINUE_EXECUTION)
+		{
+			return EXCEPTION_CONTINUE_EXECUTION;
+		}
+	}
+	return EXCEPTION_CONTINUE_SEARCH;
 }
 
 LONG CEeExecutor::HandleExceptionInternal(_EXCEPTION_POINTERS* exceptionInfo)
@@ -236,20 +346,29 @@ LONG CEeExecutor::HandleExceptionInternal(_EXCEPTION_POINTERS* exceptionInfo)
 #elif defined(__unix__) || defined(__ANDROID__)
 
 void CEeExecutor::HandleException(int sigId, siginfo_t* sigInfo, void* baseContext)
-{
-	g_eeExecutor->HandleExceptionInternal(sigId, sigInfo, baseContext);
-}
-
-void CEeExecutor::HandleExceptionInternal(int sigId, siginfo_t* sigInfo, void* baseContext)
 {
 	if(sigId != SIGSEGV) return;
-	if(HandleAccessFault(reinterpret_cast<intptr_t>(sigInfo->si_addr)))
 	{
-		return;
+		CExecutorHandlerInFlight handlerInFlight;
+		for(const auto& slot : g_eeExecutors)
+		{
+			auto executor = slot.load();
+			if(executor == nullptr) continue;
+			if(executor->HandleExceptionInternal(sigId, sigInfo, baseContext))
+			{
+				return;
+			}
+		}
 	}
+	//Not caused by one of our protected pages, let the fault crash the process normally
 	signal(SIGSEGV, SIG_DFL);
 }
 
+bool CEeExecutor::HandleExceptionInternal(int sigId, siginfo_t* sigInfo, void* baseContext)
+{
+	return HandleAccessFault(reinterpret_cast<intptr_t>(sigInfo->si_addr));
+}
+
 #elif defined(__APPLE__)
 
 void CEeExecutor::HandlerThreadProc()
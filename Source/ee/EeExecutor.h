@@ -9,7 +9,9 @@
 #include <signal.h>
 #endif
 
+#include <tuple>
 #include "../GenericMipsExecutor.h"
+#include "Ee_LibcHle.h"
 
 class CEeExecutor : public CGenericMipsExecutor<BlockLookupTwoWay>
 {
@@ -27,25 +29,30 @@ public:
 
 	BasicBlockPtr BlockFactory(CMIPS&, uint32, uint32) override;
 
+	void SetHleFunctions(Ee::LibcHle::FunctionMap);
+
+protected:
+	void SetMemoryProtected(void*, size_t, bool);
+
 private:
-	typedef std::pair<uint128, uint32> CachedBlockKey;
+	//Block contents hash, block size and float clamping mode
+	typedef std::tuple<uint128, uint32, FpUtils::CLAMPING_MODE> CachedBlockKey;
 	typedef std::map<CachedBlockKey, BasicBlockPtr> CachedBlockMap;
 	CachedBlockMap m_cachedBlocks;
 
+	Ee::LibcHle::FunctionMap m_hleFunctions;
+
 	uint8* m_ram = nullptr;
 	size_t m_pageSize = 0;
 
 	bool HandleAccessFault(intptr_t);
-	void SetMemoryProtected(void*, size_t, bool);
 
 #if defined(_WIN32)
 	static LONG CALLBACK HandleException(_EXCEPTION_POINTERS*);
 	LONG HandleExceptionInternal(_EXCEPTION_POINTERS*);
-
-	LPVOID m_handler = NULL;
 #elif defined(__unix__) || defined(__ANDROID__)
 	static void HandleException(int, siginfo_t*, void*);
-	void HandleExceptionInternal(int, siginfo_t*, void*);
+	bool HandleExceptionInternal(int, siginfo_t*, void*);
 #elif defined(__APPLE__)
 	void HandlerThreadProc();
 
@@ -0,0 +1,33 @@
+#include "EeHleBasicBlock.h"
+#include "offsetof_def.h"
+
+CEeHleBasicBlock::CEeHleBasicBlock(CMIPS& context, uint32 begin, uint32 end, BLOCK_CATEGORY category, Ee::LibcHle::FunctionHandler handler)
+    : CBasicBlock(context, begin, end, category)
+    , m_handler(handler)
+{
+	assert(m_handler);
+}
+
+void CEeHleBasicBlock::CompileRange(CMipsJitter* jitter)
+{
+	CompileProlog(jitter);
+
+	jitter->PushCtx();
+	jitter->Call(reinterpret_cast<void*>(m_handler), 1, Jitter::CJitter::RETURN_VALUE_NONE);
+
+	//Return to the caller, the handler already charged the cycles it took.
+	//No trampoline is used, the block is never linked to the ones that follow it.
+	jitter->PushRel(offsetof(CMIPS, m_State.nGPR[CMIPS::RA].nV[0]));
+	jitter->PullRel(offsetof(CMIPS, m_State.nPC));
+
+	jitter->PushRel(offsetof(CMIPS, m_State.cycleQuota));
+	jitter->PushCst(0);
+	jitter->BeginIf(Jitter::CONDITION_LE);
+	{
+		jitter->PushRel(offsetof(CMIPS, m_State.nHasException));
+		jitter->PushCst(MIPS_EXCEPTION_STATUS_QUOTADONE);
+		jitter->Or();
+		jitter->PullRel(offsetof(CMIPS, m_State.nHasException));
+	}
+	jitter->EndIf();
+}
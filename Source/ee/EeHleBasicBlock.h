@@ -0,0 +1,17 @@
+#pragma once
+
+#include "../BasicBlock.h"
+#include "Ee_LibcHle.h"
+
+//Block placed at the start of a guest routine that is replaced by a native handler.
+//It calls the handler and returns to the caller without running any guest code.
+class CEeHleBasicBlock : public CBasicBlock
+{
+public:
+	CEeHleBasicBlock(CMIPS&, uint32, uint32, BLOCK_CATEGORY, Ee::LibcHle::FunctionHandler);
+
+	void CompileRange(CMipsJitter*) override;
+
+private:
+	Ee::LibcHle::FunctionHandler m_handler = nullptr;
+};
@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <cstring>
+#include "Ee_LibcHle.h"
+#include "../MIPS.h"
+#include "../MemoryUtils.h"
+
+using namespace Ee;
+
+//Cycles charged for a call, whatever the size of its arguments
+#define CALL_CYCLES (16)
+
+//Guest routines process about a word per cycle in their loops
+#define BYTES_PER_CYCLE (4)
+
+static uint8* GetMemoryPointer(CMIPS* context, uint32 address)
+{
+	auto page = reinterpret_cast<uint8*>(context->m_pageLookup[address / MIPS_PAGE_SIZE]);
+	if(page == nullptr) return nullptr;
+	return page + (address % MIPS_PAGE_SIZE);
+}
+
+static uint32 GetPageRemainder(uint32 address)
+{
+	return MIPS_PAGE_SIZE - (address % MIPS_PAGE_SIZE);
+}
+
+static uint8 GetByte(CMIPS* context, uint32 address)
+{
+	if(auto memory = GetMemoryPointer(context, address))
+	{
+		return *memory;
+	}
+	return static_cast<uint8>(MemoryUtils_GetByteProxy(context, address));
+}
+
+static uint32 GetArgument(CMIPS* context, unsigned int reg)
+{
+	return context->m_State.nGPR[reg].nV[0];
+}
+
+static void SetReturnValue(CMIPS* context, uint32 value)
+{
+	context->m_State.nGPR[CMIPS::V0].nD0 = static_cast<int32>(value);
+}
+
+static void ChargeCycles(CMIPS* context, uint32 byteCount)
+{
+	context->m_State.cycleQuota -= CALL_CYCLES + (byteCount / BYTES_PER_CYCLE);
+}
+
+//Copies page by page, accesses to memory that isn't directly mapped (ie.: registers) are done one byte at a time.
+//Always copies forward like the guest routine, overlapping buffers give the same result on both paths.
+static void CopyMemory(CMIPS* context, uint32 dstAddress, uint32 srcAddress, uint32 size)
+{
+	while(size != 0)
+	{
+		uint32 chunkSize = std::min<uint32>(size, std::min<uint32>(GetPageRemainder(dstAddress), GetPageRemainder(srcAddress)));
+		auto dst = GetMemoryPointer(context, dstAddress);
+		auto src = GetMemoryPointer(context, srcAddress);
+		if(dst && src)
+		{
+			if((dst > src) && (dst < (src + chunkSize)))
+			{
+				for(uint32 i = 0; i < chunkSize; i++)
+				{
+					dst[i] = src[i];
+				}
+			}
+			else
+			{
+				memmove(dst, src, chunkSize);
+			}
+		}
+		else
+		{
+			for(uint32 i = 0; i < chunkSize; i++)
+			{
+				MemoryUtils_SetByteProxy(context, GetByte(context, srcAddress + i), dstAddress + i);
+			}
+		}
+		dstAddress += chunkSize;
+		srcAddress += chunkSize;
+		size -= chunkSize;
+	}
+}
+
+static uint32 GetStringLength(CMIPS* context, uint32 address)
+{
+	uint32 length = 0;
+	while(1)
+	{
+		uint32 chunkSize = GetPageRemainder(address + length);
+		if(auto memory = GetMemoryPointer(context, address + length))
+		{
+			if(auto terminator = reinterpret_cast<const uint8*>(memchr(memory, 0, chunkSize)))
+			{
+				return length + static_cast<uint32>(terminator - memory);
+			}
+			length += chunkSize;
+		}
+		else
+		{
+			if(GetByte(context, address + length) == 0)
+			{
+				return length;
+			}
+			length++;
+		}
+	}
+}
+
+static void Hle_memcpy(CMIPS* context)
+{
+	uint32 dstAddress = GetArgument(context, CMIPS::A0);
+	uint32 srcAddress = GetArgument(context, CMIPS::A1);
+	uint32 size = GetArgument(context, CMIPS::A2);
+	CopyMemory(context, dstAddress, srcAddress, size);
+	SetReturnValue(context, dstAddress);
+	ChargeCycles(context, size);
+}
+
+static void Hle_memset(CMIPS* context)
+{
+	uint32 dstAddress = GetArgument(context, CMIPS::A0);
+	uint8 value = static_cast<uint8>(GetArgument(context, CMIPS::A1));
+	uint32 size = GetArgument(context, CMIPS::A2);
+	SetReturnValue(context, dstAddress);
+	ChargeCycles(context, size);
+	while(size != 0)
+	{
+		uint32 chunkSize = std::min<uint32>(size, GetPageRemainder(dstAddress));
+		if(auto dst = GetMemoryPointer(context, dstAddress))
+		{
+			memset(dst, value, chunkSize);
+		}
+		else
+		{
+			for(uint32 i = 0; i < chunkSize; i++)
+			{
+				MemoryUtils_SetByteProxy(context, value, dstAddress + i);
+			}
+		}
+		dstAddress += chunkSize;
+		size -= chunkSize;
+	}
+}
+
+static void Hle_strcpy(CMIPS* context)
+{
+	uint32 dstAddress = GetArgument(context, CMIPS::A0);
+	uint32 srcAddress = GetArgument(context, CMIPS::A1);
+	uint32 size = GetStringLength(context, srcAddress) + 1;
+	CopyMemory(context, dstAddress, srcAddress, size);
+	SetReturnValue(context, dstAddress);
+	ChargeCycles(context, size);
+}
+
+LibcHle::FunctionHandler LibcHle::GetFunctionHandler(const std::string& name)
+{
+	static const std::map<std::string, FunctionHandler> g_handlers =
+	    {
+	        {"memcpy", &Hle_memcpy},
+	        {"memset", &Hle_memset},
+	        {"strcpy", &Hle_strcpy},
+	    };
+	auto handlerIterator = g_handlers.find(name);
+	return (handlerIterator != std::end(g_handlers)) ? handlerIterator->second : nullptr;
+}
+
+LibcHle::FunctionMap LibcHle::FindFunctions(const CMipsFunctionPatternDb& patternDb, uint8* ram, uint32 minAddr, uint32 maxAddr)
+{
+	FunctionMap result;
+	for(const auto& pattern : patternDb.GetPatterns())
+	{
+		auto handler = GetFunctionHandler(pattern.name);
+		if(handler == nullptr) continue;
+		//Executables can contain more than one copy of the same routine (ie.: from different libraries)
+		for(uint32 address = minAddr; address < maxAddr; address += 4)
+		{
+			auto text = reinterpret_cast<uint32*>(ram + address);
+			if(pattern.Matches(text, maxAddr - address))
+			{
+				FUNCTION function;
+				function.pattern = pattern;
+				function.handler = handler;
+				result.insert(std::make_pair(address, std::move(function)));
+			}
+		}
+	}
+	return result;
+}
+
+bool LibcHle::IsFunctionAt(const FUNCTION& function, uint8* ram, uint32 ramSize, uint32 address)
+{
+	if(address >= ramSize) return false;
+	auto text = reinterpret_cast<uint32*>(ram + address);
+	return function.pattern.Matches(text, ramSize - address);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <map>
+#include <string>
+#include "Types.h"
+#include "../MipsFunctionPatternDb.h"
+
+class CMIPS;
+
+namespace Ee
+{
+	//Native replacements for libc routines statically linked in executables.
+	//Handlers take their arguments from the guest's registers, write the result in V0
+	//and charge the cycles the guest routine would have taken.
+	namespace LibcHle
+	{
+		typedef void (*FunctionHandler)(CMIPS*);
+
+		struct FUNCTION
+		{
+			//Kept to make sure the function is still there when its block is compiled
+			CMipsFunctionPatternDb::Pattern pattern;
+			FunctionHandler handler = nullptr;
+		};
+
+		//Key is the address of the function's first instruction
+		typedef std::map<uint32, FUNCTION> FunctionMap;
+
+		//Returns nullptr if no native replacement is available for this routine
+		FunctionHandler GetFunctionHandler(const std::string&);
+
+		FunctionMap FindFunctions(const CMipsFunctionPatternDb&, uint8*, uint32, uint32);
+		bool IsFunctionAt(const FUNCTION&, uint8*, uint32, uint32);
+	}
+}
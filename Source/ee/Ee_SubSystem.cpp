@@ -162,6 +162,8 @@ CSubSystem::CSubSystem(uint8* iopRam, CIopBios& iopBios)
 
 	m_os = new CPS2OS(m_EE, m_ram, m_bios, m_spr, m_gs, m_sif, iopBios);
 	m_OnRequestInstructionCacheFlushConnection = m_os->OnRequestInstructionCacheFlush.Connect(std::bind(&CSubSystem::FlushInstructionCache, this));
+	m_OnRequestClampingModeChangeConnection = m_os->OnRequestClampingModeChange.Connect(std::bind(&CSubSystem::SetClampingMode, this, std::placeholders::_1));
+	m_OnRequestLibcHleFunctionsChangeConnection = m_os->OnRequestLibcHleFunctionsChange.Connect(std::bind(&CSubSystem::SetLibcHleFunctions, this, std::placeholders::_1));
 
 	SetupEePageTable();
 }
@@ -193,7 +195,7 @@ void CSubSystem::SetVpu1(std::shared_ptr<CVpu> newVpu1)
 void CSubSystem::Reset(uint32 ramSize)
 {
 	m_os->Release();
-	m_EE.m_executor->Reset();
+	SetLibcHleFunctions(LibcHle::FunctionMap());
 
 	memset(m_ram, 0, PS2::EE_RAM_SIZE);
 	memset(m_spr, 0, PS2::EE_SPR_SIZE);
@@ -366,17 +368,30 @@ void CSubSystem::NotifyVBlankEnd()
 	m_intc.AssertLine(CINTC::INTC_LINE_VBLANK_END);
 }
 
-void CSubSystem::SaveState(Framework::CZipArchiveWriter& archive)
+StateMemoryRegionList CSubSystem::GetStateMemoryRegions() const
+{
+	return {
+	    {STATE_RAM, m_ram, PS2::EE_RAM_SIZE},
+	    {STATE_SPR, m_spr, PS2::EE_SPR_SIZE},
+	    {STATE_VUMEM0, m_vuMem0, PS2::VUMEM0SIZE},
+	    {STATE_MICROMEM0, m_microMem0, PS2::MICROMEM0SIZE},
+	    {STATE_VUMEM1, m_vuMem1, PS2::VUMEM1SIZE},
+	    {STATE_MICROMEM1, m_microMem1, PS2::MICROMEM1SIZE},
+	};
+}
+
+void CSubSystem::SaveState(Framework::CZipArchiveWriter& archive, bool saveMemoryRegions)
 {
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_EE, &m_EE.m_State, sizeof(MIPSSTATE)));
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_VU0, &m_VU0.m_State, sizeof(MIPSSTATE)));
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_VU1, &m_VU1.m_State, sizeof(MIPSSTATE)));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_RAM, m_ram, PS2::EE_RAM_SIZE));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_SPR, m_spr, PS2::EE_SPR_SIZE));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_VUMEM0, m_vuMem0, PS2::VUMEM0SIZE));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_MICROMEM0, m_microMem0, PS2::MICROMEM0SIZE));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_VUMEM1, m_vuMem1, PS2::VUMEM1SIZE));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_MICROMEM1, m_microMem1, PS2::MICROMEM1SIZE));
+	if(saveMemoryRegions)
+	{
+		for(const auto& region : GetStateMemoryRegions())
+		{
+			SaveStateMemoryRegion(archive, region);
+		}
+	}
 
 	m_dmac.SaveState(archive);
 	m_intc.SaveState(archive);
@@ -389,7 +404,7 @@ void CSubSystem::SaveState(Framework::CZipArchiveWriter& archive)
 	m_os->GetLibMc2().SaveState(archive);
 }
 
-void CSubSystem::LoadState(Framework::CZipArchiveReader& archive)
+void CSubSystem::LoadState(Framework::CZipArchiveReader& archive, const StateMemoryRegionSource& regionSource)
 {
 	m_EE.m_executor->ClearActiveBlocksInRange(0, PS2::EE_RAM_SIZE, false);
 	m_vpu0->GetContext().m_executor->ClearActiveBlocksInRange(0, PS2::MICROMEM0SIZE, false);
@@ -398,12 +413,10 @@ void CSubSystem::LoadState(Framework::CZipArchiveReader& archive)
 	archive.BeginReadFile(STATE_EE)->Read(&m_EE.m_State, sizeof(MIPSSTATE));
 	archive.BeginReadFile(STATE_VU0)->Read(&m_VU0.m_State, sizeof(MIPSSTATE));
 	archive.BeginReadFile(STATE_VU1)->Read(&m_VU1.m_State, sizeof(MIPSSTATE));
-	archive.BeginReadFile(STATE_RAM)->Read(m_ram, PS2::EE_RAM_SIZE);
-	archive.BeginReadFile(STATE_SPR)->Read(m_spr, PS2::EE_SPR_SIZE);
-	archive.BeginReadFile(STATE_VUMEM0)->Read(m_vuMem0, PS2::VUMEM0SIZE);
-	archive.BeginReadFile(STATE_MICROMEM0)->Read(m_microMem0, PS2::MICROMEM0SIZE);
-	archive.BeginReadFile(STATE_VUMEM1)->Read(m_vuMem1, PS2::VUMEM1SIZE);
-	archive.BeginReadFile(STATE_MICROMEM1)->Read(m_microMem1, PS2::MICROMEM1SIZE);
+	for(const auto& region : GetStateMemoryRegions())
+	{
+		LoadStateMemoryRegion(archive, region, regionSource);
+	}
 
 	m_dmac.LoadState(archive);
 	m_intc.LoadState(archive);
@@ -828,6 +841,26 @@ void CSubSystem::FlushInstructionCache()
 	m_EE.m_executor->Reset();
 }
 
+void CSubSystem::SetLibcHleFunctions(const LibcHle::FunctionMap& functions)
+{
+	//Also resets the executor
+	static_cast<CEeExecutor*>(m_EE.m_executor.get())->SetHleFunctions(functions);
+}
+
+void CSubSystem::SetClampingMode(FpUtils::CLAMPING_MODE clampingMode)
+{
+	if(m_EE.m_clampingMode == clampingMode) return;
+
+	m_EE.m_clampingMode = clampingMode;
+	m_VU0.m_clampingMode = clampingMode;
+	m_VU1.m_clampingMode = clampingMode;
+
+	//Active blocks were compiled using the previous mode
+	m_EE.m_executor->Reset();
+	m_VU0.m_executor->ClearActiveBlocksInRange(0, PS2::MICROMEM0SIZE, false);
+	m_VU1.m_executor->ClearActiveBlocksInRange(0, PS2::MICROMEM1SIZE, false);
+}
+
 void CSubSystem::LoadBIOS()
 {
 	auto biosPath = CAppConfig::GetInstance().GetBasePath() / "bios/scph10000.bin";
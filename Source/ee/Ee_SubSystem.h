@@ -16,6 +16,7 @@
 #include "COP_VU.h"
 #include "PS2OS.h"
 #include "../gs/GSHandler.h"
+#include "../states/StateMemoryRegion.h"
 
 #include "signal/Signal.h"
 
@@ -35,8 +36,9 @@ namespace Ee
 		void NotifyVBlankStart();
 		void NotifyVBlankEnd();
 
-		void SaveState(Framework::CZipArchiveWriter&);
-		void LoadState(Framework::CZipArchiveReader&);
+		StateMemoryRegionList GetStateMemoryRegions() const;
+		void SaveState(Framework::CZipArchiveWriter&, bool saveMemoryRegions = true);
+		void LoadState(Framework::CZipArchiveReader&, const StateMemoryRegionSource& = StateMemoryRegionSource());
 
 		void SetVpu0(std::shared_ptr<CVpu>);
 		void SetVpu1(std::shared_ptr<CVpu>);
@@ -106,6 +108,8 @@ namespace Ee
 		void CheckPendingInterrupts();
 
 		void FlushInstructionCache();
+		void SetClampingMode(FpUtils::CLAMPING_MODE);
+		void SetLibcHleFunctions(const LibcHle::FunctionMap&);
 
 		void LoadBIOS();
 		void FillFakeIopRam();
@@ -121,6 +125,8 @@ namespace Ee
 		CCOP_VU m_COP_VU;
 
 		Framework::CSignal<void()>::Connection m_OnRequestInstructionCacheFlushConnection;
+		Framework::CSignal<void(FpUtils::CLAMPING_MODE)>::Connection m_OnRequestClampingModeChangeConnection;
+		Framework::CSignal<void(const LibcHle::FunctionMap&)>::Connection m_OnRequestLibcHleFunctionsChangeConnection;
 		CVpu::VuStateChangedEvent::Connection m_vu0StateChangedConnection;
 		CVpu::VuInterruptTriggeredEvent::Connection m_vu1InterruptTriggeredConnection;
 	};
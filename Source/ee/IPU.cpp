@@ -12,6 +12,7 @@
 #include "IPU_MacroblockTypeBTable.h"
 #include "IPU_MotionCodeTable.h"
 #include "IPU_DmVectorTable.h"
+#include "IPU_VLCLookup.h"
 #include "mpeg2/DcSizeLuminanceTable.h"
 #include "mpeg2/DcSizeChrominanceTable.h"
 #include "mpeg2/DctCoefficientTable0.h"
@@ -99,6 +100,43 @@ static CVLCTable::DECODE_STATUS FilterSymbolError(CVLCTable::DECODE_STATUS resul
 	}
 }
 
+template <typename TableType>
+static const CVLCLookup& GetVLCLookup()
+{
+	static const CVLCLookup lookup(TableType::GetInstance());
+	return lookup;
+}
+
+static const CDctCoefficientLookup& GetDctCoefficientLookup(bool isTable1, bool isMpeg2)
+{
+	if(isTable1)
+	{
+		if(isMpeg2)
+		{
+			static const CDctCoefficientLookup lookup(&CDctCoefficientTable1::GetInstance(), true);
+			return lookup;
+		}
+		else
+		{
+			static const CDctCoefficientLookup lookup(&CDctCoefficientTable1::GetInstance(), false);
+			return lookup;
+		}
+	}
+	else
+	{
+		if(isMpeg2)
+		{
+			static const CDctCoefficientLookup lookup(&CDctCoefficientTable0::GetInstance(), true);
+			return lookup;
+		}
+		else
+		{
+			static const CDctCoefficientLookup lookup(&CDctCoefficientTable0::GetInstance(), false);
+			return lookup;
+		}
+	}
+}
+
 CIPU::CIPU(CINTC& intc)
     : m_intc(intc)
 {
@@ -1089,7 +1127,7 @@ bool CIPU::CIDECCommand::Execute()
 		break;
 		case STATE_READMBTYPE:
 		{
-			if(FilterSymbolError(CMacroblockTypeITable::GetInstance()->TryGetSymbol(m_IN_FIFO, m_mbType)) != CVLCTable::DECODE_STATUS_SUCCESS)
+			if(FilterSymbolError(GetVLCLookup<CMacroblockTypeITable>().TryGetSymbol(m_IN_FIFO, m_mbType)) != CVLCTable::DECODE_STATUS_SUCCESS)
 			{
 				return false;
 			}
@@ -1231,7 +1269,7 @@ bool CIPU::CIDECCommand::Execute()
 		case STATE_READMBINCREMENT:
 		{
 			uint32 mbIncrement = 0;
-			if(CMacroblockAddressIncrementTable::GetInstance()->TryGetSymbol(m_IN_FIFO, mbIncrement) != CVLCTable::DECODE_STATUS_SUCCESS)
+			if(GetVLCLookup<CMacroblockAddressIncrementTable>().TryGetSymbol(m_IN_FIFO, mbIncrement) != CVLCTable::DECODE_STATUS_SUCCESS)
 			{
 				return false;
 			}
@@ -1330,7 +1368,7 @@ bool CIPU::CBDECCommand::Execute()
 			if(!m_command.mbi)
 			{
 				//Not an Intra Macroblock, so we need to fetch the pattern code
-				m_codedBlockPattern = static_cast<uint8>(CCodedBlockPatternTable::GetInstance()->GetSymbol(m_IN_FIFO));
+				m_codedBlockPattern = static_cast<uint8>(GetVLCLookup<CCodedBlockPatternTable>().GetSymbol(m_IN_FIFO));
 			}
 			else
 			{
@@ -1488,10 +1526,12 @@ void CIPU::CBDECCommand_ReadDct::Initialize(CINFIFO* fifo, int16* block, unsigne
 	if(m_mbi && !m_isMpeg1CoeffVLCTable)
 	{
 		m_coeffTable = &CDctCoefficientTable1::GetInstance();
+		m_coeffLookup = &GetDctCoefficientLookup(true, m_isMpeg2);
 	}
 	else
 	{
 		m_coeffTable = &CDctCoefficientTable0::GetInstance();
+		m_coeffLookup = &GetDctCoefficientLookup(false, m_isMpeg2);
 	}
 }
 
@@ -1536,6 +1576,26 @@ bool CIPU::CBDECCommand_ReadDct::Execute()
 		break;
 		case STATE_CHECKEOB:
 		{
+			//Fast path: resolve end of block or the next coefficient with a single lookup
+			uint32 lookupBits = 0;
+			if(m_IN_FIFO->TryPeekBits_MSBF(CDctCoefficientLookup::LOOKUP_BITS, lookupBits))
+			{
+				const auto& entry = m_coeffLookup->GetEntry(lookupBits, m_blockIndex == 0);
+				if(entry.length != 0)
+				{
+					m_IN_FIFO->Advance(entry.length);
+					if(entry.run == CDctCoefficientLookup::RUN_EOB)
+					{
+#ifdef _DECODE_LOGGING
+						CLog::GetInstance().Print(DECODE_LOG_NAME, "\r\n");
+#endif
+						return true;
+					}
+					WriteCoefficient(entry.run, entry.level);
+					break;
+				}
+			}
+
 			bool isEob = false;
 			if(m_coeffTable->TryIsEndOfBlock(m_IN_FIFO, isEob) != CVLCTable::DECODE_STATUS_SUCCESS)
 			{
@@ -1568,21 +1628,7 @@ bool CIPU::CBDECCommand_ReadDct::Execute()
 					return false;
 				}
 			}
-			m_blockIndex += runLevelPair.run;
-
-			if(m_blockIndex < 0x40)
-			{
-				m_block[m_blockIndex] = static_cast<int16>(runLevelPair.level);
-#ifdef _DECODE_LOGGING
-				CLog::GetInstance().Print(DECODE_LOG_NAME, "[%d]: %d ", m_blockIndex, runLevelPair.level);
-#endif
-			}
-			else
-			{
-				throw CVLCTable::CVLCTableException();
-			}
-
-			m_blockIndex++;
+			WriteCoefficient(runLevelPair.run, static_cast<int16>(runLevelPair.level));
 			m_state = STATE_CHECKEOB;
 		}
 		break;
@@ -1600,6 +1646,25 @@ bool CIPU::CBDECCommand_ReadDct::Execute()
 	}
 }
 
+void CIPU::CBDECCommand_ReadDct::WriteCoefficient(unsigned int run, int16 level)
+{
+	m_blockIndex += run;
+
+	if(m_blockIndex < 0x40)
+	{
+		m_block[m_blockIndex] = level;
+#ifdef _DECODE_LOGGING
+		CLog::GetInstance().Print(DECODE_LOG_NAME, "[%d]: %d ", m_blockIndex, level);
+#endif
+	}
+	else
+	{
+		throw CVLCTable::CVLCTableException();
+	}
+
+	m_blockIndex++;
+}
+
 /////////////////////////////////////////////
 //BDEC ReadDcDiff subcommand implementation
 /////////////////////////////////////////////
@@ -1625,14 +1690,14 @@ bool CIPU::CBDECCommand_ReadDcDiff::Execute()
 			switch(m_channelId)
 			{
 			case 0:
-				if(CDcSizeLuminanceTable::GetInstance()->TryGetSymbol(m_IN_FIFO, dcSize) != CVLCTable::DECODE_STATUS_SUCCESS)
+				if(GetVLCLookup<CDcSizeLuminanceTable>().TryGetSymbol(m_IN_FIFO, dcSize) != CVLCTable::DECODE_STATUS_SUCCESS)
 				{
 					return false;
 				}
 				break;
 			case 1:
 			case 2:
-				if(CDcSizeChrominanceTable::GetInstance()->TryGetSymbol(m_IN_FIFO, dcSize) != CVLCTable::DECODE_STATUS_SUCCESS)
+				if(GetVLCLookup<CDcSizeChrominanceTable>().TryGetSymbol(m_IN_FIFO, dcSize) != CVLCTable::DECODE_STATUS_SUCCESS)
 				{
 					return false;
 				}
@@ -1693,6 +1758,7 @@ void CIPU::CVDECCommand::Initialize(CINFIFO* fifo, uint32 commandCode, uint32 pi
 	case 0:
 		//Macroblock Address Increment
 		m_table = CMacroblockAddressIncrementTable::GetInstance();
+		m_lookup = &GetVLCLookup<CMacroblockAddressIncrementTable>();
 		break;
 	case 1:
 		//Macroblock Type
@@ -1701,14 +1767,17 @@ void CIPU::CVDECCommand::Initialize(CINFIFO* fifo, uint32 commandCode, uint32 pi
 		case 1:
 			//I Picture
 			m_table = CMacroblockTypeITable::GetInstance();
+			m_lookup = &GetVLCLookup<CMacroblockTypeITable>();
 			break;
 		case 2:
 			//P Picture
 			m_table = CMacroblockTypePTable::GetInstance();
+			m_lookup = &GetVLCLookup<CMacroblockTypePTable>();
 			break;
 		case 3:
 			//B Picture
 			m_table = CMacroblockTypeBTable::GetInstance();
+			m_lookup = &GetVLCLookup<CMacroblockTypeBTable>();
 			break;
 		default:
 			assert(0);
@@ -1718,9 +1787,11 @@ void CIPU::CVDECCommand::Initialize(CINFIFO* fifo, uint32 commandCode, uint32 pi
 		break;
 	case 2:
 		m_table = CMotionCodeTable::GetInstance();
+		m_lookup = &GetVLCLookup<CMotionCodeTable>();
 		break;
 	case 3:
 		m_table = CDmVectorTable::GetInstance();
+		m_lookup = &GetVLCLookup<CDmVectorTable>();
 		break;
 	default:
 		assert(0);
@@ -1743,7 +1814,7 @@ bool CIPU::CVDECCommand::Execute()
 		break;
 		case STATE_DECODE:
 		{
-			(*m_result) = m_table->GetSymbol(m_IN_FIFO);
+			(*m_result) = m_lookup->GetSymbol(m_IN_FIFO);
 			m_state = STATE_DONE;
 		}
 		break;
@@ -8,6 +8,7 @@
 #include "MemStream.h"
 #include "mpeg2/VLCTable.h"
 #include "mpeg2/DctCoefficientTable.h"
+#include "IPU_VLCLookup.h"
 #include "../MailBox.h"
 #include "Convertible.h"
 #include "zip/ZipArchiveWriter.h"
@@ -312,6 +313,8 @@ private:
 		bool Execute() override;
 
 	private:
+		void WriteCoefficient(unsigned int run, int16 level);
+
 		enum STATE
 		{
 			STATE_INIT,
@@ -330,6 +333,7 @@ private:
 		bool m_isMpeg2 = true;
 		unsigned int m_blockIndex = 0;
 		MPEG2::CDctCoefficientTable* m_coeffTable = nullptr;
+		const IPU::CDctCoefficientLookup* m_coeffLookup = nullptr;
 		int16* m_dcPredictor = nullptr;
 		int16 m_dcDiff = 0;
 		CBDECCommand_ReadDcDiff m_readDcDiffCommand;
@@ -402,6 +406,7 @@ private:
 		CINFIFO* m_IN_FIFO = nullptr;
 		STATE m_state = STATE_ADVANCE;
 		MPEG2::CVLCTable* m_table = nullptr;
+		const IPU::CVLCLookup* m_lookup = nullptr;
 	};
 
 	//0x04 ------------------------------------------------------------
@@ -0,0 +1,168 @@
+#include <cassert>
+#include "IPU_VLCLookup.h"
+
+using namespace IPU;
+using namespace MPEG2;
+
+//Bit stream used to run the VLC tables against every possible lookup value
+class CLookupProbeBitStream : public Framework::CBitStream
+{
+public:
+	CLookupProbeBitStream(uint32 bits, unsigned int bitCount)
+	    : m_bits(bits << (32 - bitCount))
+	{
+	}
+
+	void Advance(uint8 bits) override
+	{
+		m_position += bits;
+	}
+
+	uint8 GetBitIndex() const override
+	{
+		return static_cast<uint8>(m_position);
+	}
+
+	bool TryPeekBits_LSBF(uint8, uint32&) override
+	{
+		return false;
+	}
+
+	bool TryPeekBits_MSBF(uint8 size, uint32& result) override
+	{
+		assert(size != 0);
+		assert(size <= 32);
+		if((m_position + size) > 32)
+		{
+			return false;
+		}
+		uint64 bits = static_cast<uint64>(m_bits) << m_position;
+		result = static_cast<uint32>((bits & 0xFFFFFFFFULL) >> (32 - size));
+		return true;
+	}
+
+private:
+	uint32 m_bits = 0;
+	unsigned int m_position = 0;
+};
+
+CVLCLookup::CVLCLookup(CVLCTable* table)
+    : m_table(table)
+{
+	for(uint32 i = 0; i < m_entries.size(); i++)
+	{
+		CLookupProbeBitStream stream(i, LOOKUP_BITS);
+		uint32 value = 0;
+		try
+		{
+			if(m_table->TryGetSymbol(&stream, value) != CVLCTable::DECODE_STATUS_SUCCESS) continue;
+		}
+		catch(...)
+		{
+			//Invalid code, let the table report the error when decoding
+			continue;
+		}
+		unsigned int length = stream.GetBitIndex();
+		if((length == 0) || (length > LOOKUP_BITS)) continue;
+		auto& entry = m_entries[i];
+		entry.value = value;
+		entry.length = static_cast<uint8>(length);
+	}
+}
+
+CVLCTable::DECODE_STATUS CVLCLookup::TryGetSymbol(Framework::CBitStream* stream, uint32& result) const
+{
+	uint32 lookupBits = 0;
+	if(stream->TryPeekBits_MSBF(LOOKUP_BITS, lookupBits))
+	{
+		const auto& entry = m_entries[lookupBits];
+		if(entry.length != 0)
+		{
+			stream->Advance(entry.length);
+			result = entry.value;
+			return CVLCTable::DECODE_STATUS_SUCCESS;
+		}
+	}
+	return m_table->TryGetSymbol(stream, result);
+}
+
+uint32 CVLCLookup::GetSymbol(Framework::CBitStream* stream) const
+{
+	uint32 lookupBits = 0;
+	if(stream->TryPeekBits_MSBF(LOOKUP_BITS, lookupBits))
+	{
+		const auto& entry = m_entries[lookupBits];
+		if(entry.length != 0)
+		{
+			stream->Advance(entry.length);
+			return entry.value;
+		}
+	}
+	return m_table->GetSymbol(stream);
+}
+
+CDctCoefficientLookup::CDctCoefficientLookup(CDctCoefficientTable* table, bool isMpeg2)
+{
+	for(uint32 i = 0; i < m_entries.size(); i++)
+	{
+		m_firstEntries[i] = ProbeFirstEntry(table, i, isMpeg2);
+		m_entries[i] = ProbeEntry(table, i, isMpeg2);
+	}
+}
+
+CDctCoefficientLookup::ENTRY CDctCoefficientLookup::ProbeFirstEntry(CDctCoefficientTable* table, uint32 bits, bool isMpeg2)
+{
+	ENTRY entry;
+	CLookupProbeBitStream stream(bits, LOOKUP_BITS);
+	RUNLEVELPAIR runLevelPair;
+	try
+	{
+		if(table->TryGetRunLevelPairDc(&stream, &runLevelPair, isMpeg2) != CVLCTable::DECODE_STATUS_SUCCESS) return entry;
+	}
+	catch(...)
+	{
+		//Invalid code, let the table report the error when decoding
+		return entry;
+	}
+	unsigned int length = stream.GetBitIndex();
+	if((length == 0) || (length > LOOKUP_BITS)) return entry;
+	entry.run = static_cast<uint8>(runLevelPair.run);
+	entry.level = static_cast<int16>(runLevelPair.level);
+	entry.length = static_cast<uint8>(length);
+	return entry;
+}
+
+CDctCoefficientLookup::ENTRY CDctCoefficientLookup::ProbeEntry(CDctCoefficientTable* table, uint32 bits, bool isMpeg2)
+{
+	ENTRY entry;
+	CLookupProbeBitStream stream(bits, LOOKUP_BITS);
+	try
+	{
+		bool isEob = false;
+		{
+			CLookupProbeBitStream eobStream(bits, LOOKUP_BITS);
+			if(table->TryIsEndOfBlock(&eobStream, isEob) != CVLCTable::DECODE_STATUS_SUCCESS) return entry;
+		}
+		if(isEob)
+		{
+			if(table->TrySkipEndOfBlock(&stream) != CVLCTable::DECODE_STATUS_SUCCESS) return entry;
+			entry.run = RUN_EOB;
+		}
+		else
+		{
+			RUNLEVELPAIR runLevelPair;
+			if(table->TryGetRunLevelPair(&stream, &runLevelPair, isMpeg2) != CVLCTable::DECODE_STATUS_SUCCESS) return entry;
+			entry.run = static_cast<uint8>(runLevelPair.run);
+			entry.level = static_cast<int16>(runLevelPair.level);
+		}
+	}
+	catch(...)
+	{
+		//Invalid code, let the table report the error when decoding
+		return ENTRY();
+	}
+	unsigned int length = stream.GetBitIndex();
+	if((length == 0) || (length > LOOKUP_BITS)) return ENTRY();
+	entry.length = static_cast<uint8>(length);
+	return entry;
+}
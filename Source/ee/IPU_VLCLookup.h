@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include "Types.h"
+#include "BitStream.h"
+#include "mpeg2/VLCTable.h"
+#include "mpeg2/DctCoefficientTable.h"
+
+namespace IPU
+{
+	//Flat lookup tables built from the VLC tables. Peeks LOOKUP_BITS at once and resolves
+	//most symbols in a single table hit. Symbols that are longer than LOOKUP_BITS, escape codes
+	//or invalid codes are left unresolved and go through the original table.
+
+	class CVLCLookup
+	{
+	public:
+		enum LOOKUP_BITS
+		{
+			LOOKUP_BITS = 11,
+		};
+
+		CVLCLookup(MPEG2::CVLCTable*);
+
+		MPEG2::CVLCTable::DECODE_STATUS TryGetSymbol(Framework::CBitStream*, uint32&) const;
+		uint32 GetSymbol(Framework::CBitStream*) const;
+
+	private:
+		struct ENTRY
+		{
+			uint32 value = 0;
+			uint8 length = 0;
+		};
+
+		MPEG2::CVLCTable* m_table = nullptr;
+		std::array<ENTRY, (1 << LOOKUP_BITS)> m_entries;
+	};
+
+	class CDctCoefficientLookup
+	{
+	public:
+		enum LOOKUP_BITS
+		{
+			LOOKUP_BITS = 12,
+		};
+
+		enum
+		{
+			RUN_EOB = 0xFF,
+		};
+
+		struct ENTRY
+		{
+			int16 level = 0;
+			uint8 run = 0;
+			uint8 length = 0;
+		};
+
+		CDctCoefficientLookup(MPEG2::CDctCoefficientTable*, bool isMpeg2);
+
+		//Entry has a non-zero length if it was resolved by the lookup.
+		//When not reading the first coefficient, run is RUN_EOB if the bits match the end of block code.
+		const ENTRY& GetEntry(uint32 bits, bool isFirstCoeff) const
+		{
+			return isFirstCoeff ? m_firstEntries[bits] : m_entries[bits];
+		}
+
+	private:
+		typedef std::array<ENTRY, (1 << LOOKUP_BITS)> EntryArray;
+
+		static ENTRY ProbeFirstEntry(MPEG2::CDctCoefficientTable*, uint32, bool);
+		static ENTRY ProbeEntry(MPEG2::CDctCoefficientTable*, uint32, bool);
+
+		EntryArray m_firstEntries;
+		EntryArray m_entries;
+	};
+}
@@ -61,6 +61,7 @@
 #define SEMA_ID_BASE 0
 
 #define PATCHESFILENAME "patches.xml"
+#define FUNCTIONPATTERNSFILENAME "ee_functions.xml"
 #define LOG_NAME ("ps2os")
 
 #define SYSCALL_CUSTOM_RESCHEDULE 0x666
@@ -240,6 +241,7 @@ CPS2OS::CPS2OS(CMIPS& ee, uint8* ram, uint8* bios, uint8* spr, CGSHandler*& gs,
 	static_assert((BIOS_ADDRESS_SEMAPHORE_BASE + (sizeof(SEMAPHORE) * MAX_SEMAPHORE)) <= BIOS_ADDRESS_CUSTOMSYSCALL_BASE, "Semaphore overflow");
 
 	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_SYSTEM_LANGUAGE, static_cast<uint32>(OSD_LANGUAGE::JAPANESE));
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_EE_LIBCHLE_ENABLED, true);
 }
 
 CPS2OS::~CPS2OS()
@@ -435,6 +437,7 @@ void CPS2OS::LoadELF(Framework::CStream* stream, const char* executablePath, con
 
 	LoadExecutableInternal();
 	ApplyPatches();
+	FindLibcFunctions();
 
 	OnExecutableChange();
 
@@ -569,6 +572,10 @@ uint32 CPS2OS::LoadExecutable(const char* path, const char* section)
 
 void CPS2OS::ApplyPatches()
 {
+	//Executable can override the float clamping mode, restore the default one before looking at patches
+	OnRequestClampingModeChange(FpUtils::CLAMPING_MODE_FULL);
+	m_libcHleAllowed = true;
+
 	std::unique_ptr<Framework::Xml::CNode> document;
 	try
 	{
@@ -603,6 +610,27 @@ void CPS2OS::ApplyPatches()
 		if(!strcmp(name, GetExecutableName()))
 		{
 			//Found the right executable
+			if(const char* clampingModeString = executableNode->GetAttribute("FloatClampingMode"))
+			{
+				if(!strcmp(clampingModeString, "none"))
+				{
+					OnRequestClampingModeChange(FpUtils::CLAMPING_MODE_NONE);
+				}
+				else if(!strcmp(clampingModeString, "result"))
+				{
+					OnRequestClampingModeChange(FpUtils::CLAMPING_MODE_RESULT);
+				}
+				else if(strcmp(clampingModeString, "full"))
+				{
+					CLog::GetInstance().Warn(LOG_NAME, "Unknown float clamping mode '%s'.\r\n", clampingModeString);
+				}
+			}
+
+			if(const char* libcHleString = executableNode->GetAttribute("LibcHle"))
+			{
+				m_libcHleAllowed = strcmp(libcHleString, "false") != 0;
+			}
+
 			unsigned int patchCount = 0;
 
 			for(Framework::Xml::CFilteringNodeIterator itNode(executableNode, "Patch"); !itNode.IsEnd(); itNode++)
@@ -631,6 +659,46 @@ void CPS2OS::ApplyPatches()
 	}
 }
 
+void CPS2OS::FindLibcFunctions()
+{
+	Ee::LibcHle::FunctionMap functions;
+
+	if(m_libcHleAllowed && CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_EE_LIBCHLE_ENABLED))
+	{
+		std::unique_ptr<Framework::Xml::CNode> document;
+		try
+		{
+#ifdef __ANDROID__
+			Framework::Android::CAssetStream patternsStream(FUNCTIONPATTERNSFILENAME);
+#else
+			auto patternsPath = Framework::PathUtils::GetAppResourcesPath() / FUNCTIONPATTERNSFILENAME;
+			Framework::CStdStream patternsStream(Framework::CreateInputStdStream(patternsPath.native()));
+#endif
+			document = Framework::Xml::CParser::ParseDocument(patternsStream);
+		}
+		catch(const std::exception& exception)
+		{
+			CLog::GetInstance().Print(LOG_NAME, "Failed to open function pattern file: %s.\r\n", exception.what());
+		}
+
+		if(document)
+		{
+			if(auto functionsNode = document->Select("Functions"))
+			{
+				auto executableRange = GetExecutableRange();
+				uint32 minAddr = executableRange.first;
+				uint32 maxAddr = executableRange.second & ~0x03;
+
+				CMipsFunctionPatternDb patternDb(functionsNode);
+				functions = Ee::LibcHle::FindFunctions(patternDb, m_ram, minAddr, maxAddr);
+				CLog::GetInstance().Print(LOG_NAME, "Found %d libc function(s) with native implementations.\r\n", static_cast<uint32>(functions.size()));
+			}
+		}
+	}
+
+	OnRequestLibcHleFunctionsChange(functions);
+}
+
 void CPS2OS::AssembleCustomSyscallHandler()
 {
 	CMIPSAssembler assembler((uint32*)&m_bios[0x100]);
@@ -14,6 +14,7 @@
 #include "SIF.h"
 #include "Ee_IdleEvaluator.h"
 #include "Ee_LibMc2.h"
+#include "Ee_LibcHle.h"
 
 #define INTERRUPTS_ENABLED_MASK (CMIPS::STATUS_IE | CMIPS::STATUS_EIE)
 
@@ -70,6 +71,8 @@ public:
 	Framework::CSignal<void()> OnExecutableChange;
 	Framework::CSignal<void()> OnExecutableUnloading;
 	Framework::CSignal<void()> OnRequestInstructionCacheFlush;
+	Framework::CSignal<void(FpUtils::CLAMPING_MODE)> OnRequestClampingModeChange;
+	Framework::CSignal<void(const Ee::LibcHle::FunctionMap&)> OnRequestLibcHleFunctionsChange;
 	RequestLoadExecutableEvent OnRequestLoadExecutable;
 	Framework::CSignal<void()> OnRequestExit;
 	Framework::CSignal<void()> OnCrtModeChange;
@@ -343,6 +346,7 @@ private:
 	void UnloadExecutable();
 
 	void ApplyPatches();
+	void FindLibcFunctions();
 
 	void DisassembleSysCall(uint8);
 	std::string GetSysCallDescription(uint8);
@@ -475,6 +479,9 @@ private:
 	//For display purposes only
 	std::string m_executableName;
 
+	//Cleared by executables that don't work with native libc routines
+	bool m_libcHleAllowed = true;
+
 	Ee::CIdleEvaluator m_idleEvaluator;
 
 #ifdef DEBUGGER_INCLUDED
@@ -362,7 +362,7 @@ void VUShared::SetStatus(CMipsJitter* codeGen, size_t srcOffset)
 void VUShared::ADD_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs, size_t ft, bool expand, uint32 relativePipeTime, uint32 compileHints)
 {
 	codeGen->MD_PushRel(fs);
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	if(expand)
 	{
 		codeGen->MD_PushRelExpand(ft);
@@ -372,6 +372,7 @@ void VUShared::ADD_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 		codeGen->MD_PushRel(ft);
 	}
 	codeGen->MD_AddS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, fd);
 	TestSZFlags(codeGen, dest, fd, relativePipeTime, compileHints);
 }
@@ -388,6 +389,7 @@ void VUShared::ADDA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft,
 		codeGen->MD_PushRel(ft);
 	}
 	codeGen->MD_AddS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A));
 	TestSZFlags(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A), relativePipeTime, compileHints);
 }
@@ -397,11 +399,11 @@ void VUShared::MADD_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 	codeGen->MD_PushRel(offsetof(CMIPS, m_State.nCOP2A));
 	codeGen->MD_PushRel(fs);
 	//Clamping is needed by Baldur's Gate Deadly Alliance here because it multiplies junk values (potentially NaN/INF) by 0
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	if(expand)
 	{
 		codeGen->MD_PushRelExpand(ft);
-		codeGen->MD_ClampS(); //Fatal Frame 1's door-blocking bug can be fixed by this
+		codeGen->MD_ClampOperandS(); //Fatal Frame 1's door-blocking bug can be fixed by this
 	}
 	else
 	{
@@ -409,6 +411,7 @@ void VUShared::MADD_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 	}
 	codeGen->MD_MulS();
 	codeGen->MD_AddS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, fd);
 	TestSZFlags(codeGen, dest, fd, relativePipeTime, compileHints);
 }
@@ -418,7 +421,7 @@ void VUShared::MADDA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft
 	codeGen->MD_PushRel(offsetof(CMIPS, m_State.nCOP2A));
 	codeGen->MD_PushRel(fs);
 	//Clamping is needed by Dynasty Warriors 2 here because it multiplies junk values (potentially NaN/INF) by some other value
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	if(expand)
 	{
 		codeGen->MD_PushRelExpand(ft);
@@ -427,9 +430,10 @@ void VUShared::MADDA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft
 	{
 		codeGen->MD_PushRel(ft);
 	}
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	codeGen->MD_MulS();
 	codeGen->MD_AddS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A));
 	TestSZFlags(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A), relativePipeTime, compileHints);
 }
@@ -437,7 +441,7 @@ void VUShared::MADDA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft
 void VUShared::SUB_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs, size_t ft, bool expand, uint32 relativePipeTime, uint32 compileHints)
 {
 	codeGen->MD_PushRel(fs);
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	if(expand)
 	{
 		codeGen->MD_PushRelExpand(ft);
@@ -446,8 +450,9 @@ void VUShared::SUB_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 	{
 		codeGen->MD_PushRel(ft);
 	}
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	codeGen->MD_SubS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, fd);
 	TestSZFlags(codeGen, dest, fd, relativePipeTime, compileHints);
 }
@@ -464,6 +469,7 @@ void VUShared::SUBA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft,
 		codeGen->MD_PushRel(ft);
 	}
 	codeGen->MD_SubS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A));
 	TestSZFlags(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A), relativePipeTime, compileHints);
 }
@@ -482,6 +488,7 @@ void VUShared::MSUB_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 	}
 	codeGen->MD_MulS();
 	codeGen->MD_SubS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, fd);
 	TestSZFlags(codeGen, dest, fd, relativePipeTime, compileHints);
 }
@@ -500,6 +507,7 @@ void VUShared::MSUBA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft
 	}
 	codeGen->MD_MulS();
 	codeGen->MD_SubS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A));
 	TestSZFlags(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A), relativePipeTime, compileHints);
 }
@@ -507,7 +515,7 @@ void VUShared::MSUBA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft
 void VUShared::MUL_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs, size_t ft, bool expand, uint32 relativePipeTime, uint32 compileHints)
 {
 	codeGen->MD_PushRel(fs);
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	if(expand)
 	{
 		codeGen->MD_PushRelExpand(ft);
@@ -516,8 +524,9 @@ void VUShared::MUL_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 	{
 		codeGen->MD_PushRel(ft);
 	}
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	codeGen->MD_MulS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, fd);
 	TestSZFlags(codeGen, dest, fd, relativePipeTime, compileHints);
 }
@@ -525,7 +534,7 @@ void VUShared::MUL_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 void VUShared::MULA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft, bool expand, uint32 relativePipeTime, uint32 compileHints)
 {
 	codeGen->MD_PushRel(fs);
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	if(expand)
 	{
 		codeGen->MD_PushRelExpand(ft);
@@ -535,6 +544,7 @@ void VUShared::MULA_base(CMipsJitter* codeGen, uint8 dest, size_t fs, size_t ft,
 		codeGen->MD_PushRel(ft);
 	}
 	codeGen->MD_MulS();
+	codeGen->MD_ClampResultS();
 	PullVector(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A));
 	TestSZFlags(codeGen, dest, offsetof(CMIPS, m_State.nCOP2A), relativePipeTime, compileHints);
 }
@@ -553,9 +563,9 @@ void VUShared::MINI_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 	};
 
 	codeGen->MD_PushRel(fs);
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	pushFt();
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 
 	codeGen->MD_CmpLtS();
 	auto cmp = codeGen->GetTopCursor();
@@ -591,9 +601,9 @@ void VUShared::MAX_base(CMipsJitter* codeGen, uint8 dest, size_t fd, size_t fs,
 	};
 
 	codeGen->MD_PushRel(fs);
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 	pushFt();
-	codeGen->MD_ClampS();
+	codeGen->MD_ClampOperandS();
 
 	codeGen->MD_CmpGtS();
 	auto cmp = codeGen->GetTopCursor();
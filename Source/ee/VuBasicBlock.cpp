@@ -1,3 +1,4 @@
+#include <algorithm>
 #include "VuBasicBlock.h"
 #include "MA_VU.h"
 #include "offsetof_def.h"
@@ -7,6 +8,15 @@
 CVuBasicBlock::CVuBasicBlock(CMIPS& context, uint32 begin, uint32 end, BLOCK_CATEGORY category)
     : CBasicBlock(context, begin, end, category)
 {
+	auto successorAddresses = GetSuccessorAddresses();
+	m_trailingMacFlagsOverwritten =
+	    !successorAddresses.empty() &&
+	    std::all_of(successorAddresses.begin(), successorAddresses.end(),
+	                [this](uint32 address) { return AreMacFlagsOverwrittenAt(address); });
+	if(m_trailingMacFlagsOverwritten)
+	{
+		m_successorAddresses = std::move(successorAddresses);
+	}
 }
 
 bool CVuBasicBlock::IsLinkable() const
@@ -14,6 +24,24 @@ bool CVuBasicBlock::IsLinkable() const
 	return m_isLinkable;
 }
 
+bool CVuBasicBlock::AreTrailingMacFlagsOverwritten() const
+{
+	return m_trailingMacFlagsOverwritten;
+}
+
+bool CVuBasicBlock::HasSuccessorDependencyInRange(uint32 start, uint32 end) const
+{
+	for(const auto& successorAddress : m_successorAddresses)
+	{
+		uint32 scanEnd = successorAddress + SUCCESSOR_SCAN_SIZE - 4;
+		if((successorAddress <= end) && (start <= scanEnd))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
 void CVuBasicBlock::CompileRange(CMipsJitter* jitter)
 {
 	CompileProlog(jitter);
@@ -451,6 +479,114 @@ bool CVuBasicBlock::IsNonConditionalBranch(uint32 opcodeLo)
 	return (id == 0x20);
 }
 
+bool CVuBasicBlock::IsStatusFlagRead(uint32 opcodeLo)
+{
+	//FSAND and FSOR compute the STATUS flag from the MAC flags pipeline
+	uint32 id = (opcodeLo >> 25) & 0x7F;
+	return (id == 0x16) || (id == 0x17);
+}
+
+std::vector<uint32> CVuBasicBlock::GetSuccessorAddresses() const
+{
+	//Returns an empty list if we can't know for sure where execution will continue
+	auto arch = m_context.m_pArch;
+
+	for(uint32 address = m_begin; address <= m_end; address += 8)
+	{
+		uint32 opcodeHi = m_context.m_pMemoryMap->GetInstruction(address + 4);
+		if(opcodeHi & (VUShared::VU_UPPEROP_BIT_E | VUShared::VU_UPPEROP_BIT_D | VUShared::VU_UPPEROP_BIT_T))
+		{
+			return std::vector<uint32>();
+		}
+	}
+
+	uint32 lastOpcodeLo = m_context.m_pMemoryMap->GetInstruction(m_end - 4);
+	if(arch->IsInstructionBranch(&m_context, m_end - 4, lastOpcodeLo) != MIPS_BRANCH_NONE)
+	{
+		//Branch in delay slot
+		return std::vector<uint32>();
+	}
+
+	if((m_end - m_begin) >= 0xC)
+	{
+		uint32 branchOpcodeAddr = m_end - 0xC;
+		uint32 branchOpcodeLo = m_context.m_pMemoryMap->GetInstruction(branchOpcodeAddr);
+		auto branchType = arch->IsInstructionBranch(&m_context, branchOpcodeAddr, branchOpcodeLo);
+		if(branchType != MIPS_BRANCH_NONE)
+		{
+			uint32 branchTgtAddress = arch->GetInstructionEffectiveAddress(&m_context, branchOpcodeAddr, branchOpcodeLo);
+			if((branchType != MIPS_BRANCH_NORMAL) || (branchTgtAddress == MIPS_INVALID_PC))
+			{
+				return std::vector<uint32>();
+			}
+			std::vector<uint32> result = {branchTgtAddress};
+			if(IsConditionalBranch(branchOpcodeLo))
+			{
+				result.push_back(m_end + 4);
+			}
+			return result;
+		}
+	}
+
+	return {m_end + 4};
+}
+
+bool CVuBasicBlock::AreMacFlagsOverwrittenAt(uint32 address) const
+{
+	//Checks if code starting at address replaces the MAC flags before they can be observed.
+	//Ignores stalls since they can only delay reads further after a write.
+	auto arch = static_cast<CMA_VU*>(m_context.m_pArch);
+
+	bool hasWrite = false;
+	uint32 writeIndex = 0;
+	for(uint32 instructionIndex = 0; instructionIndex < (SUCCESSOR_SCAN_SIZE / 8); instructionIndex++)
+	{
+		if(hasWrite && (instructionIndex >= (writeIndex + VUShared::LATENCY_MAC)))
+		{
+			return true;
+		}
+
+		uint32 addressLo = address + (instructionIndex * 8);
+		uint32 addressHi = addressLo + 4;
+
+		if(
+		    (m_context.m_pMemoryMap->GetInstructionMap(addressLo) == nullptr) ||
+		    (m_context.m_pMemoryMap->GetInstructionMap(addressHi) == nullptr))
+		{
+			return false;
+		}
+
+		uint32 opcodeLo = m_context.m_pMemoryMap->GetInstruction(addressLo);
+		uint32 opcodeHi = m_context.m_pMemoryMap->GetInstruction(addressHi);
+
+		auto loOps = arch->GetAffectedOperands(&m_context, addressLo, opcodeLo);
+		auto hiOps = arch->GetAffectedOperands(&m_context, addressHi, opcodeHi);
+
+		if(loOps.readMACflags || IsStatusFlagRead(opcodeLo))
+		{
+			return false;
+		}
+
+		//Leaving the successor block before the write was visible
+		if(opcodeHi & (VUShared::VU_UPPEROP_BIT_E | VUShared::VU_UPPEROP_BIT_D | VUShared::VU_UPPEROP_BIT_T))
+		{
+			return false;
+		}
+		if(arch->IsInstructionBranch(&m_context, addressLo, opcodeLo) != MIPS_BRANCH_NONE)
+		{
+			return false;
+		}
+
+		if(hiOps.writeMACflags && !hasWrite)
+		{
+			hasWrite = true;
+			writeIndex = instructionIndex;
+		}
+	}
+
+	return false;
+}
+
 CVuBasicBlock::INTEGER_BRANCH_DELAY_INFO CVuBasicBlock::ComputeTrailingIntegerBranchDelayInfo(const std::vector<uint32>& fmacStallDelays) const
 {
 	// Test if a block ends with an integer altering instruction.
@@ -629,13 +765,17 @@ void CVuBasicBlock::ComputeSkipFlagsHints(const std::vector<uint32>& fmacStallDe
 		relativePipeTime++;
 	}
 
-	//Simulate usage from outside our block
-	for(uint32 relativePipeTime = maxPipeTime; relativePipeTime < extendedMaxPipeTime; relativePipeTime++)
+	//Simulate usage from outside our block, unless every block that can follow replaces
+	//the MAC flags before reading them
+	if(!m_trailingMacFlagsOverwritten)
 	{
-		uint32 pipeTimeForResult = flagsResults[relativePipeTime];
-		if(pipeTimeForResult != g_undefinedMACflagsResult)
+		for(uint32 relativePipeTime = maxPipeTime; relativePipeTime < extendedMaxPipeTime; relativePipeTime++)
 		{
-			resultUsed[pipeTimeForResult] = true;
+			uint32 pipeTimeForResult = flagsResults[relativePipeTime];
+			if(pipeTimeForResult != g_undefinedMACflagsResult)
+			{
+				resultUsed[pipeTimeForResult] = true;
+			}
 		}
 	}
 
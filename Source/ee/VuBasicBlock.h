@@ -10,10 +10,22 @@ public:
 
 	bool IsLinkable() const;
 
+	//True if all blocks that can follow this one overwrite the MAC flags before reading them
+	bool AreTrailingMacFlagsOverwritten() const;
+
+	//True if this block was compiled with assumptions on code located in that range
+	bool HasSuccessorDependencyInRange(uint32, uint32) const;
+
 protected:
 	void CompileRange(CMipsJitter*) override;
 
 private:
+	enum
+	{
+		//Amount of code inspected at the start of a successor block
+		SUCCESSOR_SCAN_SIZE = 0x40,
+	};
+
 	struct INTEGER_BRANCH_DELAY_INFO
 	{
 		unsigned int regIndex = 0;
@@ -23,6 +35,10 @@ private:
 
 	static bool IsConditionalBranch(uint32);
 	static bool IsNonConditionalBranch(uint32);
+	static bool IsStatusFlagRead(uint32);
+
+	std::vector<uint32> GetSuccessorAddresses() const;
+	bool AreMacFlagsOverwrittenAt(uint32) const;
 
 	typedef uint32 FmacRegWriteTimes[32][4];
 	struct BlockFmacPipelineInfo
@@ -45,4 +61,6 @@ private:
 	static void EmitXgKick(CMipsJitter*);
 
 	bool m_isLinkable = true;
+	bool m_trailingMacFlagsOverwritten = false;
+	std::vector<uint32> m_successorAddresses;
 };
@@ -28,7 +28,10 @@ BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end
 	uint128 hash;
 	memcpy(&hash, &xxHash, sizeof(xxHash));
 	static_assert(sizeof(hash) == sizeof(xxHash));
-	auto blockKey = std::make_pair(hash, blockSizeByte);
+
+	//Analysis of the blocks following this one have an impact on the generated code
+	auto result = std::make_shared<CVuBasicBlock>(context, begin, end, m_blockCategory);
+	auto blockKey = std::make_tuple(hash, blockSizeByte, result->AreTrailingMacFlagsOverwritten(), m_context.m_clampingMode);
 
 	//Don't use the cached blocks of we have a breakpoint in our block range.
 	bool hasBreakpoint = m_context.HasBreakpointInRange(begin, end);
@@ -48,23 +51,54 @@ BasicBlockPtr CVuExecutor::BlockFactory(CMIPS& context, uint32 begin, uint32 end
 		//Check if we have a block that has the same contents but not the same range. Reuse the code of that block if that's the case.
 		if(beginBlockIterator != endBlockIterator)
 		{
-			auto result = std::make_shared<CVuBasicBlock>(context, begin, end, m_blockCategory);
 			result->CopyFunctionFrom(beginBlockIterator->second);
 			m_cachedBlocks.insert(std::make_pair(blockKey, result));
 			return result;
 		}
 	}
 
-	//Totally new block, build it from scratch
-	auto result = std::make_shared<CVuBasicBlock>(context, begin, end, m_blockCategory);
-	result->Compile();
+	//Totally new block, build it from scratch unless another executor already did
 	if(!hasBreakpoint)
 	{
+		uint32 executorFlags = result->AreTrailingMacFlagsOverwritten() ? SHARED_BLOCK_FLAG_EXECUTOR : 0;
+		CompileSharedBlock(result.get(), hash, blockSizeByte, executorFlags);
 		m_cachedBlocks.insert(std::make_pair(blockKey, result));
 	}
+	else
+	{
+		result->Compile();
+	}
 	return result;
 }
 
+void CVuExecutor::ClearActiveBlocksInRange(uint32 start, uint32 end, bool executing)
+{
+	CGenericMipsExecutor::ClearActiveBlocksInRange(start, end, executing);
+
+	//Also clear blocks that were compiled knowing what the code in that range was doing
+	CBasicBlock* currentBlock = nullptr;
+	if(executing)
+	{
+		currentBlock = FindBlockStartingAt(m_context.m_State.nPC);
+	}
+
+	std::vector<std::pair<uint32, uint32>> dependentBlockRanges;
+	for(const auto& block : m_blocks)
+	{
+		if(block.get() == currentBlock) continue;
+		auto vuBlock = static_cast<CVuBasicBlock*>(block.get());
+		if(vuBlock->HasSuccessorDependencyInRange(start, end))
+		{
+			dependentBlockRanges.push_back(std::make_pair(block->GetBeginAddress(), block->GetEndAddress()));
+		}
+	}
+
+	for(const auto& blockRange : dependentBlockRanges)
+	{
+		ClearActiveBlocksInRangeInternal(blockRange.first, blockRange.second, currentBlock);
+	}
+}
+
 void CVuExecutor::PartitionFunction(uint32 startAddress)
 {
 	uint32 endAddress = std::min<uint32>(startAddress + MAX_BLOCK_SIZE - 4, m_maxAddress - 4);
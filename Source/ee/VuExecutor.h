@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <tuple>
 #include "../GenericMipsExecutor.h"
 
 class CVuExecutor : public CGenericMipsExecutor<BlockLookupOneWay, 8>
@@ -10,9 +11,11 @@ public:
 	virtual ~CVuExecutor() = default;
 
 	void Reset() override;
+	void ClearActiveBlocksInRange(uint32, uint32, bool) override;
 
 protected:
-	typedef std::pair<uint128, uint32> CachedBlockKey;
+	//Block contents hash, block size, whether MAC flags are overwritten by the blocks that follow and float clamping mode
+	typedef std::tuple<uint128, uint32, bool, FpUtils::CLAMPING_MODE> CachedBlockKey;
 	typedef std::multimap<CachedBlockKey, BasicBlockPtr> CachedBlockMap;
 	CachedBlockMap m_cachedBlocks;
 
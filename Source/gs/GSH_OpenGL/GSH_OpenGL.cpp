@@ -88,14 +88,22 @@ void CGSH_OpenGL::InitializeImpl()
 
 	m_renderState.isValid = false;
 	m_validGlState = 0;
+
+	LoadProgramCache();
+	StartShaderWarmUp();
 }
 
 void CGSH_OpenGL::ReleaseImpl()
 {
 	ResetImpl();
 
+	StopShaderWarmUp();
+	SaveProgramCache();
+
 	m_paletteCache.clear();
 	m_shaders.clear();
+	m_warmedUpShaders.clear();
+	m_programBinaries.clear();
 	m_presentProgram.reset();
 	m_presentVertexBuffer.Reset();
 	m_presentVertexArray.Reset();
@@ -237,9 +245,9 @@ void CGSH_OpenGL::FlipImpl(const DISPLAY_INFO& dispInfo)
 	CGSHandler::FlipImpl(dispInfo);
 }
 
-void CGSH_OpenGL::LoadState(Framework::CZipArchiveReader& archive)
+void CGSH_OpenGL::LoadState(Framework::CZipArchiveReader& archive, const StateMemoryRegionSource& regionSource)
 {
-	CGSHandler::LoadState(archive);
+	CGSHandler::LoadState(archive, regionSource);
 	SendGSCall(
 	    [this]() {
 		    m_textureCache.InvalidateRange(0, RAMSIZE);
@@ -304,6 +312,13 @@ void CGSH_OpenGL::InitializeRC()
 
 void CGSH_OpenGL::CheckExtensions()
 {
+#ifdef GLES_COMPATIBILITY
+	//Program binaries are part of OpenGL ES 3.0
+	bool hasProgramBinaryExtension = true;
+#else
+	bool hasProgramBinaryExtension = false;
+#endif
+
 	GLint numExtensions = 0;
 	glGetIntegerv(GL_NUM_EXTENSIONS, &numExtensions);
 	for(GLint i = 0; i < numExtensions; i++)
@@ -313,6 +328,18 @@ void CGSH_OpenGL::CheckExtensions()
 		{
 			m_hasFramebufferFetchExtension = true;
 		}
+		else if(!strcmp(extensionName, "GL_ARB_get_program_binary"))
+		{
+			hasProgramBinaryExtension = true;
+		}
+	}
+
+	//Drivers are allowed to support the functions without supporting any format
+	if(hasProgramBinaryExtension)
+	{
+		GLint numProgramBinaryFormats = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numProgramBinaryFormats);
+		m_hasProgramBinarySupport = (numProgramBinaryFormats > 0);
 	}
 }
 
@@ -489,7 +516,7 @@ Framework::OpenGl::ProgramPtr CGSH_OpenGL::GetShaderFromCaps(const SHADERCAPS& s
 	auto shaderIterator = m_shaders.find(shaderCaps);
 	if(shaderIterator == m_shaders.end())
 	{
-		auto shader = GenerateShader(shaderCaps);
+		auto shader = CreateShader(shaderCaps);
 
 		glUseProgram(*shader);
 		m_validGlState &= ~GLSTATE_PROGRAM;
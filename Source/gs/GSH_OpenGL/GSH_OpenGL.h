@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
 #include <list>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
 #include "../GSHandler.h"
 #include "../GsDebuggerInterface.h"
@@ -28,7 +31,7 @@ public:
 
 	static void RegisterPreferences();
 
-	void LoadState(Framework::CZipArchiveReader&) override;
+	void LoadState(Framework::CZipArchiveReader&, const StateMemoryRegionSource& = StateMemoryRegionSource()) override;
 
 	void ProcessHostToLocalTransfer() override;
 	void ProcessLocalToHostTransfer() override;
@@ -63,6 +66,11 @@ protected:
 	void NotifyPreferencesChangedImpl() override;
 	void FlipImpl(const DISPLAY_INFO&) override;
 
+	//Shader warm up needs a context sharing objects with the main one. Both functions are called
+	//from the warm up thread. Platforms that can't provide such a context skip warm up.
+	virtual bool BeginWorkerContext();
+	virtual void EndWorkerContext();
+
 	GLuint m_presentFramebuffer = 0;
 
 private:
@@ -205,6 +213,13 @@ private:
 
 	typedef std::unordered_map<ShaderCapsInt, Framework::OpenGl::ProgramPtr> ShaderMap;
 
+	struct PROGRAM_BINARY
+	{
+		uint32 format = 0;
+		std::vector<uint8> data;
+	};
+	typedef std::unordered_map<ShaderCapsInt, PROGRAM_BINARY> ProgramBinaryMap;
+
 	class CPalette
 	{
 	public:
@@ -319,6 +334,7 @@ private:
 	void VertexKick(uint8, uint64);
 
 	Framework::OpenGl::ProgramPtr GetShaderFromCaps(const SHADERCAPS&);
+	Framework::OpenGl::ProgramPtr CreateShader(const SHADERCAPS&);
 	Framework::OpenGl::ProgramPtr GenerateShader(const SHADERCAPS&);
 	Framework::OpenGl::CShader GenerateVertexShader(const SHADERCAPS&);
 	Framework::OpenGl::CShader GenerateFragmentShader(const SHADERCAPS&);
@@ -337,6 +353,16 @@ private:
 	Framework::OpenGl::CVertexArray GeneratePrimVertexArray();
 	Framework::OpenGl::CBuffer GenerateUniformBlockBuffer(size_t);
 
+	//Program cache
+	std::string GetDriverIdentity() const;
+	void LoadProgramCache();
+	void SaveProgramCache();
+	Framework::OpenGl::ProgramPtr CreateShaderFromBinary(const PROGRAM_BINARY&);
+	Framework::OpenGl::ProgramPtr TakeWarmedUpShader(const SHADERCAPS&);
+	void StartShaderWarmUp();
+	void StopShaderWarmUp();
+	void ShaderWarmUpThreadProc();
+
 	void Prim_Point();
 	void Prim_Line();
 	void Prim_Triangle();
@@ -463,6 +489,14 @@ private:
 	};
 
 	ShaderMap m_shaders;
+	ProgramBinaryMap m_programBinaries;
+	bool m_hasProgramBinarySupport = false;
+
+	std::thread m_shaderWarmUpThread;
+	std::atomic<bool> m_shaderWarmUpCancelled = false;
+	std::mutex m_warmedUpShadersMutex;
+	ShaderMap m_warmedUpShaders;
+
 	RENDERSTATE m_renderState;
 	uint32 m_validGlState = 0;
 	VERTEXPARAMS m_vertexParams;
@@ -0,0 +1,266 @@
+#include "GSH_OpenGL.h"
+#include <cassert>
+#include "StdStreamUtils.h"
+#include "filesystem_def.h"
+#include "../../AppConfig.h"
+#include "../../Log.h"
+
+#define LOG_NAME ("gsh_opengl")
+
+#define PROGRAM_CACHE_FILENAME ("opengl_program_cache.bin")
+#define PROGRAM_CACHE_MAGIC 0x43504F50 //'POPC'
+#define PROGRAM_CACHE_VERSION 1
+
+//The program cache file holds the caps of every shader that was used along with the program
+//binary the driver gave us for it. Binaries are only valid for the driver that produced them:
+//if the driver changed, they are dropped and the caps are used to compile the shaders again.
+
+static fs::path GetProgramCachePath()
+{
+	return CAppConfig::GetInstance().GetBasePath() / PROGRAM_CACHE_FILENAME;
+}
+
+std::string CGSH_OpenGL::GetDriverIdentity() const
+{
+	auto getString = [](GLenum name) {
+		auto value = reinterpret_cast<const char*>(glGetString(name));
+		return std::string(value ? value : "");
+	};
+	return getString(GL_VENDOR) + "/" + getString(GL_RENDERER) + "/" + getString(GL_VERSION);
+}
+
+void CGSH_OpenGL::LoadProgramCache()
+{
+	assert(m_programBinaries.empty());
+
+	auto cachePath = GetProgramCachePath();
+	if(!fs::exists(cachePath))
+	{
+		return;
+	}
+
+	try
+	{
+		auto stream = Framework::CreateInputStdStream(cachePath.native());
+		stream.Seek(0, Framework::STREAM_SEEK_END);
+		uint64 fileSize = stream.Tell();
+		stream.Seek(0, Framework::STREAM_SEEK_SET);
+
+		uint32 magic = stream.Read32();
+		uint32 version = stream.Read32();
+		if((magic != PROGRAM_CACHE_MAGIC) || (version != PROGRAM_CACHE_VERSION))
+		{
+			return;
+		}
+
+		uint32 identitySize = stream.Read32();
+		if(identitySize > (fileSize - stream.Tell()))
+		{
+			throw std::runtime_error("Invalid driver identity size.");
+		}
+		std::string identity(identitySize, 0);
+		stream.Read(identity.data(), identitySize);
+		bool keepBinaries = m_hasProgramBinarySupport && (identity == GetDriverIdentity());
+
+		ProgramBinaryMap programBinaries;
+		uint32 programCount = stream.Read32();
+		for(uint32 i = 0; i < programCount; i++)
+		{
+			ShaderCapsInt caps = 0;
+			stream.Read(&caps, sizeof(ShaderCapsInt));
+			PROGRAM_BINARY binary;
+			binary.format = stream.Read32();
+			uint32 binarySize = stream.Read32();
+			if(binarySize > (fileSize - stream.Tell()))
+			{
+				throw std::runtime_error("Invalid program binary size.");
+			}
+			if(keepBinaries)
+			{
+				binary.data.resize(binarySize);
+				stream.Read(binary.data.data(), binarySize);
+			}
+			else
+			{
+				binary.format = 0;
+				stream.Seek(binarySize, Framework::STREAM_SEEK_CUR);
+			}
+			programBinaries.insert(std::make_pair(caps, std::move(binary)));
+		}
+
+		m_programBinaries = std::move(programBinaries);
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to load program cache: %s\r\n", exception.what());
+	}
+}
+
+void CGSH_OpenGL::SaveProgramCache()
+{
+	//Shaders created during this session replace what was loaded
+	for(const auto& shaderPair : m_shaders)
+	{
+		PROGRAM_BINARY binary;
+		if(m_hasProgramBinarySupport)
+		{
+			const auto& program = shaderPair.second;
+			GLint binaryLength = 0;
+			glGetProgramiv(*program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+			if(binaryLength > 0)
+			{
+				GLenum binaryFormat = 0;
+				binary.data.resize(binaryLength);
+				glGetProgramBinary(*program, binaryLength, &binaryLength, &binaryFormat, binary.data.data());
+				binary.data.resize(binaryLength);
+				binary.format = binaryFormat;
+			}
+		}
+		m_programBinaries[shaderPair.first] = std::move(binary);
+	}
+
+	CHECKGLERROR();
+
+	if(m_programBinaries.empty())
+	{
+		return;
+	}
+
+	try
+	{
+		auto identity = GetDriverIdentity();
+		auto stream = Framework::CreateOutputStdStream(GetProgramCachePath().native());
+		stream.Write32(PROGRAM_CACHE_MAGIC);
+		stream.Write32(PROGRAM_CACHE_VERSION);
+		stream.Write32(static_cast<uint32>(identity.size()));
+		stream.Write(identity.data(), identity.size());
+		stream.Write32(static_cast<uint32>(m_programBinaries.size()));
+		for(const auto& binaryPair : m_programBinaries)
+		{
+			const auto& binary = binaryPair.second;
+			ShaderCapsInt caps = binaryPair.first;
+			stream.Write(&caps, sizeof(ShaderCapsInt));
+			stream.Write32(binary.format);
+			stream.Write32(static_cast<uint32>(binary.data.size()));
+			stream.Write(binary.data.data(), binary.data.size());
+		}
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to save program cache: %s\r\n", exception.what());
+	}
+}
+
+Framework::OpenGl::ProgramPtr CGSH_OpenGL::CreateShader(const SHADERCAPS& caps)
+{
+	if(auto shader = TakeWarmedUpShader(caps))
+	{
+		return shader;
+	}
+
+	auto binaryIterator = m_programBinaries.find(caps);
+	if((binaryIterator != std::end(m_programBinaries)) && !binaryIterator->second.data.empty())
+	{
+		if(auto shader = CreateShaderFromBinary(binaryIterator->second))
+		{
+			return shader;
+		}
+	}
+
+	return GenerateShader(caps);
+}
+
+Framework::OpenGl::ProgramPtr CGSH_OpenGL::CreateShaderFromBinary(const PROGRAM_BINARY& binary)
+{
+	assert(m_hasProgramBinarySupport);
+
+	auto result = std::make_shared<Framework::OpenGl::CProgram>();
+	glProgramParameteri(*result, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	glProgramBinary(*result, binary.format, binary.data.data(), static_cast<GLsizei>(binary.data.size()));
+
+	//Drivers can reject binaries they produced (after an update for instance)
+	GLint linkStatus = GL_FALSE;
+	glGetProgramiv(*result, GL_LINK_STATUS, &linkStatus);
+
+	//Clear any error raised by a rejected binary
+	while(glGetError() != GL_NO_ERROR)
+	{
+	}
+
+	if(linkStatus != GL_TRUE)
+	{
+		return Framework::OpenGl::ProgramPtr();
+	}
+
+	return result;
+}
+
+Framework::OpenGl::ProgramPtr CGSH_OpenGL::TakeWarmedUpShader(const SHADERCAPS& caps)
+{
+	std::lock_guard<std::mutex> warmedUpShadersLock(m_warmedUpShadersMutex);
+	auto shaderIterator = m_warmedUpShaders.find(caps);
+	if(shaderIterator == std::end(m_warmedUpShaders))
+	{
+		return Framework::OpenGl::ProgramPtr();
+	}
+	auto shader = std::move(shaderIterator->second);
+	m_warmedUpShaders.erase(shaderIterator);
+	return shader;
+}
+
+void CGSH_OpenGL::StartShaderWarmUp()
+{
+	assert(!m_shaderWarmUpThread.joinable());
+	if(m_programBinaries.empty()) return;
+	m_shaderWarmUpCancelled = false;
+	m_shaderWarmUpThread = std::thread([this]() { ShaderWarmUpThreadProc(); });
+}
+
+void CGSH_OpenGL::StopShaderWarmUp()
+{
+	if(!m_shaderWarmUpThread.joinable()) return;
+	m_shaderWarmUpCancelled = true;
+	m_shaderWarmUpThread.join();
+}
+
+void CGSH_OpenGL::ShaderWarmUpThreadProc()
+{
+	if(!BeginWorkerContext())
+	{
+		return;
+	}
+
+	//m_programBinaries isn't modified until the thread is joined
+	for(const auto& binaryPair : m_programBinaries)
+	{
+		if(m_shaderWarmUpCancelled) break;
+
+		auto caps = make_convertible<SHADERCAPS>(binaryPair.first);
+		Framework::OpenGl::ProgramPtr shader;
+		if(!binaryPair.second.data.empty())
+		{
+			shader = CreateShaderFromBinary(binaryPair.second);
+		}
+		if(!shader)
+		{
+			shader = GenerateShader(caps);
+		}
+
+		//Make sure the program is complete before the GS thread's context can use it
+		glFinish();
+
+		std::lock_guard<std::mutex> warmedUpShadersLock(m_warmedUpShadersMutex);
+		m_warmedUpShaders.insert(std::make_pair(binaryPair.first, std::move(shader)));
+	}
+
+	EndWorkerContext();
+}
+
+bool CGSH_OpenGL::BeginWorkerContext()
+{
+	return false;
+}
+
+void CGSH_OpenGL::EndWorkerContext()
+{
+}
@@ -146,6 +146,7 @@ void CGSH_Vulkan::InitializeImpl()
 	CreateDevice(m_context->physicalDevice);
 	m_context->device.vkGetDeviceQueue(m_context->device, renderQueueFamily, 0, &m_context->queue);
 	m_context->commandBufferPool = Framework::Vulkan::CCommandBufferPool(m_context->device, renderQueueFamily);
+	m_pipelineStore = std::make_unique<CPipelineStore>(m_context);
 
 	CreateDescriptorPool();
 	CreateMemoryBuffer();
@@ -215,6 +216,9 @@ void CGSH_Vulkan::ReleaseImpl()
 	//Flush any pending rendering commands
 	m_context->device.vkQueueWaitIdle(m_context->queue);
 
+	StopPipelineWarmUp();
+	SavePipelineStore();
+
 	m_clutLoad.reset();
 	m_draw.reset();
 	m_present.reset();
@@ -246,6 +250,7 @@ void CGSH_Vulkan::ReleaseImpl()
 	m_context->memoryBufferCopy.Reset();
 	m_context->memoryBufferTransfer.Reset();
 	m_context->commandBufferPool.Reset();
+	m_pipelineStore.reset();
 	m_context->device.Reset();
 
 	delete[] m_memoryCache;
@@ -288,13 +293,17 @@ void CGSH_Vulkan::FlipImpl(const DISPLAY_INFO& dispInfo)
 	}
 
 	PresentBackbuffer();
+	CGSHandler::FlipImpl(dispInfo);
+}
+
+void CGSH_Vulkan::EndFrameImpl()
+{
 	for(auto& xferHistoryPair : m_xferHistory)
 	{
 		xferHistoryPair.second.Advance();
 	}
 	std::experimental::erase_if(m_xferHistory,
 	                            [](const auto& xferTrackerPair) { return xferTrackerPair.second.IsEmpty(); });
-	CGSHandler::FlipImpl(dispInfo);
 }
 
 std::vector<VkPhysicalDevice> CGSH_Vulkan::GetPhysicalDevices()
@@ -591,6 +600,82 @@ void CGSH_Vulkan::CreateClutBuffer()
 	m_context->annotations.SetBufferName(m_context->clutBuffer, "CLUT Buffer");
 }
 
+void CGSH_Vulkan::ChangePipelineStoreTitle(const std::string& title)
+{
+	if(title == m_pipelineStoreTitle) return;
+
+	StopPipelineWarmUp();
+	SavePipelineStore();
+
+	m_pipelineStoreTitle = title;
+	if(m_pipelineStoreTitle.empty()) return;
+
+	auto capsSet = m_pipelineStore->Load(CPipelineStore::GetTitleStorePath(m_pipelineStoreTitle));
+	StartPipelineWarmUp(std::move(capsSet));
+}
+
+void CGSH_Vulkan::SavePipelineStore()
+{
+	if(m_pipelineStoreTitle.empty()) return;
+
+	CPipelineStore::PIPELINE_CAPS_SET capsSet;
+	{
+		auto drawCaps = m_draw->GetCachedPipelineCaps();
+		auto transferHostCaps = m_transferHost->GetCachedPipelineCaps();
+		auto transferLocalCaps = m_transferLocal->GetCachedPipelineCaps();
+		auto clutLoadCaps = m_clutLoad->GetCachedPipelineCaps();
+		capsSet.draw.assign(drawCaps.begin(), drawCaps.end());
+		capsSet.transferHost.assign(transferHostCaps.begin(), transferHostCaps.end());
+		capsSet.transferLocal.assign(transferLocalCaps.begin(), transferLocalCaps.end());
+		capsSet.clutLoad.assign(clutLoadCaps.begin(), clutLoadCaps.end());
+	}
+	m_pipelineStore->Save(CPipelineStore::GetTitleStorePath(m_pipelineStoreTitle), capsSet);
+}
+
+void CGSH_Vulkan::StartPipelineWarmUp(CPipelineStore::PIPELINE_CAPS_SET capsSet)
+{
+	assert(!m_pipelineWarmUpThread.joinable());
+	m_pipelineWarmUpCancelled = false;
+	//Pipelines needed by the GS thread before warm up gets to them are created there as usual
+	m_pipelineWarmUpThread = std::thread(
+	    [this, capsSet = std::move(capsSet)]() {
+		    try
+		    {
+			    for(auto caps : capsSet.draw)
+			    {
+				    if(m_pipelineWarmUpCancelled) return;
+				    m_draw->PrecompilePipeline(caps);
+			    }
+			    for(auto caps : capsSet.transferHost)
+			    {
+				    if(m_pipelineWarmUpCancelled) return;
+				    m_transferHost->PrecompilePipeline(static_cast<CTransferHost::PipelineCapsInt>(caps));
+			    }
+			    for(auto caps : capsSet.transferLocal)
+			    {
+				    if(m_pipelineWarmUpCancelled) return;
+				    m_transferLocal->PrecompilePipeline(static_cast<CTransferLocal::PipelineCapsInt>(caps));
+			    }
+			    for(auto caps : capsSet.clutLoad)
+			    {
+				    if(m_pipelineWarmUpCancelled) return;
+				    m_clutLoad->PrecompilePipeline(static_cast<CClutLoad::PipelineCapsInt>(caps));
+			    }
+		    }
+		    catch(const std::exception& exception)
+		    {
+			    CLog::GetInstance().Warn(LOG_NAME, "Pipeline warm up failed: %s\r\n", exception.what());
+		    }
+	    });
+}
+
+void CGSH_Vulkan::StopPipelineWarmUp()
+{
+	if(!m_pipelineWarmUpThread.joinable()) return;
+	m_pipelineWarmUpCancelled = true;
+	m_pipelineWarmUpThread.join();
+}
+
 void CGSH_Vulkan::ProcessPrim(uint64 data)
 {
 	unsigned int newPrimitiveType = static_cast<unsigned int>(data & 0x07);
@@ -1603,6 +1688,11 @@ void CGSH_Vulkan::SyncCLUT(const TEX0& tex0)
 	m_draw->SetClutBufferOffset(clutBufferOffset);
 }
 
+void CGSH_Vulkan::SetExecutableName(const std::string& executableName)
+{
+	SendGSCall([this, executableName]() { ChangePipelineStoreTitle(executableName); });
+}
+
 uint8* CGSH_Vulkan::GetRam() const
 {
 	return m_memoryCache;
@@ -7,11 +7,14 @@
 #include "GSH_VulkanFrameCommandBuffer.h"
 #include "GSH_VulkanClutLoad.h"
 #include "GSH_VulkanDraw.h"
+#include "GSH_VulkanPipelineStore.h"
 #include "GSH_VulkanPresent.h"
 #include "GSH_VulkanTransferHost.h"
 #include "GSH_VulkanTransferLocal.h"
 #include <vector>
 #include <map>
+#include <atomic>
+#include <thread>
 #include <cstring>
 #include "../GSHandler.h"
 #include "../GsDebuggerInterface.h"
@@ -33,6 +36,8 @@ public:
 	void ProcessLocalToLocalTransfer() override;
 	void ProcessClutTransfer(uint32, uint32) override;
 
+	void SetExecutableName(const std::string&) override;
+
 	uint8* GetRam() const override;
 
 	Framework::CBitmap GetScreenshot() override;
@@ -61,6 +66,7 @@ protected:
 	void ResetImpl() override;
 	void MarkNewFrame() override;
 	void FlipImpl(const DISPLAY_INFO&) override;
+	void EndFrameImpl() override;
 	void BeginTransferWrite() override;
 	void TransferWrite(const uint8*, uint32) override;
 	void WriteBackMemoryCache() override;
@@ -149,6 +155,11 @@ private:
 	void CreateMemoryBuffer();
 	void CreateClutBuffer();
 
+	void ChangePipelineStoreTitle(const std::string&);
+	void SavePipelineStore();
+	void StartPipelineWarmUp(GSH_Vulkan::CPipelineStore::PIPELINE_CAPS_SET);
+	void StopPipelineWarmUp();
+
 	void ProcessPrim(uint64);
 	void VertexKick(uint8, uint64);
 	void SetRenderingContext(uint64);
@@ -235,6 +246,11 @@ private:
 	GSH_Vulkan::TransferHostPtr m_transferHost;
 	GSH_Vulkan::TransferLocalPtr m_transferLocal;
 
+	std::unique_ptr<GSH_Vulkan::CPipelineStore> m_pipelineStore;
+	std::string m_pipelineStoreTitle;
+	std::thread m_pipelineWarmUpThread;
+	std::atomic<bool> m_pipelineWarmUpCancelled = false;
+
 	uint8* m_memoryCache = nullptr;
 
 	//Draw context
@@ -19,6 +19,18 @@ CClutLoad::CClutLoad(const ContextPtr& context, const FrameCommandBufferPtr& fra
 {
 }
 
+std::vector<CClutLoad::PipelineCapsInt> CClutLoad::GetCachedPipelineCaps() const
+{
+	return m_pipelines.GetKeys();
+}
+
+void CClutLoad::PrecompilePipeline(PipelineCapsInt capsInt)
+{
+	auto caps = make_convertible<PIPELINE_CAPS>(capsInt);
+	if(m_pipelines.TryGetPipeline(caps)) return;
+	m_pipelines.RegisterPipeline(caps, CreateLoadPipeline(caps));
+}
+
 void CClutLoad::DoClutLoad(uint32 clutBufferOffset, const CGSHandler::TEX0& tex0, const CGSHandler::TEXCLUT& texClut)
 {
 	auto caps = make_convertible<PIPELINE_CAPS>(0);
@@ -339,7 +351,7 @@ PIPELINE CClutLoad::CreateLoadPipeline(const PIPELINE_CAPS& caps)
 		createInfo.stage.module = loadShader;
 		createInfo.layout = loadPipeline.pipelineLayout;
 
-		result = m_context->device.vkCreateComputePipelines(m_context->device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &loadPipeline.pipeline);
+		result = m_context->device.vkCreateComputePipelines(m_context->device, m_context->pipelineCache, 1, &createInfo, nullptr, &loadPipeline.pipeline);
 		CHECKVULKANERROR(result);
 	}
 
@@ -14,10 +14,15 @@ namespace GSH_Vulkan
 	public:
 		CClutLoad(const ContextPtr&, const FrameCommandBufferPtr&);
 
+		typedef uint32 PipelineCapsInt;
+
 		void DoClutLoad(uint32, const CGSHandler::TEX0&, const CGSHandler::TEXCLUT&);
 
+		//Pipeline precompilation, can be called from another thread
+		std::vector<PipelineCapsInt> GetCachedPipelineCaps() const;
+		void PrecompilePipeline(PipelineCapsInt);
+
 	private:
-		typedef uint32 PipelineCapsInt;
 
 		struct PIPELINE_CAPS : public convertible<PipelineCapsInt>
 		{
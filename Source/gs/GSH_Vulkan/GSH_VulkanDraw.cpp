@@ -56,6 +56,11 @@ CDraw::~CDraw()
 	}
 }
 
+std::vector<CDraw::PipelineCapsInt> CDraw::GetCachedPipelineCaps() const
+{
+	return m_pipelineCache.GetKeys();
+}
+
 void CDraw::SetPipelineCaps(const PIPELINE_CAPS& caps)
 {
 	bool changed = static_cast<uint64>(caps) != static_cast<uint64>(m_pipelineCaps);
@@ -107,6 +107,10 @@ namespace GSH_Vulkan
 		void PreFlushFrameCommandBuffer() override;
 		void PostFlushFrameCommandBuffer() override;
 
+		//Pipeline precompilation, can be called from another thread
+		std::vector<PipelineCapsInt> GetCachedPipelineCaps() const;
+		virtual void PrecompilePipeline(PipelineCapsInt) = 0;
+
 	protected:
 		enum
 		{
@@ -36,6 +36,13 @@ CDrawDesktop::~CDrawDesktop()
 	m_context->device.vkDestroyImageView(m_context->device, m_drawImageView, nullptr);
 }
 
+void CDrawDesktop::PrecompilePipeline(PipelineCapsInt capsInt)
+{
+	auto caps = make_convertible<PIPELINE_CAPS>(capsInt);
+	if(m_pipelineCache.TryGetPipeline(caps)) return;
+	m_pipelineCache.RegisterPipeline(caps, CreateDrawPipeline(caps));
+}
+
 void CDrawDesktop::CreateRenderPass()
 {
 	assert(m_renderPass == VK_NULL_HANDLE);
@@ -301,7 +308,7 @@ PIPELINE CDrawDesktop::CreateDrawPipeline(const PIPELINE_CAPS& caps)
 	pipelineCreateInfo.renderPass = m_renderPass;
 	pipelineCreateInfo.layout = drawPipeline.pipelineLayout;
 
-	result = m_context->device.vkCreateGraphicsPipelines(m_context->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &drawPipeline.pipeline);
+	result = m_context->device.vkCreateGraphicsPipelines(m_context->device, m_context->pipelineCache, 1, &pipelineCreateInfo, nullptr, &drawPipeline.pipeline);
 	CHECKVULKANERROR(result);
 
 	return drawPipeline;
@@ -13,6 +13,8 @@ namespace GSH_Vulkan
 		void FlushVertices() override;
 		void FlushRenderPass() override;
 
+		void PrecompilePipeline(PipelineCapsInt) override;
+
 	private:
 		void CreateRenderPass();
 		void CreateFramebuffer();
@@ -48,6 +48,24 @@ CDrawMobile::~CDrawMobile()
 	m_context->device.vkDestroyImageView(m_context->device, m_drawDepthImageView, nullptr);
 }
 
+void CDrawMobile::PrecompilePipeline(PipelineCapsInt capsInt)
+{
+	auto caps = make_convertible<PIPELINE_CAPS>(capsInt);
+	if(!m_pipelineCache.TryGetPipeline(caps))
+	{
+		m_pipelineCache.RegisterPipeline(caps, CreateDrawPipeline(caps));
+	}
+	auto loadStoreCaps = MakeLoadStorePipelineCaps(caps);
+	if(!m_loadPipelineCache.TryGetPipeline(loadStoreCaps))
+	{
+		m_loadPipelineCache.RegisterPipeline(loadStoreCaps, CreateLoadPipeline(loadStoreCaps));
+	}
+	if(!m_storePipelineCache.TryGetPipeline(loadStoreCaps))
+	{
+		m_storePipelineCache.RegisterPipeline(loadStoreCaps, CreateStorePipeline(loadStoreCaps));
+	}
+}
+
 void CDrawMobile::SetPipelineCaps(const PIPELINE_CAPS& caps)
 {
 	bool changed = static_cast<uint64>(caps) != static_cast<uint64>(m_pipelineCaps);
@@ -830,7 +848,7 @@ PIPELINE CDrawMobile::CreateDrawPipeline(const PIPELINE_CAPS& caps)
 	pipelineCreateInfo.renderPass = m_renderPass;
 	pipelineCreateInfo.layout = drawPipeline.pipelineLayout;
 
-	result = m_context->device.vkCreateGraphicsPipelines(m_context->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &drawPipeline.pipeline);
+	result = m_context->device.vkCreateGraphicsPipelines(m_context->device, m_context->pipelineCache, 1, &pipelineCreateInfo, nullptr, &drawPipeline.pipeline);
 	CHECKVULKANERROR(result);
 
 	return drawPipeline;
@@ -1387,7 +1405,7 @@ PIPELINE CDrawMobile::CreateLoadPipeline(const PIPELINE_CAPS& caps)
 	pipelineCreateInfo.renderPass = m_renderPass;
 	pipelineCreateInfo.layout = loadPipeline.pipelineLayout;
 
-	result = m_context->device.vkCreateGraphicsPipelines(m_context->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &loadPipeline.pipeline);
+	result = m_context->device.vkCreateGraphicsPipelines(m_context->device, m_context->pipelineCache, 1, &pipelineCreateInfo, nullptr, &loadPipeline.pipeline);
 	CHECKVULKANERROR(result);
 
 	return loadPipeline;
@@ -1546,7 +1564,7 @@ PIPELINE CDrawMobile::CreateStorePipeline(const PIPELINE_CAPS& caps)
 	pipelineCreateInfo.renderPass = m_renderPass;
 	pipelineCreateInfo.layout = storePipeline.pipelineLayout;
 
-	result = m_context->device.vkCreateGraphicsPipelines(m_context->device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &storePipeline.pipeline);
+	result = m_context->device.vkCreateGraphicsPipelines(m_context->device, m_context->pipelineCache, 1, &pipelineCreateInfo, nullptr, &storePipeline.pipeline);
 	CHECKVULKANERROR(result);
 
 	return storePipeline;
@@ -19,6 +19,8 @@ namespace GSH_Vulkan
 		void FlushVertices() override;
 		void FlushRenderPass() override;
 
+		void PrecompilePipeline(PipelineCapsInt) override;
+
 	private:
 		VkDescriptorSet PrepareDescriptorSet(VkDescriptorSetLayout, const DESCRIPTORSET_CAPS&);
 
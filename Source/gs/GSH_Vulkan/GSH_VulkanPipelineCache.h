@@ -1,7 +1,9 @@
 #pragma once
 
 #include "vulkan/Device.h"
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 
 namespace GSH_Vulkan
 {
@@ -12,6 +14,7 @@ namespace GSH_Vulkan
 		VkPipeline pipeline = VK_NULL_HANDLE;
 	};
 
+	//Pipelines can be registered from a precompilation thread while the GS thread uses the cache
 	template <typename KeyType>
 	class CPipelineCache
 	{
@@ -25,30 +28,53 @@ namespace GSH_Vulkan
 		{
 			for(const auto& pipelinePair : m_pipelines)
 			{
-				auto& pipeline = pipelinePair.second;
-				m_device->vkDestroyPipeline(*m_device, pipeline.pipeline, nullptr);
-				m_device->vkDestroyPipelineLayout(*m_device, pipeline.pipelineLayout, nullptr);
-				m_device->vkDestroyDescriptorSetLayout(*m_device, pipeline.descriptorSetLayout, nullptr);
+				DestroyPipeline(pipelinePair.second);
 			}
 		}
 
 		const PIPELINE* TryGetPipeline(const KeyType& key) const
 		{
+			std::lock_guard<std::mutex> lock(m_mutex);
 			auto pipelineIterator = m_pipelines.find(key);
 			return (pipelineIterator == std::end(m_pipelines)) ? nullptr : &pipelineIterator->second;
 		}
 
 		const PIPELINE* RegisterPipeline(const KeyType& key, const PIPELINE& pipeline)
 		{
-			assert(TryGetPipeline(key) == nullptr);
-			m_pipelines.insert(std::make_pair(key, pipeline));
-			return TryGetPipeline(key);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			auto result = m_pipelines.insert(std::make_pair(key, pipeline));
+			if(!result.second)
+			{
+				//Pipeline was created by another thread in the meantime
+				DestroyPipeline(pipeline);
+			}
+			return &result.first->second;
+		}
+
+		std::vector<KeyType> GetKeys() const
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			std::vector<KeyType> keys;
+			keys.reserve(m_pipelines.size());
+			for(const auto& pipelinePair : m_pipelines)
+			{
+				keys.push_back(pipelinePair.first);
+			}
+			return keys;
 		}
 
 	private:
 		typedef std::unordered_map<KeyType, PIPELINE> PipelineMap;
 
+		void DestroyPipeline(const PIPELINE& pipeline) const
+		{
+			m_device->vkDestroyPipeline(*m_device, pipeline.pipeline, nullptr);
+			m_device->vkDestroyPipelineLayout(*m_device, pipeline.pipelineLayout, nullptr);
+			m_device->vkDestroyDescriptorSetLayout(*m_device, pipeline.descriptorSetLayout, nullptr);
+		}
+
 		const Framework::Vulkan::CDevice* m_device = nullptr;
+		mutable std::mutex m_mutex;
 		PipelineMap m_pipelines;
 	};
 }
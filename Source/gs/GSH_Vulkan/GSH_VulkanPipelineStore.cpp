@@ -0,0 +1,195 @@
+#include "GSH_VulkanPipelineStore.h"
+#include <cstring>
+#include "StdStreamUtils.h"
+#include "PathUtils.h"
+#include "../../AppConfig.h"
+#include "../../Log.h"
+
+#define LOG_NAME ("gsh_vulkan_pipelinestore")
+
+#define STORE_DIRECTORY ("vulkan_pipeline_cache")
+
+using namespace GSH_Vulkan;
+
+static void WriteCapsSection(Framework::CStream& stream, const std::vector<uint64>& caps)
+{
+	stream.Write32(static_cast<uint32>(caps.size()));
+	stream.Write(caps.data(), caps.size() * sizeof(uint64));
+}
+
+static std::vector<uint64> ReadCapsSection(Framework::CStream& stream, uint64 remainingSize)
+{
+	uint32 count = stream.Read32();
+	if((static_cast<uint64>(count) * sizeof(uint64)) > remainingSize)
+	{
+		throw std::runtime_error("Invalid caps section size.");
+	}
+	std::vector<uint64> caps(count);
+	stream.Read(caps.data(), count * sizeof(uint64));
+	return caps;
+}
+
+CPipelineStore::CPipelineStore(const ContextPtr& context)
+    : m_context(context)
+{
+	assert(m_context->pipelineCache == VK_NULL_HANDLE);
+
+	VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	auto result = m_context->device.vkCreatePipelineCache(m_context->device, &pipelineCacheCreateInfo, nullptr, &m_context->pipelineCache);
+	CHECKVULKANERROR(result);
+}
+
+CPipelineStore::~CPipelineStore()
+{
+	m_context->device.vkDestroyPipelineCache(m_context->device, m_context->pipelineCache, nullptr);
+	m_context->pipelineCache = VK_NULL_HANDLE;
+}
+
+fs::path CPipelineStore::GetTitleStorePath(const std::string& title)
+{
+	std::string fileName = title;
+	for(auto& fileNameChar : fileName)
+	{
+		if(isalnum(static_cast<unsigned char>(fileNameChar)) || (fileNameChar == '.') || (fileNameChar == '-')) continue;
+		fileNameChar = '_';
+	}
+	auto storeDirectoryPath = CAppConfig::GetInstance().GetBasePath() / STORE_DIRECTORY;
+	return storeDirectoryPath / (fileName + ".bin");
+}
+
+CPipelineStore::PIPELINE_CAPS_SET CPipelineStore::Load(const fs::path& storePath)
+{
+	PIPELINE_CAPS_SET capsSet;
+	if(!fs::exists(storePath))
+	{
+		return capsSet;
+	}
+
+	try
+	{
+		auto stream = Framework::CreateInputStdStream(storePath.native());
+		stream.Seek(0, Framework::STREAM_SEEK_END);
+		uint64 fileSize = stream.Tell();
+		stream.Seek(0, Framework::STREAM_SEEK_SET);
+
+		uint32 magic = stream.Read32();
+		uint32 version = stream.Read32();
+		if((magic != STORE_MAGIC) || (version != STORE_VERSION))
+		{
+			CLog::GetInstance().Warn(LOG_NAME, "Ignoring pipeline store '%s': unsupported format.\r\n", storePath.string().c_str());
+			return capsSet;
+		}
+
+		uint32 cacheDataSize = stream.Read32();
+		if(cacheDataSize > (fileSize - stream.Tell()))
+		{
+			throw std::runtime_error("Invalid cache data size.");
+		}
+		std::vector<uint8> cacheData(cacheDataSize);
+		stream.Read(cacheData.data(), cacheDataSize);
+
+		PIPELINE_CAPS_SET readCapsSet;
+		readCapsSet.draw = ReadCapsSection(stream, fileSize - stream.Tell());
+		readCapsSet.transferHost = ReadCapsSection(stream, fileSize - stream.Tell());
+		readCapsSet.transferLocal = ReadCapsSection(stream, fileSize - stream.Tell());
+		readCapsSet.clutLoad = ReadCapsSection(stream, fileSize - stream.Tell());
+
+		//Caps are still useful if the driver changed, only the driver's data needs to be thrown away
+		if(IsCacheDataCompatible(cacheData))
+		{
+			MergeCacheData(cacheData);
+		}
+		else
+		{
+			CLog::GetInstance().Warn(LOG_NAME, "Pipeline cache data from '%s' doesn't match current device.\r\n", storePath.string().c_str());
+		}
+		capsSet = std::move(readCapsSet);
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to load pipeline store '%s': %s\r\n", storePath.string().c_str(), exception.what());
+	}
+
+	return capsSet;
+}
+
+void CPipelineStore::Save(const fs::path& storePath, const PIPELINE_CAPS_SET& capsSet)
+{
+	try
+	{
+		Framework::PathUtils::EnsurePathExists(storePath.parent_path());
+
+		auto cacheData = GetCacheData();
+
+		auto stream = Framework::CreateOutputStdStream(storePath.native());
+		stream.Write32(STORE_MAGIC);
+		stream.Write32(STORE_VERSION);
+		stream.Write32(static_cast<uint32>(cacheData.size()));
+		stream.Write(cacheData.data(), cacheData.size());
+		WriteCapsSection(stream, capsSet.draw);
+		WriteCapsSection(stream, capsSet.transferHost);
+		WriteCapsSection(stream, capsSet.transferLocal);
+		WriteCapsSection(stream, capsSet.clutLoad);
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to save pipeline store '%s': %s\r\n", storePath.string().c_str(), exception.what());
+	}
+}
+
+bool CPipelineStore::IsCacheDataCompatible(const std::vector<uint8>& cacheData) const
+{
+	//Drivers are supposed to reject incompatible data, but some don't check thoroughly
+	if(cacheData.size() < sizeof(VkPipelineCacheHeaderVersionOne))
+	{
+		return false;
+	}
+
+	VkPipelineCacheHeaderVersionOne header = {};
+	memcpy(&header, cacheData.data(), sizeof(VkPipelineCacheHeaderVersionOne));
+
+	VkPhysicalDeviceProperties physicalDeviceProperties = {};
+	m_context->instance->vkGetPhysicalDeviceProperties(m_context->physicalDevice, &physicalDeviceProperties);
+
+	return (header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE) &&
+	       (header.vendorID == physicalDeviceProperties.vendorID) &&
+	       (header.deviceID == physicalDeviceProperties.deviceID) &&
+	       !memcmp(header.pipelineCacheUUID, physicalDeviceProperties.pipelineCacheUUID, VK_UUID_SIZE);
+}
+
+void CPipelineStore::MergeCacheData(const std::vector<uint8>& cacheData)
+{
+	//The context's cache is shared by every title run in this session, merge the saved data in
+	VkPipelineCacheCreateInfo pipelineCacheCreateInfo = {};
+	pipelineCacheCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+	pipelineCacheCreateInfo.initialDataSize = cacheData.size();
+	pipelineCacheCreateInfo.pInitialData = cacheData.data();
+
+	VkPipelineCache loadedPipelineCache = VK_NULL_HANDLE;
+	auto result = m_context->device.vkCreatePipelineCache(m_context->device, &pipelineCacheCreateInfo, nullptr, &loadedPipelineCache);
+	if(result != VK_SUCCESS)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to create pipeline cache from saved data (%d).\r\n", result);
+		return;
+	}
+
+	result = m_context->device.vkMergePipelineCaches(m_context->device, m_context->pipelineCache, 1, &loadedPipelineCache);
+	CHECKVULKANERROR(result);
+
+	m_context->device.vkDestroyPipelineCache(m_context->device, loadedPipelineCache, nullptr);
+}
+
+std::vector<uint8> CPipelineStore::GetCacheData() const
+{
+	size_t cacheDataSize = 0;
+	auto result = m_context->device.vkGetPipelineCacheData(m_context->device, m_context->pipelineCache, &cacheDataSize, nullptr);
+	CHECKVULKANERROR(result);
+
+	std::vector<uint8> cacheData(cacheDataSize);
+	result = m_context->device.vkGetPipelineCacheData(m_context->device, m_context->pipelineCache, &cacheDataSize, cacheData.data());
+	CHECKVULKANERROR(result);
+	cacheData.resize(cacheDataSize);
+
+	return cacheData;
+}
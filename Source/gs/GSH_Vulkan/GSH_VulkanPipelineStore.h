@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include "GSH_VulkanContext.h"
+#include "filesystem_def.h"
+
+namespace GSH_Vulkan
+{
+	//Keeps pipelines across runs. Holds the driver's pipeline cache (shared by every pipeline
+	//created through the context) and saves it along with the caps of every pipeline that was
+	//created for a title, so that they can be compiled again before the title needs them.
+	class CPipelineStore
+	{
+	public:
+		struct PIPELINE_CAPS_SET
+		{
+			std::vector<uint64> draw;
+			std::vector<uint64> transferHost;
+			std::vector<uint64> transferLocal;
+			std::vector<uint64> clutLoad;
+		};
+
+		CPipelineStore(const ContextPtr&);
+		virtual ~CPipelineStore();
+
+		static fs::path GetTitleStorePath(const std::string&);
+
+		PIPELINE_CAPS_SET Load(const fs::path&);
+		void Save(const fs::path&, const PIPELINE_CAPS_SET&);
+
+	private:
+		enum
+		{
+			STORE_MAGIC = 0x43505650, //'PVPC'
+			STORE_VERSION = 1,
+		};
+
+		bool IsCacheDataCompatible(const std::vector<uint8>&) const;
+		void MergeCacheData(const std::vector<uint8>&);
+		std::vector<uint8> GetCacheData() const;
+
+		ContextPtr m_context;
+	};
+}
@@ -48,6 +48,18 @@ CTransferHost::~CTransferHost()
 	}
 }
 
+std::vector<CTransferHost::PipelineCapsInt> CTransferHost::GetCachedPipelineCaps() const
+{
+	return m_pipelineCache.GetKeys();
+}
+
+void CTransferHost::PrecompilePipeline(PipelineCapsInt capsInt)
+{
+	auto caps = make_convertible<PIPELINE_CAPS>(capsInt);
+	if(m_pipelineCache.TryGetPipeline(caps)) return;
+	m_pipelineCache.RegisterPipeline(caps, CreateXferPipeline(caps));
+}
+
 void CTransferHost::SetPipelineCaps(const PIPELINE_CAPS& pipelineCaps)
 {
 	m_pipelineCaps = pipelineCaps;
@@ -520,7 +532,7 @@ PIPELINE CTransferHost::CreateXferPipeline(const PIPELINE_CAPS& caps)
 		createInfo.stage.module = xferShader;
 		createInfo.layout = xferPipeline.pipelineLayout;
 
-		result = m_context->device.vkCreateComputePipelines(m_context->device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &xferPipeline.pipeline);
+		result = m_context->device.vkCreateComputePipelines(m_context->device, m_context->pipelineCache, 1, &createInfo, nullptr, &xferPipeline.pipeline);
 		CHECKVULKANERROR(result);
 	}
 
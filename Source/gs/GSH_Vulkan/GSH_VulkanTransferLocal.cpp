@@ -34,6 +34,18 @@ CTransferLocal::CTransferLocal(const ContextPtr& context, const FrameCommandBuff
 	m_pipelineCaps <<= 0;
 }
 
+std::vector<CTransferLocal::PipelineCapsInt> CTransferLocal::GetCachedPipelineCaps() const
+{
+	return m_pipelineCache.GetKeys();
+}
+
+void CTransferLocal::PrecompilePipeline(PipelineCapsInt capsInt)
+{
+	auto caps = make_convertible<PIPELINE_CAPS>(capsInt);
+	if(m_pipelineCache.TryGetPipeline(caps)) return;
+	m_pipelineCache.RegisterPipeline(caps, CreatePipeline(caps));
+}
+
 void CTransferLocal::SetPipelineCaps(const PIPELINE_CAPS& pipelineCaps)
 {
 	m_pipelineCaps = pipelineCaps;
@@ -452,7 +464,7 @@ PIPELINE CTransferLocal::CreatePipeline(const PIPELINE_CAPS& caps)
 		createInfo.stage.module = xferShader;
 		createInfo.layout = xferPipeline.pipelineLayout;
 
-		result = m_context->device.vkCreateComputePipelines(m_context->device, VK_NULL_HANDLE, 1, &createInfo, nullptr, &xferPipeline.pipeline);
+		result = m_context->device.vkCreateComputePipelines(m_context->device, m_context->pipelineCache, 1, &createInfo, nullptr, &xferPipeline.pipeline);
 		CHECKVULKANERROR(result);
 	}
 
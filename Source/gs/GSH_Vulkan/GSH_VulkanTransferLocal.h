@@ -43,6 +43,10 @@ namespace GSH_Vulkan
 
 		void SetPipelineCaps(const PIPELINE_CAPS&);
 
+		//Pipeline precompilation, can be called from another thread
+		std::vector<PipelineCapsInt> GetCachedPipelineCaps() const;
+		void PrecompilePipeline(PipelineCapsInt);
+
 		void DoTransfer();
 
 		XFERPARAMS Params;
@@ -6,6 +6,7 @@
 #include "../states/MemoryStateFile.h"
 #include "../states/RegisterStateFile.h"
 #include "../FrameDump.h"
+#include "../FrameDumpStream.h"
 #include "../ee/INTC.h"
 #include "GSHandler.h"
 #include "GsPixelFormats.h"
@@ -254,11 +255,24 @@ CGSHandler::PRESENTATION_VIEWPORT CGSHandler::GetPresentationViewport() const
 	return viewport;
 }
 
-void CGSHandler::SaveState(Framework::CZipArchiveWriter& archive)
+StateMemoryRegionList CGSHandler::GetStateMemoryRegions() const
+{
+	return {
+	    {STATE_RAM, GetRam(), RAMSIZE},
+	};
+}
+
+void CGSHandler::SaveState(Framework::CZipArchiveWriter& archive, bool saveMemoryRegions)
 {
 	SendGSCall([&]() { SyncMemoryCache(); }, true);
 
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_RAM, GetRam(), RAMSIZE));
+	if(saveMemoryRegions)
+	{
+		for(const auto& region : GetStateMemoryRegions())
+		{
+			SaveStateMemoryRegion(archive, region);
+		}
+	}
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_REGS, m_nReg, sizeof(uint64) * CGSHandler::REGISTER_MAX));
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_TRXCTX, &m_trxCtx, sizeof(TRXCONTEXT)));
 
@@ -283,9 +297,12 @@ void CGSHandler::SaveState(Framework::CZipArchiveWriter& archive)
 	}
 }
 
-void CGSHandler::LoadState(Framework::CZipArchiveReader& archive)
+void CGSHandler::LoadState(Framework::CZipArchiveReader& archive, const StateMemoryRegionSource& regionSource)
 {
-	archive.BeginReadFile(STATE_RAM)->Read(GetRam(), RAMSIZE);
+	for(const auto& region : GetStateMemoryRegions())
+	{
+		LoadStateMemoryRegion(archive, region, regionSource);
+	}
 	archive.BeginReadFile(STATE_REGS)->Read(m_nReg, sizeof(uint64) * CGSHandler::REGISTER_MAX);
 	archive.BeginReadFile(STATE_TRXCTX)->Read(&m_trxCtx, sizeof(TRXCONTEXT));
 
@@ -347,8 +364,40 @@ void CGSHandler::TriggerFrameDump(const FrameDumpCallback& frameDumpCallback)
 #endif
 }
 
+void CGSHandler::BeginFrameDumpStream(const FrameDumpStreamWriterPtr& frameDumpStream)
+{
+	m_frameDumpStreamEnabled = true;
+	SendGSCall(
+	    [this, frameDumpStream]() {
+		    assert(!m_frameDumpStream);
+		    m_frameDumpStream = frameDumpStream;
+	    });
+}
+
+void CGSHandler::EndFrameDumpStream()
+{
+	m_frameDumpStreamEnabled = false;
+	SendGSCall(
+	    [this]() {
+		    if(!m_frameDumpStream) return;
+		    m_frameDumpStream->Finish();
+		    m_frameDumpStream.reset();
+	    },
+	    true);
+}
+
 void CGSHandler::UpdateFrameDumpState()
 {
+	if(m_frameDumpStream)
+	{
+		m_frameDumpStream->EndFrame();
+		if(m_frameDumpStream->IsKeyFrameNeeded())
+		{
+			//This is expected to be called from the GS thread
+			SyncMemoryCache();
+			m_frameDumpStream->WriteKeyFrame(GetRam(), GetRegisters(), GetSMODE2());
+		}
+	}
 #ifdef DEBUGGER_INCLUDED
 	if(m_frameDump && !m_frameDump->GetPackets().empty())
 	{
@@ -370,6 +419,10 @@ void CGSHandler::UpdateFrameDumpState()
 #endif
 }
 
+void CGSHandler::SetExecutableName(const std::string&)
+{
+}
+
 void CGSHandler::InitFromFrameDump(CFrameDump* frameDump)
 {
 	//This is expected to be called from outside the GS thread
@@ -391,6 +444,16 @@ void CGSHandler::SetDrawEnabled(bool drawEnabled)
 	m_drawEnabled = drawEnabled;
 }
 
+bool CGSHandler::GetPresentationEnabled() const
+{
+	return m_presentationEnabled;
+}
+
+void CGSHandler::SetPresentationEnabled(bool presentationEnabled)
+{
+	m_presentationEnabled = presentationEnabled;
+}
+
 void CGSHandler::SetHBlank()
 {
 	std::lock_guard registerMutexLock(m_registerMutex);
@@ -544,6 +607,7 @@ void CGSHandler::Initialize()
 
 void CGSHandler::Release()
 {
+	EndFrameDumpStream();
 	SendGSCall(std::bind(&CGSHandler::ReleaseImpl, this), true);
 }
 
@@ -566,10 +630,19 @@ void CGSHandler::Flip(uint32 flags)
 	bool waitForCompletion = (flags & FLIP_FLAG_WAIT) != 0;
 	bool force = (flags & FLIP_FLAG_FORCE) != 0;
 	SendGSCall(
-	    [this, displayInfo = GetCurrentDisplayInfo(), force]() {
+	    [this, displayInfo = GetCurrentDisplayInfo(), force, present = m_presentationEnabled]() {
 		    if(force || m_regsDirty)
 		    {
-			    FlipImpl(displayInfo);
+			    if(present)
+			    {
+				    FlipImpl(displayInfo);
+			    }
+			    else
+			    {
+				    //Still signal the flip to anyone waiting for it
+				    CGSHandler::FlipImpl(displayInfo);
+			    }
+			    EndFrameImpl();
 		    }
 		    m_regsDirty = false;
 	    },
@@ -582,6 +655,10 @@ void CGSHandler::FlipImpl(const DISPLAY_INFO&)
 	m_flipped = true;
 }
 
+void CGSHandler::EndFrameImpl()
+{
+}
+
 void CGSHandler::MarkNewFrame()
 {
 	OnNewFrame(m_drawCallCount);
@@ -641,6 +718,10 @@ void CGSHandler::FeedImageData(const void* data, uint32 length)
 			    m_frameDump->AddImagePacket(imageData, length);
 		    }
 #endif
+		    if(m_frameDumpStream)
+		    {
+			    m_frameDumpStream->AddImagePacket(imageData, length);
+		    }
 		    FeedImageDataImpl(imageData, length);
 		    delete[] imageData;
 	    });
@@ -672,6 +753,23 @@ void CGSHandler::ProcessWriteBuffer(const CGsPacketMetadata* metadata)
 		    });
 	}
 #endif
+	if(m_frameDumpStreamEnabled)
+	{
+		if(uint32 packetSize = m_writeBufferSize - m_writeBufferProcessIndex; packetSize != 0)
+		{
+			SendGSCall(
+			    [this,
+			     packet = m_currentWriteBuffer + m_writeBufferProcessIndex,
+			     packetSize,
+			     pathIndex = metadata ? metadata->pathIndex : 0]() {
+				    if(m_frameDumpStream)
+				    {
+					    CGsPacketMetadata packetMetadata(pathIndex);
+					    m_frameDumpStream->AddRegisterPacket(packet, packetSize, &packetMetadata);
+				    }
+			    });
+		}
+	}
 	for(uint32 writeIndex = m_writeBufferProcessIndex; writeIndex < m_writeBufferSize; writeIndex++)
 	{
 		const auto& write = m_currentWriteBuffer[writeIndex];
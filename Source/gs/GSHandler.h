@@ -5,6 +5,7 @@
 #include <functional>
 #include <atomic>
 #include <array>
+#include <memory>
 #include "signal/Signal.h"
 
 #include "bitmap/Bitmap.h"
@@ -14,8 +15,10 @@
 #include "../Integer64.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
+#include "../states/StateMemoryRegion.h"
 
 class CFrameDump;
+class CFrameDumpStreamWriter;
 class CGsPacketMetadata;
 class CINTC;
 
@@ -814,6 +817,7 @@ public:
 	typedef std::function<CGSHandler*()> FactoryFunction;
 
 	typedef std::function<void(const CFrameDump&)> FrameDumpCallback;
+	typedef std::shared_ptr<CFrameDumpStreamWriter> FrameDumpStreamWriterPtr;
 
 	typedef Framework::CSignal<void()> FlipCompleteEvent;
 	typedef Framework::CSignal<void(uint32)> NewFrameEvent;
@@ -829,17 +833,30 @@ public:
 	virtual void SetPresentationParams(const PRESENTATION_PARAMS&);
 	PRESENTATION_VIEWPORT GetPresentationViewport() const;
 
-	virtual void SaveState(Framework::CZipArchiveWriter&);
-	virtual void LoadState(Framework::CZipArchiveReader&);
+	//Contents of the regions are only up to date after SaveState synced the memory cache
+	StateMemoryRegionList GetStateMemoryRegions() const;
+	virtual void SaveState(Framework::CZipArchiveWriter&, bool saveMemoryRegions = true);
+	virtual void LoadState(Framework::CZipArchiveReader&, const StateMemoryRegionSource& = StateMemoryRegionSource());
 	void Copy(CGSHandler*);
 
 	void TriggerFrameDump(const FrameDumpCallback&);
 
+	//Captures everything sent to the GS starting at the next frame until the stream is ended
+	void BeginFrameDumpStream(const FrameDumpStreamWriterPtr&);
+	void EndFrameDumpStream();
+
 	void InitFromFrameDump(CFrameDump*);
 
+	//Called when the running executable changes, lets handlers keep data specific to a title
+	virtual void SetExecutableName(const std::string&);
+
 	bool GetDrawEnabled() const;
 	void SetDrawEnabled(bool);
 
+	//When disabled, flips don't present anything, GS RAM and registers are still kept up to date
+	bool GetPresentationEnabled() const;
+	void SetPresentationEnabled(bool);
+
 	void WritePrivRegister(uint32, uint32);
 	uint32 ReadPrivRegister(uint32);
 
@@ -1037,6 +1054,8 @@ protected:
 	virtual void ResetImpl();
 	virtual void NotifyPreferencesChangedImpl();
 	virtual void FlipImpl(const DISPLAY_INFO&);
+	//Called after every flip, even when presentation is disabled
+	virtual void EndFrameImpl();
 	virtual void MarkNewFrame();
 	virtual void WriteRegisterImpl(uint8, uint64);
 	void FeedImageDataImpl(const uint8*, uint32);
@@ -1129,8 +1148,11 @@ protected:
 	bool m_threadDone = false;
 	std::unique_ptr<CFrameDump> m_frameDump;
 	FrameDumpCallback m_frameDumpCallback;
+	FrameDumpStreamWriterPtr m_frameDumpStream;
+	std::atomic<bool> m_frameDumpStreamEnabled = false;
 	bool m_regsDirty = false;
 	bool m_drawEnabled = true;
+	bool m_presentationEnabled = true;
 	CINTC* m_intc = nullptr;
 	bool m_gsThreaded = true;
 	bool m_flipped = false;
@@ -0,0 +1,177 @@
+#include "BlockCacheStream.h"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+using namespace Hdd;
+
+CBlockCacheStream::CBlockCacheStream(Framework::CStream& stream, uint32 blockSize, uint32 maxBlockCount, uint32 readAheadBlockCount)
+    : m_stream(stream)
+    , m_blockSize(blockSize)
+    , m_maxBlockCount(maxBlockCount)
+    , m_readAheadBlockCount(std::max<uint32>(readAheadBlockCount, 1))
+{
+	assert(m_blockSize != 0);
+	//Read ahead blocks must not evict the block that was asked for
+	assert(m_maxBlockCount > m_readAheadBlockCount);
+}
+
+void CBlockCacheStream::Clear()
+{
+	m_blocks.clear();
+	m_blockMap.clear();
+	m_nextSequentialPosition = ~0ULL;
+}
+
+uint64 CBlockCacheStream::GetHitCount() const
+{
+	return m_hitCount;
+}
+
+uint64 CBlockCacheStream::GetMissCount() const
+{
+	return m_missCount;
+}
+
+void CBlockCacheStream::Seek(int64 position, Framework::STREAM_SEEK_DIRECTION whence)
+{
+	switch(whence)
+	{
+	case Framework::STREAM_SEEK_SET:
+		m_position = position;
+		break;
+	case Framework::STREAM_SEEK_CUR:
+		m_position += position;
+		break;
+	case Framework::STREAM_SEEK_END:
+		m_stream.Seek(position, Framework::STREAM_SEEK_END);
+		m_position = m_stream.Tell();
+		break;
+	}
+	m_isEof = false;
+}
+
+uint64 CBlockCacheStream::Tell()
+{
+	return m_position;
+}
+
+uint64 CBlockCacheStream::Read(void* buffer, uint64 size)
+{
+	auto outputBuffer = reinterpret_cast<uint8*>(buffer);
+	bool isSequential = (m_position == m_nextSequentialPosition);
+	uint64 amountRead = 0;
+	while(amountRead != size)
+	{
+		uint64 blockIndex = m_position / m_blockSize;
+		uint32 blockOffset = static_cast<uint32>(m_position % m_blockSize);
+		auto block = FindBlock(blockIndex);
+		if(!block)
+		{
+			block = LoadBlocks(blockIndex, isSequential ? m_readAheadBlockCount : 1);
+		}
+		if(blockOffset >= block->data.size())
+		{
+			m_isEof = true;
+			break;
+		}
+		uint64 copySize = std::min<uint64>(size - amountRead, block->data.size() - blockOffset);
+		memcpy(outputBuffer + amountRead, block->data.data() + blockOffset, copySize);
+		amountRead += copySize;
+		m_position += copySize;
+		//Reads spanning many blocks are sequential after their first block
+		isSequential = true;
+	}
+	m_nextSequentialPosition = m_position;
+	return amountRead;
+}
+
+uint64 CBlockCacheStream::Write(const void* buffer, uint64 size)
+{
+	m_stream.Seek(m_position, Framework::STREAM_SEEK_SET);
+	uint64 amountWritten = m_stream.Write(buffer, size);
+	if(amountWritten != 0)
+	{
+		InvalidateBlocks(m_position / m_blockSize, (m_position + amountWritten - 1) / m_blockSize);
+	}
+	m_position += amountWritten;
+	m_nextSequentialPosition = ~0ULL;
+	return amountWritten;
+}
+
+bool CBlockCacheStream::IsEOF()
+{
+	return m_isEof;
+}
+
+const CBlockCacheStream::BLOCK* CBlockCacheStream::FindBlock(uint64 blockIndex)
+{
+	auto blockIterator = m_blockMap.find(blockIndex);
+	if(blockIterator == std::end(m_blockMap))
+	{
+		return nullptr;
+	}
+	m_hitCount++;
+	m_blocks.splice(m_blocks.begin(), m_blocks, blockIterator->second);
+	return &m_blocks.front();
+}
+
+const CBlockCacheStream::BLOCK* CBlockCacheStream::LoadBlocks(uint64 firstBlockIndex, uint32 blockCount)
+{
+	m_missCount++;
+
+	//Stop reading ahead when reaching blocks we already have
+	uint32 loadBlockCount = 1;
+	while((loadBlockCount < blockCount) && (m_blockMap.find(firstBlockIndex + loadBlockCount) == std::end(m_blockMap)))
+	{
+		loadBlockCount++;
+	}
+
+	std::vector<uint8> loadBuffer(static_cast<size_t>(loadBlockCount) * m_blockSize);
+	m_stream.Seek(firstBlockIndex * m_blockSize, Framework::STREAM_SEEK_SET);
+	uint64 amountRead = m_stream.Read(loadBuffer.data(), loadBuffer.size());
+
+	//Inserted backwards to have the requested block be the most recently used one
+	for(uint32 i = loadBlockCount; i-- > 0;)
+	{
+		uint64 blockStart = static_cast<uint64>(i) * m_blockSize;
+		BLOCK block;
+		block.index = firstBlockIndex + i;
+		if(blockStart < amountRead)
+		{
+			uint64 blockEnd = std::min<uint64>(amountRead, blockStart + m_blockSize);
+			block.data.assign(loadBuffer.begin() + blockStart, loadBuffer.begin() + blockEnd);
+		}
+		else if(i != 0)
+		{
+			//Past the end of the stream, no need to keep this
+			continue;
+		}
+		InsertBlock(std::move(block));
+	}
+
+	return &m_blocks.front();
+}
+
+void CBlockCacheStream::InsertBlock(BLOCK block)
+{
+	assert(m_blockMap.find(block.index) == std::end(m_blockMap));
+	if(m_blocks.size() >= m_maxBlockCount)
+	{
+		m_blockMap.erase(m_blocks.back().index);
+		m_blocks.pop_back();
+	}
+	m_blocks.push_front(std::move(block));
+	m_blockMap[m_blocks.front().index] = m_blocks.begin();
+}
+
+void CBlockCacheStream::InvalidateBlocks(uint64 firstBlockIndex, uint64 lastBlockIndex)
+{
+	for(uint64 blockIndex = firstBlockIndex; blockIndex <= lastBlockIndex; blockIndex++)
+	{
+		auto blockIterator = m_blockMap.find(blockIndex);
+		if(blockIterator == std::end(m_blockMap)) continue;
+		m_blocks.erase(blockIterator->second);
+		m_blockMap.erase(blockIterator);
+	}
+}
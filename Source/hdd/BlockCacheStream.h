@@ -0,0 +1,67 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include "Stream.h"
+
+namespace Hdd
+{
+	//Read cache in front of a disk image stream, keeps the most recently used blocks in memory.
+	//A miss that continues the previous read also fetches the blocks after it, in a single read.
+	class CBlockCacheStream : public Framework::CStream
+	{
+	public:
+		enum
+		{
+			DEFAULT_BLOCK_SIZE = 0x8000,
+			DEFAULT_BLOCK_COUNT = 128,
+			DEFAULT_READAHEAD_BLOCK_COUNT = 8,
+		};
+
+		CBlockCacheStream(Framework::CStream&, uint32 = DEFAULT_BLOCK_SIZE, uint32 = DEFAULT_BLOCK_COUNT, uint32 = DEFAULT_READAHEAD_BLOCK_COUNT);
+		virtual ~CBlockCacheStream() = default;
+
+		void Clear();
+
+		uint64 GetHitCount() const;
+		uint64 GetMissCount() const;
+
+		void Seek(int64, Framework::STREAM_SEEK_DIRECTION) override;
+		uint64 Tell() override;
+		uint64 Read(void*, uint64) override;
+		uint64 Write(const void*, uint64) override;
+		bool IsEOF() override;
+
+	private:
+		struct BLOCK
+		{
+			uint64 index = 0;
+			//Can be shorter than block size at the end of the stream
+			std::vector<uint8> data;
+		};
+		//Most recently used block is at the front
+		typedef std::list<BLOCK> BlockList;
+		typedef std::unordered_map<uint64, BlockList::iterator> BlockMap;
+
+		const BLOCK* FindBlock(uint64);
+		const BLOCK* LoadBlocks(uint64, uint32);
+		void InsertBlock(BLOCK);
+		void InvalidateBlocks(uint64, uint64);
+
+		Framework::CStream& m_stream;
+		uint32 m_blockSize = 0;
+		uint32 m_maxBlockCount = 0;
+		uint32 m_readAheadBlockCount = 0;
+
+		BlockList m_blocks;
+		BlockMap m_blockMap;
+
+		uint64 m_position = 0;
+		uint64 m_nextSequentialPosition = ~0ULL;
+		bool m_isEof = false;
+
+		uint64 m_hitCount = 0;
+		uint64 m_missCount = 0;
+	};
+}
@@ -104,11 +104,26 @@ uint32 CPfsReader::GetBlockLba(uint32 number, uint32 subPart) const
 
 PFS_INODE CPfsReader::ReadInode(uint32 number, uint32 subPart)
 {
+	uint64 inodeKey = (static_cast<uint64>(subPart) << 32) | number;
+	auto inodeIterator = m_inodeCache.find(inodeKey);
+	if(inodeIterator != std::end(m_inodeCache))
+	{
+		return inodeIterator->second;
+	}
+
 	PFS_INODE result = {};
 	uint32 inodeLba = GetBlockLba(number, subPart);
 	m_stream.Seek(inodeLba * g_sectorSize, Framework::STREAM_SEEK_SET);
 	m_stream.Read(&result, sizeof(PFS_INODE));
 	assert(result.magic == PFS_INODE_SEGDESC_DIRECT_MAGIC);
+
+	//Partitions are read only, inodes never need to be invalidated
+	if(m_inodeCache.size() >= MAX_CACHED_INODES)
+	{
+		m_inodeCache.clear();
+	}
+	m_inodeCache.insert(std::make_pair(inodeKey, result));
+
 	return result;
 }
 
@@ -159,29 +174,34 @@ uint64 CPfsFileReader::Read(void* buffer, uint64 length)
 	assert((zoneSize % g_sectorSize) == 0);
 	assert(m_inode.dataCount >= 2);
 
-	uint64 segmentPosition = m_position;
-	uint32 segmentIndex = 1;
-	for(uint32 i = 1; i < m_inode.dataCount; i++)
+	if(m_position < m_segmentStart)
 	{
-		uint64_t segmentSize = m_inode.data[i].count * zoneSize;
-		if(segmentPosition < segmentSize)
+		m_segmentIndex = 1;
+		m_segmentStart = 0;
+	}
+	while(m_segmentIndex < m_inode.dataCount)
+	{
+		uint64 segmentSize = m_inode.data[m_segmentIndex].count * zoneSize;
+		if((m_position - m_segmentStart) < segmentSize)
 		{
-			segmentIndex = i;
 			break;
 		}
-		segmentPosition -= segmentSize;
+		m_segmentStart += segmentSize;
+		m_segmentIndex++;
 	}
 
+	uint64 segmentPosition = m_position - m_segmentStart;
+	uint32 segmentIndex = m_segmentIndex;
+
 	uint8* charBuffer = reinterpret_cast<uint8*>(buffer);
 	uint64 readRemain = length;
 	while(readRemain != 0)
 	{
 		assert(segmentIndex < m_inode.dataCount);
 		uint64 segmentSize = m_inode.data[segmentIndex].count * zoneSize;
-		uint64 blockPosition = segmentPosition % g_sectorSize;
-		uint64 blockRemain = g_sectorSize - blockPosition;
 		uint32 segmentLba = m_reader.GetBlockLba(m_inode.data[segmentIndex].number, m_inode.data[segmentIndex].subPart);
-		uint64 toRead = std::min<uint64>(blockRemain, readRemain);
+		//Segments are contiguous on disk, read as much as we can from this one
+		uint64 toRead = std::min<uint64>(segmentSize - segmentPosition, readRemain);
 		m_stream.Seek((segmentLba * g_sectorSize) + segmentPosition, Framework::STREAM_SEEK_SET);
 		m_stream.Read(charBuffer, toRead);
 		readRemain -= toRead;
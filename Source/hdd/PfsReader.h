@@ -1,5 +1,6 @@
 #pragma once
 
+#include <unordered_map>
 #include "Stream.h"
 #include "HddDefs.h"
 #include "ApaDefs.h"
@@ -21,6 +22,14 @@ namespace Hdd
 		PFS_INODE ReadInode(uint32, uint32);
 
 	private:
+		enum
+		{
+			MAX_CACHED_INODES = 0x400,
+		};
+
+		//Key is made of the inode's sub partition (upper 32 bits) and number (lower 32 bits)
+		typedef std::unordered_map<uint64, PFS_INODE> InodeCache;
+
 		bool TryGetInodeFromPath(const char*, PFS_INODE&);
 
 		Framework::CStream& m_stream;
@@ -28,6 +37,8 @@ namespace Hdd
 		APA_HEADER m_partitionHeader = {};
 		PFS_SUPERBLOCK m_superBlock = {};
 		uint32 m_inodeScale = 0;
+
+		InodeCache m_inodeCache;
 	};
 
 	class CPfsFileReader : public Framework::CStream
@@ -49,6 +60,10 @@ namespace Hdd
 
 		uint64 m_position = 0;
 		bool m_isEof = false;
+
+		//Segment containing the last read position, saves walking the segments from the start on every read
+		uint32 m_segmentIndex = 1;
+		uint64 m_segmentStart = 0;
 	};
 
 	class CPfsDirectoryReader
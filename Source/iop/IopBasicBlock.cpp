@@ -0,0 +1,11 @@
+#include "IopBasicBlock.h"
+
+void CIopBasicBlock::CompileEpilog(CMipsJitter* jitter, bool loopsOnItself)
+{
+	if(IsIdleLoopBlock(false))
+	{
+		CompileIdleLoopCheck(jitter);
+	}
+
+	CBasicBlock::CompileEpilog(jitter, loopsOnItself);
+}
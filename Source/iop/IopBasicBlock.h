@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../BasicBlock.h"
+
+class CIopBasicBlock : public CBasicBlock
+{
+public:
+	using CBasicBlock::CBasicBlock;
+
+protected:
+	void CompileEpilog(CMipsJitter*, bool) override;
+};
@@ -150,6 +150,8 @@ void CIopBios::Reset(uint32 ramSize, const Iop::SifManPtr& sifMan)
 	//0xBE00000 = Stupid constant to make FFX PSF happy
 	CurrentTime() = 0xBE00000;
 	ThreadLinkHead() = 0;
+	m_threadReadyQueue.Reset();
+	m_threadReadyQueueDirty = false;
 	m_currentThreadId = -1;
 
 	m_cpu.m_State.nCOP0[CCOP_SCU::STATUS] |= CMIPS::STATUS_IE;
@@ -396,6 +398,9 @@ void CIopBios::LoadState(Framework::CZipArchiveReader& archive)
 
 	archive.BeginReadFile(STATE_MODULESTARTREQUESTS)->Read(m_moduleStartRequests, sizeof(m_moduleStartRequests));
 
+	//Thread list was replaced, ready queue will be rebuilt from it
+	m_threadReadyQueueDirty = true;
+
 #ifdef _IOP_EMULATE_MODULES
 	//Make sure HLE modules are properly registered
 	for(const auto& loadedModule : m_loadedModules)
@@ -1223,8 +1228,8 @@ int32 CIopBios::StartThreadArgs(uint32 threadId, uint32 args, uint32 argpPtr)
 	    };
 
 	thread->status = THREAD_STATUS_RUNNING;
-	LinkThread(threadId);
 	thread->priority = thread->initPriority;
+	LinkThread(threadId);
 	thread->context.epc = thread->threadProc;
 	thread->context.gpr[CMIPS::RA] = m_threadFinishAddress;
 	thread->context.gpr[CMIPS::SP] = thread->stackBase + thread->stackSize;
@@ -1797,7 +1802,9 @@ void CIopBios::SaveThreadContext(uint32 threadId)
 
 void CIopBios::LinkThread(uint32 threadId)
 {
+	SyncThreadReadyQueue();
 	auto thread = m_threads[threadId];
+	m_threadReadyQueue.Link(threadId, thread->priority, thread->nextActivateTime);
 	auto nextThreadId = &ThreadLinkHead();
 	while(1)
 	{
@@ -1821,6 +1828,8 @@ void CIopBios::LinkThread(uint32 threadId)
 
 void CIopBios::UnlinkThread(uint32 threadId)
 {
+	SyncThreadReadyQueue();
+	m_threadReadyQueue.Unlink(threadId);
 	THREAD* thread = m_threads[threadId];
 	uint32* nextThreadId = &ThreadLinkHead();
 	while(1)
@@ -1878,16 +1887,29 @@ void CIopBios::Reschedule()
 
 uint32 CIopBios::GetNextReadyThread()
 {
+	SyncThreadReadyQueue();
+	uint32 nextThreadId = m_threadReadyQueue.GetNextReady(GetCurrentTime());
+	if(nextThreadId == -1)
+	{
+		return -1;
+	}
+	FRAMEWORK_MAYBE_UNUSED auto nextThread = m_threads[nextThreadId];
+	assert(nextThread->status == THREAD_STATUS_RUNNING);
+	return nextThreadId;
+}
+
+void CIopBios::SyncThreadReadyQueue()
+{
+	if(!m_threadReadyQueueDirty) return;
+	m_threadReadyQueueDirty = false;
+	m_threadReadyQueue.Reset();
 	uint32 nextThreadId = ThreadLinkHead();
 	while(nextThreadId != 0)
 	{
-		THREAD* nextThread = m_threads[nextThreadId];
+		auto nextThread = m_threads[nextThreadId];
+		m_threadReadyQueue.Link(nextThreadId, nextThread->priority, nextThread->nextActivateTime);
 		nextThreadId = nextThread->nextThreadId;
-		if(GetCurrentTime() <= nextThread->nextActivateTime) continue;
-		assert(nextThread->status == THREAD_STATUS_RUNNING);
-		return nextThread->id;
 	}
-	return -1;
 }
 
 uint64 CIopBios::GetCurrentTime() const
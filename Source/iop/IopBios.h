@@ -11,6 +11,7 @@
 #include "../OsVariableWrapper.h"
 #include "Iop_BiosBase.h"
 #include "Iop_BiosStructs.h"
+#include "Iop_ThreadReadyQueue.h"
 #include "Iop_SifMan.h"
 #include "Iop_SifCmd.h"
 #include "Iop_Ioman.h"
@@ -614,6 +615,7 @@ private:
 	void UnlinkThread(uint32);
 
 	uint32& ThreadLinkHead() const;
+	void SyncThreadReadyQueue();
 	uint64& CurrentTime() const;
 	uint32& ModuleStartRequestHead() const;
 	uint32& ModuleStartRequestFree() const;
@@ -668,6 +670,8 @@ private:
 
 	bool m_rescheduleNeeded = false;
 	ThreadList m_threads;
+	Iop::CThreadReadyQueue m_threadReadyQueue;
+	bool m_threadReadyQueueDirty = true;
 	MemoryBlockList m_memoryBlocks;
 	SemaphoreList m_semaphores;
 	EventFlagList m_eventFlags;
@@ -0,0 +1,35 @@
+#include "IopExecutor.h"
+#include "IopBasicBlock.h"
+#include "AlignedAlloc.h"
+#include "xxhash.h"
+
+CIopExecutor::CIopExecutor(CMIPS& context, uint32 maxAddress)
+    : CGenericMipsExecutor(context, maxAddress, BLOCK_CATEGORY_PS2_IOP)
+{
+}
+
+BasicBlockPtr CIopExecutor::BlockFactory(CMIPS& context, uint32 start, uint32 end)
+{
+	auto result = std::make_shared<CIopBasicBlock>(context, start, end, m_blockCategory);
+	if(!m_sharedBlockCache || m_context.HasBreakpointInRange(start, end))
+	{
+		result->Compile();
+		return result;
+	}
+
+	uint32 blockSize = (end - start) + 4;
+	auto blockMemory = reinterpret_cast<uint32*>(alloca(blockSize));
+	for(uint32 address = start; address <= end; address += 4)
+	{
+		uint32 index = (address - start) / 4;
+		blockMemory[index] = m_context.m_pMemoryMap->GetInstruction(address);
+	}
+
+	auto xxHash = XXH3_128bits(blockMemory, blockSize);
+	uint128 hash;
+	memcpy(&hash, &xxHash, sizeof(xxHash));
+	static_assert(sizeof(hash) == sizeof(xxHash));
+
+	CompileSharedBlock(result.get(), hash, blockSize, 0);
+	return result;
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "../GenericMipsExecutor.h"
+
+class CIopExecutor : public CGenericMipsExecutor<BlockLookupOneWay>
+{
+public:
+	CIopExecutor(CMIPS&, uint32);
+	virtual ~CIopExecutor() = default;
+
+	BasicBlockPtr BlockFactory(CMIPS&, uint32, uint32) override;
+};
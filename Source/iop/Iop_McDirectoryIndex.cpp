@@ -0,0 +1,298 @@
+#include <algorithm>
+#include <cctype>
+#include "Iop_McDirectoryIndex.h"
+#include "FilesystemUtils.h"
+#include "../Log.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/inotify.h>
+#define HAS_HOST_WATCH
+#define HOST_WATCH_MASK (IN_CREATE | IN_DELETE | IN_MODIFY | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF)
+#endif
+
+#define LOG_NAME ("iop_mcdirectoryindex")
+
+using namespace Iop;
+
+bool CMcDirectoryIndex::NameLess::operator()(const std::string& name1, const std::string& name2) const
+{
+#if defined(_WIN32) || defined(__APPLE__)
+	//Host file systems are case insensitive by default on these platforms
+	return std::lexicographical_compare(name1.begin(), name1.end(), name2.begin(), name2.end(),
+	                                    [](char char1, char char2) {
+		                                    return tolower(static_cast<unsigned char>(char1)) < tolower(static_cast<unsigned char>(char2));
+	                                    });
+#else
+	return name1 < name2;
+#endif
+}
+
+CMcDirectoryIndex::~CMcDirectoryIndex()
+{
+	CloseHostWatch();
+}
+
+void CMcDirectoryIndex::SetBasePath(const fs::path& basePath)
+{
+	auto normalBasePath = fs::absolute(basePath).lexically_normal();
+	if(!normalBasePath.has_filename() && normalBasePath.has_relative_path())
+	{
+		//Remove trailing separator
+		normalBasePath = normalBasePath.parent_path();
+	}
+	if(normalBasePath == m_basePath) return;
+	m_basePath = normalBasePath;
+	Invalidate();
+}
+
+void CMcDirectoryIndex::SetHostWatchEnabled(bool hostWatchEnabled)
+{
+	if(m_hostWatchEnabled == hostWatchEnabled) return;
+	m_hostWatchEnabled = hostWatchEnabled;
+	Invalidate();
+}
+
+void CMcDirectoryIndex::Invalidate()
+{
+	m_valid = false;
+	m_root = NODE();
+	CloseHostWatch();
+}
+
+const CMcDirectoryIndex::NODE* CMcDirectoryIndex::FindNode(const fs::path& path)
+{
+	if(ReadHostEvents())
+	{
+		CLog::GetInstance().Print(LOG_NAME, "Host changes detected in '%s', rebuilding index.\r\n", m_basePath.string().c_str());
+		Invalidate();
+	}
+
+	if(!m_valid)
+	{
+		Build();
+		if(!m_valid) return nullptr;
+	}
+
+	PathComponentArray components;
+	if(!GetPathComponents(path, components)) return nullptr;
+
+	auto node = FindNodeInternal(components, components.size());
+	if(node && !node->isDirectory && !path.lexically_normal().has_filename())
+	{
+		//Trailing separator on a file name
+		return nullptr;
+	}
+	return node;
+}
+
+bool CMcDirectoryIndex::Exists(const fs::path& path)
+{
+	return FindNode(path) != nullptr;
+}
+
+bool CMcDirectoryIndex::IsDirectory(const fs::path& path)
+{
+	auto node = FindNode(path);
+	return node && node->isDirectory;
+}
+
+void CMcDirectoryIndex::UpdatePath(const fs::path& path)
+{
+	if(!m_valid) return;
+
+	PathComponentArray components;
+	if(!GetPathComponents(path, components)) return;
+
+	try
+	{
+		if(components.empty())
+		{
+			Invalidate();
+			return;
+		}
+
+		auto parentNode = FindNodeInternal(components, components.size() - 1);
+		if(!parentNode || !parentNode->isDirectory)
+		{
+			//Parent isn't in the index, start over
+			Invalidate();
+			return;
+		}
+
+		const auto& name = components.back();
+		auto hostPath = MakeHostPath(components, components.size());
+		if(fs::exists(hostPath))
+		{
+			ReadNode(parentNode->children[name], fs::directory_entry(hostPath));
+		}
+		else
+		{
+			parentNode->children.erase(name);
+		}
+
+		//Adding or removing entries changes the modification time of the parent
+		auto parentPath = MakeHostPath(components, components.size() - 1);
+		parentNode->modificationTime = Framework::ConvertFsTimeToSystemTime(fs::last_write_time(parentPath));
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to update index for '%s': %s.\r\n", path.string().c_str(), exception.what());
+		Invalidate();
+		return;
+	}
+
+	//Events generated by our own changes, index is already up to date
+	ReadHostEvents();
+}
+
+void CMcDirectoryIndex::UpdateFileWrite(const fs::path& path, uint64 endPosition)
+{
+	if(!m_valid) return;
+
+	PathComponentArray components;
+	if(!GetPathComponents(path, components)) return;
+
+	auto node = FindNodeInternal(components, components.size());
+	if(!node || node->isDirectory)
+	{
+		Invalidate();
+		return;
+	}
+
+	node->size = std::max(node->size, endPosition);
+	node->modificationTime = std::time(nullptr);
+
+	ReadHostEvents();
+}
+
+bool CMcDirectoryIndex::GetPathComponents(const fs::path& path, PathComponentArray& components) const
+{
+	auto relativePath = fs::absolute(path).lexically_normal().lexically_relative(m_basePath);
+	if(relativePath.empty())
+	{
+		//Not on the same root
+		return false;
+	}
+	for(const auto& pathComponent : relativePath)
+	{
+		auto name = pathComponent.string();
+		if(name.empty() || (name == ".")) continue;
+		if(name == "..") return false;
+		components.push_back(std::move(name));
+	}
+	return true;
+}
+
+CMcDirectoryIndex::NODE* CMcDirectoryIndex::FindNodeInternal(const PathComponentArray& components, size_t count)
+{
+	auto node = &m_root;
+	for(size_t i = 0; i < count; i++)
+	{
+		if(!node->isDirectory) return nullptr;
+		auto childIterator = node->children.find(components[i]);
+		if(childIterator == std::end(node->children)) return nullptr;
+		node = &childIterator->second;
+	}
+	return node;
+}
+
+fs::path CMcDirectoryIndex::MakeHostPath(const PathComponentArray& components, size_t count) const
+{
+	auto path = m_basePath;
+	for(size_t i = 0; i < count; i++)
+	{
+		path /= components[i];
+	}
+	return path;
+}
+
+void CMcDirectoryIndex::Build()
+{
+	m_root = NODE();
+	if(m_hostWatchEnabled)
+	{
+		OpenHostWatch();
+	}
+
+	try
+	{
+		//Base path is checked every time until it exists
+		if(!fs::is_directory(m_basePath)) return;
+		ReadNode(m_root, fs::directory_entry(m_basePath));
+		m_valid = true;
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to build index for '%s': %s.\r\n", m_basePath.string().c_str(), exception.what());
+		m_root = NODE();
+	}
+}
+
+void CMcDirectoryIndex::ReadNode(NODE& node, const fs::directory_entry& entry)
+{
+	node.isDirectory = entry.is_directory();
+	node.size = node.isDirectory ? 0 : entry.file_size();
+	node.modificationTime = Framework::ConvertFsTimeToSystemTime(entry.last_write_time());
+	node.children.clear();
+	if(node.isDirectory)
+	{
+		AddHostWatch(entry.path());
+		for(const auto& element : fs::directory_iterator(entry.path()))
+		{
+			ReadNode(node.children[element.path().filename().string()], element);
+		}
+	}
+}
+
+void CMcDirectoryIndex::OpenHostWatch()
+{
+	CloseHostWatch();
+#ifdef HAS_HOST_WATCH
+	m_hostWatchFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(m_hostWatchFd < 0)
+	{
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to initialize inotify, host changes won't be detected.\r\n");
+	}
+#else
+	CLog::GetInstance().Warn(LOG_NAME, "Host watching isn't supported on this platform, host changes won't be detected.\r\n");
+#endif
+}
+
+void CMcDirectoryIndex::CloseHostWatch()
+{
+#ifdef HAS_HOST_WATCH
+	if(m_hostWatchFd >= 0)
+	{
+		close(m_hostWatchFd);
+	}
+#endif
+	m_hostWatchFd = -1;
+}
+
+void CMcDirectoryIndex::AddHostWatch(const fs::path& path)
+{
+#ifdef HAS_HOST_WATCH
+	if(m_hostWatchFd < 0) return;
+	if(inotify_add_watch(m_hostWatchFd, path.c_str(), HOST_WATCH_MASK) < 0)
+	{
+		//Most likely reached the maximum number of watches
+		CLog::GetInstance().Warn(LOG_NAME, "Failed to watch '%s', host changes in it won't be detected.\r\n", path.string().c_str());
+	}
+#endif
+}
+
+bool CMcDirectoryIndex::ReadHostEvents()
+{
+	bool hasEvents = false;
+#ifdef HAS_HOST_WATCH
+	if(m_hostWatchFd < 0) return false;
+	//We don't care about what changed, only if something did
+	alignas(struct inotify_event) char eventBuffer[0x1000];
+	while(read(m_hostWatchFd, eventBuffer, sizeof(eventBuffer)) > 0)
+	{
+		hasEvents = true;
+	}
+#endif
+	return hasEvents;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+#include "Types.h"
+#include "filesystem_def.h"
+
+namespace Iop
+{
+	//In-memory copy of the directory tree of a memory card stored in a host folder.
+	//Built once on first use, then kept up to date by CMcServ when it modifies the card.
+	//Changes made by other programs are only seen after Invalidate, or right away if host
+	//watching is enabled (only available on Linux for now).
+	class CMcDirectoryIndex
+	{
+	public:
+		struct NameLess
+		{
+			bool operator()(const std::string&, const std::string&) const;
+		};
+
+		struct NODE
+		{
+			typedef std::map<std::string, NODE, NameLess> ChildMap;
+
+			bool isDirectory = false;
+			uint64 size = 0;
+			std::time_t modificationTime = 0;
+			//Keys are host file names
+			ChildMap children;
+		};
+
+		CMcDirectoryIndex() = default;
+		CMcDirectoryIndex(const CMcDirectoryIndex&) = delete;
+		virtual ~CMcDirectoryIndex();
+
+		CMcDirectoryIndex& operator=(const CMcDirectoryIndex&) = delete;
+
+		//Index is invalidated if the base path is different from the current one
+		void SetBasePath(const fs::path&);
+		void SetHostWatchEnabled(bool);
+		void Invalidate();
+
+		//Returns nullptr if path doesn't exist or is outside of the base path
+		const NODE* FindNode(const fs::path&);
+		bool Exists(const fs::path&);
+		bool IsDirectory(const fs::path&);
+
+		//Reads the path (and its parent directory) again from the host after it was modified
+		void UpdatePath(const fs::path&);
+		//Cheaper update for file writes, doesn't need to access the host
+		void UpdateFileWrite(const fs::path&, uint64);
+
+	private:
+		typedef std::vector<std::string> PathComponentArray;
+
+		bool GetPathComponents(const fs::path&, PathComponentArray&) const;
+		NODE* FindNodeInternal(const PathComponentArray&, size_t);
+		fs::path MakeHostPath(const PathComponentArray&, size_t) const;
+		void Build();
+		void ReadNode(NODE&, const fs::directory_entry&);
+
+		void OpenHostWatch();
+		void CloseHostWatch();
+		void AddHostWatch(const fs::path&);
+		bool ReadHostEvents();
+
+		fs::path m_basePath;
+		NODE m_root;
+		//Only valid if the base path exists
+		bool m_valid = false;
+		bool m_hostWatchEnabled = false;
+		int m_hostWatchFd = -1;
+	};
+}
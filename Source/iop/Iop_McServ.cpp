@@ -17,7 +17,6 @@
 #include "StdStreamUtils.h"
 #include "StringUtils.h"
 #include "MIPSAssembler.h"
-#include "FilesystemUtils.h"
 
 using namespace Iop;
 
@@ -60,6 +59,8 @@ CMcServ::CMcServ(CIopBios& bios, CSifMan& sifMan, CSifCmd& sifCmd, CSysmem& sysM
     , m_sysMem(sysMem)
     , m_ram(ram)
 {
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_MC_DIRECTORYINDEX_WATCH_ENABLED, false);
+
 	m_moduleDataAddr = m_sysMem.AllocateMemory(sizeof(MODULEDATA), 0, 0);
 	sifMan.RegisterModule(MODULE_ID, this);
 	BuildCustomCode();
@@ -78,6 +79,12 @@ void CMcServ::SetModuleVersion(unsigned int)
 	{
 		knownMemoryCard = false;
 	}
+
+	//Contents of memory cards might have changed while we weren't looking
+	for(auto& directoryIndex : m_directoryIndex)
+	{
+		directoryIndex.Invalidate();
+	}
 }
 
 const char* CMcServ::GetMcPathPreference(unsigned int port)
@@ -465,6 +472,7 @@ void CMcServ::Open(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, u
 			else
 			{
 				fs::create_directory(filePath);
+				UpdateDirectoryIndices(filePath);
 				result = 0;
 			}
 		}
@@ -484,6 +492,7 @@ void CMcServ::Open(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, u
 				try
 				{
 					Framework::CreateOutputStdStream(filePath.native());
+					UpdateDirectoryIndices(filePath);
 				}
 				catch(...)
 				{
@@ -500,6 +509,7 @@ void CMcServ::Open(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, u
 			{
 				//Create file (discard contents) if it exists
 				Framework::CreateOutputStdStream(filePath.native());
+				UpdateDirectoryIndices(filePath);
 			}
 		}
 
@@ -514,6 +524,7 @@ void CMcServ::Open(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, u
 				throw std::exception();
 			}
 			m_files[handle] = std::move(file);
+			m_filePaths[handle] = filePath;
 			ret[0] = handle;
 		}
 		catch(...)
@@ -541,6 +552,11 @@ void CMcServ::Close(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize,
 
 	file->Clear();
 
+	//Pick up anything that was left to be flushed when closing
+	auto& filePath = m_filePaths[cmd->handle];
+	UpdateDirectoryIndices(filePath);
+	filePath.clear();
+
 	ret[0] = 0;
 }
 
@@ -649,6 +665,8 @@ void CMcServ::Write(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize,
 
 	//Force flushing for games that read after write without seeking or flushing
 	file->Flush();
+
+	UpdateDirectoryIndicesFileWrite(m_filePaths[cmd->handle], file->Tell());
 }
 
 void CMcServ::Flush(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, uint8* ram)
@@ -734,7 +752,7 @@ void CMcServ::ChDir(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize,
 			assert(false);
 			result = RET_NO_ENTRY;
 		}
-		else if(fs::exists(hostPath) && fs::is_directory(hostPath))
+		else if(GetDirectoryIndex(cmd->port).IsDirectory(hostPath))
 		{
 			currentDirectory = newCurrentDirectory;
 			result = 0;
@@ -782,24 +800,28 @@ void CMcServ::GetDir(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize,
 			}
 			mcPath = fs::absolute(mcPath);
 
-			if(!fs::exists(mcPath))
+			auto& directoryIndex = GetDirectoryIndex(cmd->port);
+
+			auto searchPath = Iop::PathUtils::MakeHostPath(mcPath, cmd->name);
+			searchPath.remove_filename();
+			if(!directoryIndex.Exists(searchPath))
 			{
-				//Directory doesn't exist
+				//Specified directory doesn't exist, this is an error
 				ret[0] = RET_NO_ENTRY;
 				return;
 			}
 
-			auto searchPath = Iop::PathUtils::MakeHostPath(mcPath, cmd->name);
-			searchPath.remove_filename();
-			if(!fs::exists(searchPath))
+			//Looked up last since lookups can rebuild the index
+			auto baseNode = directoryIndex.FindNode(mcPath);
+			if(baseNode == nullptr)
 			{
-				//Specified directory doesn't exist, this is an error
+				//Directory doesn't exist
 				ret[0] = RET_NO_ENTRY;
 				return;
 			}
 
 			assert(*mcPath.string().rbegin() != '/');
-			m_pathFinder.Search(mcPath, cmd->name);
+			m_pathFinder.Search(*baseNode, cmd->name);
 		}
 
 		auto entries = (cmd->maxEntries > 0) ? reinterpret_cast<ENTRY*>(&ram[cmd->tableAddress]) : nullptr;
@@ -844,6 +866,8 @@ void CMcServ::SetFileInfo(uint32* args, uint32 argsSize, uint32* ret, uint32 ret
 				}
 
 				fs::rename(filePath1, filePath2);
+				UpdateDirectoryIndices(filePath1);
+				UpdateDirectoryIndices(filePath2);
 			}
 			catch(...)
 			{
@@ -881,6 +905,7 @@ void CMcServ::Delete(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize,
 		if(fs::exists(filePath))
 		{
 			fs::remove(filePath);
+			UpdateDirectoryIndices(filePath);
 			ret[0] = 0;
 		}
 		else
@@ -926,7 +951,7 @@ void CMcServ::GetEntSpace(uint32* args, uint32 argsSize, uint32* ret, uint32 ret
 
 	try
 	{
-		if(fs::exists(savePath) && fs::is_directory(savePath))
+		if(GetDirectoryIndex(cmd->port).IsDirectory(savePath))
 		{
 			// Arbitrarity number, allows Drakengard to detect MC
 			ret[0] = 0xFE;
@@ -1008,6 +1033,8 @@ void CMcServ::WriteFast(uint32* args, uint32 argsSize, uint32* ret, uint32 retSi
 
 	result += static_cast<uint32>(file->Write(dst, cmd->size));
 	ret[0] = result;
+
+	UpdateDirectoryIndicesFileWrite(m_filePaths[cmd->handle], file->Tell());
 }
 
 void CMcServ::Init(uint32* args, uint32 argsSize, uint32* ret, uint32 retSize, uint8* ram)
@@ -1144,6 +1171,34 @@ fs::path CMcServ::GetHostFilePath(unsigned int port, unsigned int slot, const ch
 	return Iop::PathUtils::MakeHostPath(mcPath, guestPath.c_str());
 }
 
+CMcDirectoryIndex& CMcServ::GetDirectoryIndex(unsigned int port)
+{
+	assert(port < MAX_PORTS);
+	auto& directoryIndex = m_directoryIndex[port];
+	directoryIndex.SetBasePath(CAppConfig::GetInstance().GetPreferencePath(m_mcPathPreference[port]));
+	directoryIndex.SetHostWatchEnabled(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_MC_DIRECTORYINDEX_WATCH_ENABLED));
+	return directoryIndex;
+}
+
+void CMcServ::UpdateDirectoryIndices(const fs::path& path)
+{
+	if(path.empty()) return;
+	//Both ports might be using the same host directory
+	for(auto& directoryIndex : m_directoryIndex)
+	{
+		directoryIndex.UpdatePath(path);
+	}
+}
+
+void CMcServ::UpdateDirectoryIndicesFileWrite(const fs::path& path, uint64 endPosition)
+{
+	if(path.empty()) return;
+	for(auto& directoryIndex : m_directoryIndex)
+	{
+		directoryIndex.UpdateFileWrite(path, endPosition);
+	}
+}
+
 void CMcServ::LoadState(Framework::CZipArchiveReader& archive)
 {
 	auto stateFile = CXmlStateFile(*archive.BeginReadFile(STATE_MEMCARDS_FILE));
@@ -1194,10 +1249,8 @@ void CMcServ::CPathFinder::Reset()
 	m_index = 0;
 }
 
-void CMcServ::CPathFinder::Search(const fs::path& basePath, const char* filter)
+void CMcServ::CPathFinder::Search(const CMcDirectoryIndex::NODE& baseNode, const char* filter)
 {
-	m_basePath = basePath;
-
 	std::string filterPathString = filter;
 
 	//Resolve relative paths (only when filter starts with one)
@@ -1254,7 +1307,7 @@ void CMcServ::CPathFinder::Search(const fs::path& basePath, const char* filter)
 		m_entries.push_back(entry);
 	}
 
-	SearchRecurse(m_basePath);
+	SearchRecurse(baseNode, std::string());
 }
 
 unsigned int CMcServ::CPathFinder::Read(ENTRY* entry, unsigned int size)
@@ -1273,43 +1326,42 @@ unsigned int CMcServ::CPathFinder::Read(ENTRY* entry, unsigned int size)
 	return readCount;
 }
 
-void CMcServ::CPathFinder::SearchRecurse(const fs::path& path)
+void CMcServ::CPathFinder::SearchRecurse(const CMcDirectoryIndex::NODE& node, const std::string& relativePath)
 {
 	bool found = false;
-	for(const auto& element : fs::directory_iterator(path))
+	for(const auto& childPair : node.children)
 	{
-		const auto& relativePath(element.path());
-		std::string relativePathString(relativePath.generic_string());
+		const auto& childName = childPair.first;
+		const auto& childNode = childPair.second;
 
-		//"Extract" a more appropriate relative path from the memory card point of view
-		relativePathString.erase(0, m_basePath.generic_string().size());
+		//Relative path from the memory card point of view
+		auto childRelativePath = relativePath + SEPARATOR_CHAR + childName;
 
 		//Attempt to match this against the filter
-		if(std::regex_match(relativePathString, m_filterExp))
+		if(std::regex_match(childRelativePath, m_filterExp))
 		{
 			//Fill in the information
 			ENTRY entry;
 			memset(&entry, 0, sizeof(entry));
 
-			auto entryName = DecodeMcName(relativePath.filename().string());
+			auto entryName = DecodeMcName(childName);
 			strncpy(reinterpret_cast<char*>(entry.name), entryName.c_str(), 0x1F);
 			entry.name[0x1F] = 0;
 
-			if(element.is_directory())
+			if(childNode.isDirectory)
 			{
-				entry.size = CountEntries(element);
+				entry.size = static_cast<uint32>(childNode.children.size());
 				entry.attributes = MC_FILE_ATTR_FOLDER;
 			}
 			else
 			{
-				entry.size = static_cast<uint32>(element.file_size());
+				entry.size = static_cast<uint32>(childNode.size);
 				entry.attributes = MC_FILE_0400 | MC_FILE_ATTR_EXISTS | MC_FILE_ATTR_CLOSED | MC_FILE_ATTR_FILE | MC_FILE_ATTR_READABLE | MC_FILE_ATTR_WRITEABLE | MC_FILE_ATTR_EXECUTABLE;
 			}
 
 			//Fill in modification date info
 			{
-				auto changeSystemTime = Framework::ConvertFsTimeToSystemTime(element.last_write_time());
-				auto localChangeDate = std::localtime(&changeSystemTime);
+				auto localChangeDate = std::localtime(&childNode.modificationTime);
 
 				entry.modificationTime.second = localChangeDate->tm_sec;
 				entry.modificationTime.minute = localChangeDate->tm_min;
@@ -1326,20 +1378,9 @@ void CMcServ::CPathFinder::SearchRecurse(const fs::path& path)
 			found = true;
 		}
 
-		if(element.is_directory() && !found)
+		if(childNode.isDirectory && !found)
 		{
-			SearchRecurse(element);
+			SearchRecurse(childNode, childRelativePath);
 		}
 	}
 }
-
-uint32 CMcServ::CPathFinder::CountEntries(const fs::path& path)
-{
-	uint32 entryCount = 0;
-	assert(fs::is_directory(path));
-	for(FRAMEWORK_MAYBE_UNUSED const auto& entry : fs::directory_iterator(path))
-	{
-		entryCount++;
-	}
-	return entryCount;
-}
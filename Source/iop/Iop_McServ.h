@@ -5,6 +5,7 @@
 #include <regex>
 #include "filesystem_def.h"
 #include "StdStream.h"
+#include "Iop_McDirectoryIndex.h"
 #include "Iop_Module.h"
 #include "Iop_SifMan.h"
 
@@ -181,17 +182,15 @@ namespace Iop
 			virtual ~CPathFinder();
 
 			void Reset();
-			void Search(const fs::path&, const char*);
+			void Search(const CMcDirectoryIndex::NODE&, const char*);
 			unsigned int Read(ENTRY*, unsigned int);
 
 		private:
 			typedef std::vector<ENTRY> EntryList;
 
-			void SearchRecurse(const fs::path&);
-			uint32 CountEntries(const fs::path&);
+			void SearchRecurse(const CMcDirectoryIndex::NODE&, const std::string&);
 
 			EntryList m_entries;
-			fs::path m_basePath;
 			std::regex m_filterExp;
 			unsigned int m_index;
 		};
@@ -227,6 +226,10 @@ namespace Iop
 		Framework::CStdStream* GetFileFromHandle(uint32);
 		fs::path GetHostFilePath(unsigned int, unsigned int, const char*) const;
 
+		CMcDirectoryIndex& GetDirectoryIndex(unsigned int);
+		void UpdateDirectoryIndices(const fs::path&);
+		void UpdateDirectoryIndicesFileWrite(const fs::path&, uint64);
+
 		CIopBios& m_bios;
 		CSifMan& m_sifMan;
 		CSifCmd& m_sifCmd;
@@ -238,9 +241,11 @@ namespace Iop
 		uint32 m_finishReadFastAddr = 0;
 		uint32 m_readFastAddr = 0;
 		Framework::CStdStream m_files[MAX_FILES];
+		fs::path m_filePaths[MAX_FILES];
 		static const char* m_mcPathPreference[MAX_PORTS];
 		std::string m_currentDirectory[MAX_PORTS];
 		CPathFinder m_pathFinder;
+		CMcDirectoryIndex m_directoryIndex[MAX_PORTS];
 
 		// Keeps track, if the memory card in
 		// a given slot has already been read,
@@ -1,6 +1,6 @@
 #include "Iop_SubSystem.h"
 #include "IopBios.h"
-#include "GenericMipsExecutor.h"
+#include "IopExecutor.h"
 #include "../psx/PsxBios.h"
 #include "../states/MemoryStateFile.h"
 #include "../states/RegisterStateFile.h"
@@ -50,7 +50,7 @@ CSubSystem::CSubSystem(bool ps2Mode)
 		m_bios = std::make_shared<CPsxBios>(m_cpu, m_ram, PS2::IOP_BASE_RAM_SIZE);
 	}
 
-	m_cpu.m_executor = std::make_unique<CGenericMipsExecutor<BlockLookupOneWay>>(m_cpu, (IOP_RAM_SIZE * 4), BLOCK_CATEGORY_PS2_IOP);
+	m_cpu.m_executor = std::make_unique<CIopExecutor>(m_cpu, (IOP_RAM_SIZE * 4));
 
 	//Read memory map
 	m_cpu.m_pMemoryMap->InsertReadMap((0 * IOP_RAM_SIZE), (0 * IOP_RAM_SIZE) + IOP_RAM_SIZE - 1, m_ram, 0x01);
@@ -109,12 +109,25 @@ void CSubSystem::NotifyVBlankEnd()
 	m_intc.AssertLine(Iop::CIntc::LINE_EVBLANK);
 }
 
-void CSubSystem::SaveState(Framework::CZipArchiveWriter& archive)
+StateMemoryRegionList CSubSystem::GetStateMemoryRegions() const
+{
+	return {
+	    {STATE_RAM, m_ram, IOP_RAM_SIZE},
+	    {STATE_SCRATCH, m_scratchPad, IOP_SCRATCH_SIZE},
+	    {STATE_SPURAM, m_spuRam, SPU_RAM_SIZE},
+	};
+}
+
+void CSubSystem::SaveState(Framework::CZipArchiveWriter& archive, bool saveMemoryRegions)
 {
 	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_CPU, &m_cpu.m_State, sizeof(MIPSSTATE)));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_RAM, m_ram, IOP_RAM_SIZE));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_SCRATCH, m_scratchPad, IOP_SCRATCH_SIZE));
-	archive.InsertFile(std::make_unique<CMemoryStateFile>(STATE_SPURAM, m_spuRam, SPU_RAM_SIZE));
+	if(saveMemoryRegions)
+	{
+		for(const auto& region : GetStateMemoryRegions())
+		{
+			SaveStateMemoryRegion(archive, region);
+		}
+	}
 	m_intc.SaveState(archive);
 	m_dmac.SaveState(archive);
 	m_counters.SaveState(archive);
@@ -136,29 +149,48 @@ void CSubSystem::SaveState(Framework::CZipArchiveWriter& archive)
 	}
 }
 
-void CSubSystem::LoadState(Framework::CZipArchiveReader& archive)
+void CSubSystem::LoadState(Framework::CZipArchiveReader& archive, const StateMemoryRegionSource& regionSource)
 {
 	m_bios->PreLoadState();
 
-	//Read and check differences in memory to invalidate executor blocks only if necessary
+	for(const auto& region : GetStateMemoryRegions())
 	{
-		auto stream = archive.BeginReadFile(STATE_RAM);
+		if(region.memory != m_ram)
+		{
+			LoadStateMemoryRegion(archive, region, regionSource);
+			continue;
+		}
+
+		//Read and check differences in memory to invalidate executor blocks only if necessary
 		static const uint32 bufferSize = 0x1000;
-		uint8 buffer[bufferSize];
-		for(uint32 i = 0; i < IOP_RAM_SIZE; i += bufferSize)
+		auto loadRamChunk = [&](uint32 offset, const uint8* buffer) {
+			if(memcmp(m_ram + offset, buffer, bufferSize))
+			{
+				m_cpu.m_executor->ClearActiveBlocksInRange(offset, offset + bufferSize, false);
+			}
+			memcpy(m_ram + offset, buffer, bufferSize);
+		};
+		if(regionSource)
+		{
+			auto source = regionSource(region);
+			for(uint32 i = 0; i < IOP_RAM_SIZE; i += bufferSize)
+			{
+				loadRamChunk(i, source + i);
+			}
+		}
+		else
 		{
-			stream->Read(buffer, bufferSize);
-			if(memcmp(m_ram + i, buffer, bufferSize))
+			auto stream = archive.BeginReadFile(STATE_RAM);
+			uint8 buffer[bufferSize];
+			for(uint32 i = 0; i < IOP_RAM_SIZE; i += bufferSize)
 			{
-				m_cpu.m_executor->ClearActiveBlocksInRange(i, i + bufferSize, false);
+				stream->Read(buffer, bufferSize);
+				loadRamChunk(i, buffer);
 			}
-			memcpy(m_ram + i, buffer, bufferSize);
 		}
 	}
 
 	archive.BeginReadFile(STATE_CPU)->Read(&m_cpu.m_State, sizeof(MIPSSTATE));
-	archive.BeginReadFile(STATE_SCRATCH)->Read(m_scratchPad, IOP_SCRATCH_SIZE);
-	archive.BeginReadFile(STATE_SPURAM)->Read(m_spuRam, SPU_RAM_SIZE);
 	m_intc.LoadState(archive);
 	m_dmac.LoadState(archive);
 	m_counters.LoadState(archive);
@@ -208,6 +240,7 @@ void CSubSystem::Reset()
 
 	m_dmaUpdateTicks = 0;
 	m_spuIrqUpdateTicks = 0;
+	m_isIdle = false;
 }
 
 void CSubSystem::SetupPageTable()
@@ -363,7 +396,7 @@ void CSubSystem::CheckPendingInterrupts()
 
 bool CSubSystem::IsCpuIdle()
 {
-	return m_bios->IsIdle();
+	return m_bios->IsIdle() || m_isIdle;
 }
 
 void CSubSystem::CountTicks(int ticks)
@@ -400,6 +433,7 @@ void CSubSystem::CountTicks(int ticks)
 
 int CSubSystem::ExecuteCpu(int quota)
 {
+	m_isIdle = false;
 	int executed = 0;
 	CheckPendingInterrupts();
 	if(!m_cpu.m_State.nHasException)
@@ -422,6 +456,12 @@ int CSubSystem::ExecuteCpu(int quota)
 			m_cpu.m_State.nHasException = MIPS_EXCEPTION_NONE;
 		}
 		break;
+		case MIPS_EXCEPTION_IDLE:
+		{
+			m_isIdle = true;
+			m_cpu.m_State.nHasException = MIPS_EXCEPTION_NONE;
+		}
+		break;
 		}
 		assert(m_cpu.m_State.nHasException == MIPS_EXCEPTION_NONE);
 	}
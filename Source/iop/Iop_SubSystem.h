@@ -16,6 +16,7 @@
 #include "Iop_Sio2.h"
 #include "zip/ZipArchiveWriter.h"
 #include "zip/ZipArchiveReader.h"
+#include "../states/StateMemoryRegion.h"
 
 namespace Iop
 {
@@ -33,8 +34,9 @@ namespace Iop
 		void NotifyVBlankStart();
 		void NotifyVBlankEnd();
 
-		void SaveState(Framework::CZipArchiveWriter&);
-		void LoadState(Framework::CZipArchiveReader&);
+		StateMemoryRegionList GetStateMemoryRegions() const;
+		void SaveState(Framework::CZipArchiveWriter&, bool saveMemoryRegions = true);
+		void LoadState(Framework::CZipArchiveReader&, const StateMemoryRegionSource& = StateMemoryRegionSource());
 
 		CMIPS m_cpu;
 		CMA_MIPSIV m_cpuArch;
@@ -77,5 +79,6 @@ namespace Iop
 
 		int m_dmaUpdateTicks = 0;
 		int m_spuIrqUpdateTicks = 0;
+		bool m_isIdle = false;
 	};
 }
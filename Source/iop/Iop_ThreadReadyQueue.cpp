@@ -0,0 +1,97 @@
+#include <cassert>
+#include "Iop_ThreadReadyQueue.h"
+
+using namespace Iop;
+
+void CThreadReadyQueue::Reset()
+{
+	m_entries.clear();
+	for(auto& readyQueue : m_readyQueues)
+	{
+		readyQueue.clear();
+	}
+	m_readyMask.fill(0);
+	m_timers = TimerHeap();
+	m_nextSequence = 0;
+}
+
+void CThreadReadyQueue::Link(uint32 threadId, uint32 priority, uint64 activateTime)
+{
+	assert(priority < MAX_PRIORITY);
+	if(threadId >= m_entries.size())
+	{
+		m_entries.resize(threadId + 1);
+	}
+	auto& entry = m_entries[threadId];
+	assert(!entry.linked);
+	entry.sequence = m_nextSequence++;
+	entry.activateTime = activateTime;
+	entry.priority = priority;
+	entry.linked = true;
+	entry.ready = false;
+
+	TIMER timer;
+	timer.activateTime = activateTime;
+	timer.sequence = entry.sequence;
+	timer.threadId = threadId;
+	m_timers.push(timer);
+}
+
+void CThreadReadyQueue::Unlink(uint32 threadId)
+{
+	if(threadId >= m_entries.size()) return;
+	auto& entry = m_entries[threadId];
+	if(!entry.linked) return;
+	if(entry.ready)
+	{
+		auto& readyQueue = m_readyQueues[entry.priority];
+		readyQueue.erase(entry.sequence);
+		if(readyQueue.empty())
+		{
+			m_readyMask[entry.priority / 64] &= ~(1ULL << (entry.priority % 64));
+		}
+	}
+	//Timer heap entry, if any, gets discarded when it expires
+	entry.linked = false;
+	entry.ready = false;
+}
+
+uint32 CThreadReadyQueue::GetNextReady(uint64 currentTime)
+{
+	WakeTimers(currentTime);
+	for(uint32 i = 0; i < m_readyMask.size(); i++)
+	{
+		if(m_readyMask[i] == 0) continue;
+		uint32 priority = (i * 64) + __builtin_ctzll(m_readyMask[i]);
+		const auto& readyQueue = m_readyQueues[priority];
+		assert(!readyQueue.empty());
+		return readyQueue.begin()->second;
+	}
+	return -1;
+}
+
+void CThreadReadyQueue::MakeReady(uint32 threadId)
+{
+	auto& entry = m_entries[threadId];
+	assert(entry.linked && !entry.ready);
+	entry.ready = true;
+	m_readyQueues[entry.priority].insert(std::make_pair(entry.sequence, threadId));
+	m_readyMask[entry.priority / 64] |= (1ULL << (entry.priority % 64));
+}
+
+void CThreadReadyQueue::WakeTimers(uint64 currentTime)
+{
+	//A thread is ready when the current time is strictly past its activation time
+	while(!m_timers.empty())
+	{
+		const auto& timer = m_timers.top();
+		if(currentTime <= timer.activateTime) break;
+		uint32 threadId = timer.threadId;
+		uint64 sequence = timer.sequence;
+		m_timers.pop();
+		const auto& entry = m_entries[threadId];
+		//Stale timer from a thread that was unlinked or relinked since
+		if(!entry.linked || entry.ready || (entry.sequence != sequence)) continue;
+		MakeReady(threadId);
+	}
+}
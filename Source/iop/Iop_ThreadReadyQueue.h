@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <map>
+#include <queue>
+#include <vector>
+#include "Types.h"
+
+namespace Iop
+{
+	//Host side index of the threads linked in the BIOS's thread list.
+	//The list in guest memory stays authoritative (it's part of save states), this only
+	//mirrors it to avoid walking it each time we need to find the next thread to run.
+	//Threads are ordered by priority, then by link order, like in the guest list.
+	//Threads that are linked but still waiting for their activation time are kept in
+	//a timer heap and moved to their priority queue when they become ready.
+	class CThreadReadyQueue
+	{
+	public:
+		enum
+		{
+			MAX_PRIORITY = 128,
+		};
+
+		void Reset();
+
+		void Link(uint32 threadId, uint32 priority, uint64 activateTime);
+		void Unlink(uint32 threadId);
+
+		//Returns -1 if no thread is ready
+		uint32 GetNextReady(uint64 currentTime);
+
+	private:
+		struct ENTRY
+		{
+			uint64 sequence = 0;
+			uint64 activateTime = 0;
+			uint32 priority = 0;
+			bool linked = false;
+			bool ready = false;
+		};
+
+		struct TIMER
+		{
+			uint64 activateTime = 0;
+			uint64 sequence = 0;
+			uint32 threadId = 0;
+
+			bool operator>(const TIMER& rhs) const
+			{
+				return activateTime > rhs.activateTime;
+			}
+		};
+
+		typedef std::map<uint64, uint32> PriorityQueue;
+		typedef std::priority_queue<TIMER, std::vector<TIMER>, std::greater<TIMER>> TimerHeap;
+
+		void MakeReady(uint32 threadId);
+		void WakeTimers(uint64 currentTime);
+
+		std::vector<ENTRY> m_entries;
+		std::array<PriorityQueue, MAX_PRIORITY> m_readyQueues;
+		std::array<uint64, MAX_PRIORITY / 64> m_readyMask = {};
+		TimerHeap m_timers;
+		uint64 m_nextSequence = 0;
+	};
+}
@@ -11,6 +11,7 @@ using namespace Iop::Ioman;
 
 CHardDiskDumpDevice::CHardDiskDumpDevice(std::unique_ptr<Framework::CStream> stream)
     : m_stream(std::move(stream))
+    , m_cacheStream(*m_stream)
 {
 }
 
@@ -18,7 +19,7 @@ Framework::CStream* CHardDiskDumpDevice::GetFile(uint32 flags, const char* path)
 {
 	assert(flags == OPEN_FLAG_RDONLY);
 	Hdd::APA_HEADER partitionHeader = {};
-	Hdd::CApaReader reader(*m_stream);
+	Hdd::CApaReader reader(m_cacheStream);
 	if(!reader.TryFindPartition(path, partitionHeader))
 	{
 		return nullptr;
@@ -29,7 +30,7 @@ Framework::CStream* CHardDiskDumpDevice::GetFile(uint32 flags, const char* path)
 DirectoryIteratorPtr CHardDiskDumpDevice::GetDirectory(const char* path)
 {
 	assert(strlen(path) == 0);
-	Hdd::CApaReader reader(*m_stream);
+	Hdd::CApaReader reader(m_cacheStream);
 	auto partitions = reader.GetPartitions();
 	return std::make_unique<CHardDiskDumpDirectoryIterator>(std::move(partitions));
 }
@@ -38,20 +39,20 @@ DevicePtr CHardDiskDumpDevice::Mount(const char* path)
 {
 	auto mountParams = StringUtils::Split(path, ',', true);
 	Hdd::APA_HEADER partitionHeader = {};
-	Hdd::CApaReader reader(*m_stream);
+	Hdd::CApaReader reader(m_cacheStream);
 	if(!reader.TryFindPartition(mountParams[0].c_str(), partitionHeader))
 	{
 		assert(false);
 		return DevicePtr();
 	}
-	return std::make_shared<CHardDiskDumpPartitionDevice>(*m_stream, partitionHeader);
+	return std::make_shared<CHardDiskDumpPartitionDevice>(m_cacheStream, partitionHeader);
 }
 
 bool CHardDiskDumpDevice::TryGetStat(const char* path, bool& succeeded, STAT& stat)
 {
 	auto mountParams = StringUtils::Split(path, ',', true);
 	Hdd::APA_HEADER partitionHeader = {};
-	Hdd::CApaReader reader(*m_stream);
+	Hdd::CApaReader reader(m_cacheStream);
 	if(!reader.TryFindPartition(mountParams[0].c_str(), partitionHeader))
 	{
 		succeeded = false;
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "../Ioman_Device.h"
+#include "hdd/BlockCacheStream.h"
 #include "hdd/PfsReader.h"
 
 namespace Iop
@@ -21,6 +22,8 @@ namespace Iop
 
 		private:
 			std::unique_ptr<Framework::CStream> m_stream;
+			//Shared by every partition mounted from this device
+			Hdd::CBlockCacheStream m_cacheStream;
 		};
 
 		class CHardDiskDumpDirectoryIterator : public CDirectoryIterator
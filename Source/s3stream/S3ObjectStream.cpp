@@ -1,5 +1,6 @@
 #include <cassert>
 #include <cstring>
+#include <algorithm>
 #include "S3ObjectStream.h"
 #include "amazon/AmazonS3Client.h"
 #include "Singleton.h"
@@ -11,16 +12,25 @@
 
 #define PREF_S3_OBJECTSTREAM_ACCESSKEYID "s3.objectstream.accesskeyid"
 #define PREF_S3_OBJECTSTREAM_SECRETACCESSKEY "s3.objectstream.secretaccesskey"
+#define PREF_S3_OBJECTSTREAM_CACHEBUDGET "s3.objectstream.cachebudget"
 #define CACHE_PATH "Play Data Files/s3objectstream_cache"
 
 #define LOG_NAME "s3objectstream"
 
 #define BUFFERSIZE 0x40000
 
+//Number of ranges fetched ahead of the one being read
+#define READAHEAD_RANGE_COUNT 8
+#define WORKER_COUNT 4
+#define MAX_FETCHED_RANGE_COUNT (READAHEAD_RANGE_COUNT + WORKER_COUNT)
+
+#define DEFAULT_CACHE_BUDGET 4096 //In megabytes
+
 CS3ObjectStream::CConfig::CConfig()
 {
 	CAppConfig::GetInstance().RegisterPreferenceString(PREF_S3_OBJECTSTREAM_ACCESSKEYID, "");
 	CAppConfig::GetInstance().RegisterPreferenceString(PREF_S3_OBJECTSTREAM_SECRETACCESSKEY, "");
+	CAppConfig::GetInstance().RegisterPreferenceInteger(PREF_S3_OBJECTSTREAM_CACHEBUDGET, DEFAULT_CACHE_BUDGET);
 }
 
 CAmazonCredentials CS3ObjectStream::CConfig::GetCredentials()
@@ -31,13 +41,41 @@ CAmazonCredentials CS3ObjectStream::CConfig::GetCredentials()
 	return credentials;
 }
 
+uint64 CS3ObjectStream::CConfig::GetCacheBudget()
+{
+	auto cacheBudget = CAppConfig::GetInstance().GetPreferenceInteger(PREF_S3_OBJECTSTREAM_CACHEBUDGET);
+	return static_cast<uint64>(std::max<int>(cacheBudget, 0)) * 1024 * 1024;
+}
+
 CS3ObjectStream::CS3ObjectStream(const char* bucketName, const char* objectKey)
     : m_bucketName(bucketName)
     , m_objectKey(objectKey)
+    , m_credentials(CConfig::GetInstance().GetCredentials())
 {
 	m_buffer.resize(BUFFERSIZE);
 	Framework::PathUtils::EnsurePathExists(GetCachePath());
 	GetObjectInfo();
+	m_rangeCount = static_cast<uint32>((m_objectSize + BUFFERSIZE - 1) / BUFFERSIZE);
+	OpenCacheFile();
+	EvictCache(GetCacheFilePath(), CConfig::GetInstance().GetCacheBudget());
+	for(uint32 i = 0; i < WORKER_COUNT; i++)
+	{
+		m_workers.emplace_back([this]() { WorkerThreadProc(); });
+	}
+}
+
+CS3ObjectStream::~CS3ObjectStream()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_workersEnd = true;
+		m_pendingRanges.clear();
+	}
+	m_rangeRequestCondition.notify_all();
+	for(auto& worker : m_workers)
+	{
+		worker.join();
+	}
 }
 
 uint64 CS3ObjectStream::Read(void* buffer, uint64 size)
@@ -109,9 +147,215 @@ fs::path CS3ObjectStream::GetCachePath()
 	return Framework::PathUtils::GetCachePath() / CACHE_PATH;
 }
 
-std::string CS3ObjectStream::GenerateReadCacheKey(const std::pair<uint64, uint64>& range) const
+uint64 CS3ObjectStream::GetCacheEntrySize(const fs::path& cacheFilePath)
+{
+	//Cache files are sparse, only count the ranges that were written
+	try
+	{
+		auto stream = Framework::CreateInputStdStream(cacheFilePath.native());
+		uint32 magic = stream.Read32();
+		uint32 version = stream.Read32();
+		if((magic == CACHE_MAGIC) && (version == CACHE_VERSION))
+		{
+			stream.Read64();
+			uint32 rangeSize = stream.Read32();
+			uint32 rangeCount = stream.Read32();
+			std::vector<uint8> rangeBitmap((rangeCount + 7) / 8);
+			if(stream.Read(rangeBitmap.data(), rangeBitmap.size()) == rangeBitmap.size())
+			{
+				uint64 cachedRangeCount = 0;
+				for(uint8 bitmapByte : rangeBitmap)
+				{
+					for(; bitmapByte != 0; bitmapByte &= (bitmapByte - 1))
+					{
+						cachedRangeCount++;
+					}
+				}
+				return cachedRangeCount * rangeSize;
+			}
+		}
+	}
+	catch(...)
+	{
+	}
+	return fs::file_size(cacheFilePath);
+}
+
+void CS3ObjectStream::EvictCache(const fs::path& currentCacheFilePath, uint64 cacheBudget)
+{
+	struct CACHE_ENTRY
+	{
+		fs::path path;
+		fs::file_time_type lastUseTime;
+		uint64 size = 0;
+	};
+
+	try
+	{
+		std::vector<CACHE_ENTRY> entries;
+		uint64 totalSize = 0;
+		for(const auto& directoryEntry : fs::directory_iterator(GetCachePath()))
+		{
+			if(!fs::is_regular_file(directoryEntry.path())) continue;
+			uint64 size = GetCacheEntrySize(directoryEntry.path());
+			totalSize += size;
+			//Object being opened is never evicted, even if it's over budget by itself
+			if(directoryEntry.path() == currentCacheFilePath) continue;
+			CACHE_ENTRY entry;
+			entry.path = directoryEntry.path();
+			entry.lastUseTime = fs::last_write_time(entry.path);
+			entry.size = size;
+			entries.push_back(std::move(entry));
+		}
+
+		std::sort(entries.begin(), entries.end(),
+		          [](const CACHE_ENTRY& lhs, const CACHE_ENTRY& rhs) { return lhs.lastUseTime < rhs.lastUseTime; });
+
+		for(const auto& entry : entries)
+		{
+			if(totalSize <= cacheBudget) break;
+			fs::remove(entry.path);
+			totalSize -= entry.size;
+		}
+	}
+	catch(const std::exception& exception)
+	{
+		CLog::GetInstance().Print(LOG_NAME, "Failed to evict cache: '%s'.\r\n", exception.what());
+	}
+}
+
+fs::path CS3ObjectStream::GetCacheFilePath() const
+{
+	return GetCachePath() / (m_objectEtag + ".cache");
+}
+
+uint64 CS3ObjectStream::GetCacheDataOffset() const
+{
+	uint64 headerSize = CACHE_HEADER_SIZE + m_cacheRangeBitmap.size();
+	return (headerSize + CACHE_DATA_ALIGNMENT - 1) & ~static_cast<uint64>(CACHE_DATA_ALIGNMENT - 1);
+}
+
+void CS3ObjectStream::OpenCacheFile()
+{
+	//The cache file has a header, a bitmap telling which ranges are available and all of the
+	//object's ranges at their natural position. Ranges are only written once fetched, leaving
+	//holes in the file for those that never were.
+	auto cacheFilePath = GetCacheFilePath();
+	uint32 rangeBitmapSize = (m_rangeCount + 7) / 8;
+	try
+	{
+		if(fs::exists(cacheFilePath))
+		{
+			auto stream = Framework::CreateUpdateExistingStdStream(cacheFilePath.native());
+			uint32 magic = stream.Read32();
+			uint32 version = stream.Read32();
+			uint64 objectSize = stream.Read64();
+			uint32 rangeSize = stream.Read32();
+			uint32 rangeCount = stream.Read32();
+			if((magic == CACHE_MAGIC) && (version == CACHE_VERSION) &&
+			   (objectSize == m_objectSize) && (rangeSize == BUFFERSIZE) && (rangeCount == m_rangeCount))
+			{
+				m_cacheRangeBitmap.resize(rangeBitmapSize);
+				if(stream.Read(m_cacheRangeBitmap.data(), rangeBitmapSize) == rangeBitmapSize)
+				{
+					m_cacheStream = std::move(stream);
+				}
+			}
+		}
+
+		if(m_cacheStream.IsEmpty())
+		{
+			{
+				auto stream = Framework::CreateOutputStdStream(cacheFilePath.native());
+				stream.Write32(CACHE_MAGIC);
+				stream.Write32(CACHE_VERSION);
+				stream.Write64(m_objectSize);
+				stream.Write32(BUFFERSIZE);
+				stream.Write32(m_rangeCount);
+				m_cacheRangeBitmap.assign(rangeBitmapSize, 0);
+				stream.Write(m_cacheRangeBitmap.data(), rangeBitmapSize);
+			}
+			m_cacheStream = Framework::CreateUpdateExistingStdStream(cacheFilePath.native());
+		}
+
+		//Modification time tells when the object was last used when evicting
+		fs::last_write_time(cacheFilePath, fs::file_time_type::clock::now());
+		m_cacheEnabled = true;
+	}
+	catch(const std::exception& exception)
+	{
+		//Not a problem if we failed to open cache, ranges will always be fetched
+		CLog::GetInstance().Print(LOG_NAME, "Failed to open cache: '%s'.\r\n", exception.what());
+		m_cacheStream.Clear();
+		m_cacheRangeBitmap.clear();
+	}
+}
+
+bool CS3ObjectStream::IsRangeCached(uint32 rangeIndex) const
+{
+	return m_cacheEnabled && (m_cacheRangeBitmap[rangeIndex / 8] & (1 << (rangeIndex % 8)));
+}
+
+bool CS3ObjectStream::ReadCachedRange(uint32 rangeIndex, uint8* buffer)
+{
+	std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
+	if(!IsRangeCached(rangeIndex)) return false;
+	try
+	{
+		auto range = GetRange(rangeIndex);
+		uint64 size = range.second - range.first + 1;
+		m_cacheStream.Seek(GetCacheDataOffset() + range.first, Framework::STREAM_SEEK_SET);
+		if(m_cacheStream.Read(buffer, size) != size)
+		{
+			throw std::runtime_error("Cached range is incomplete.");
+		}
+		return true;
+	}
+	catch(const std::exception& exception)
+	{
+		//Not a problem if we failed to read cache
+		DisableCache("Failed to read cache", exception);
+	}
+	return false;
+}
+
+void CS3ObjectStream::WriteCachedRange(uint32 rangeIndex, const RangeData& data)
+{
+	std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
+	if(!m_cacheEnabled) return;
+	try
+	{
+		auto range = GetRange(rangeIndex);
+		m_cacheStream.Seek(GetCacheDataOffset() + range.first, Framework::STREAM_SEEK_SET);
+		m_cacheStream.Write(data.data(), data.size());
+
+		//Bitmap is updated after the data, an interrupted write never leaves a range marked as available
+		uint8& rangeBitmapByte = m_cacheRangeBitmap[rangeIndex / 8];
+		rangeBitmapByte |= (1 << (rangeIndex % 8));
+		m_cacheStream.Seek(CACHE_HEADER_SIZE + (rangeIndex / 8), Framework::STREAM_SEEK_SET);
+		m_cacheStream.Write(&rangeBitmapByte, 1);
+		m_cacheStream.Flush();
+	}
+	catch(const std::exception& exception)
+	{
+		//Not a problem if we failed to write cache
+		DisableCache("Failed to write cache", exception);
+	}
+}
+
+void CS3ObjectStream::DisableCache(const char* message, const std::exception& exception)
 {
-	return string_format("%s-%llu-%llu", m_objectEtag.c_str(), range.first, range.second);
+	CLog::GetInstance().Print(LOG_NAME, "%s: '%s'.\r\n", message, exception.what());
+	m_cacheEnabled = false;
+	m_cacheStream.Clear();
+}
+
+std::pair<uint64, uint64> CS3ObjectStream::GetRange(uint32 rangeIndex) const
+{
+	uint64 position = static_cast<uint64>(rangeIndex) * BUFFERSIZE;
+	uint64 size = std::min<uint64>(BUFFERSIZE, m_objectSize - position);
+	assert(size > 0);
+	return std::make_pair(position, position + size - 1);
 }
 
 static std::string TrimQuotes(std::string input)
@@ -133,7 +377,7 @@ void CS3ObjectStream::GetObjectInfo()
 {
 	//Obtain bucket region
 	{
-		CAmazonS3Client client(CConfig::GetInstance().GetCredentials());
+		CAmazonS3Client client(m_credentials);
 
 		GetBucketLocationRequest request;
 		request.bucket = m_bucketName;
@@ -144,7 +388,7 @@ void CS3ObjectStream::GetObjectInfo()
 
 	//Obtain object info
 	{
-		CAmazonS3Client client(CConfig::GetInstance().GetCredentials(), m_bucketRegion);
+		CAmazonS3Client client(m_credentials, m_bucketRegion);
 
 		HeadObjectRequest request;
 		request.bucket = m_bucketName;
@@ -156,61 +400,134 @@ void CS3ObjectStream::GetObjectInfo()
 	}
 }
 
+void CS3ObjectStream::ScheduleRanges(uint32 rangeIndex, bool includeRange)
+{
+	//Ranges still waiting from a previous position aren't useful anymore and failed ones can be tried again
+	m_pendingRanges.clear();
+	m_failedRanges.clear();
+
+	auto isRangeFetched = [this](uint32 index) {
+		return (m_fetchingRanges.count(index) != 0) || (m_fetchedRanges.count(index) != 0);
+	};
+
+	if(includeRange && !isRangeFetched(rangeIndex))
+	{
+		m_pendingRanges.push_back(rangeIndex);
+	}
+
+	uint32 readAheadEnd = std::min<uint32>(rangeIndex + 1 + READAHEAD_RANGE_COUNT, m_rangeCount);
+	std::lock_guard<std::mutex> cacheLock(m_cacheMutex);
+	for(uint32 index = rangeIndex + 1; index < readAheadEnd; index++)
+	{
+		if(isRangeFetched(index) || IsRangeCached(index)) continue;
+		m_pendingRanges.push_back(index);
+	}
+}
+
 void CS3ObjectStream::SyncBuffer()
 {
-	m_bufferPosition = (m_objectPosition / BUFFERSIZE) * BUFFERSIZE;
+	uint32 rangeIndex = static_cast<uint32>(m_objectPosition / BUFFERSIZE);
+	m_bufferPosition = static_cast<uint64>(rangeIndex) * BUFFERSIZE;
+
+	bool cachedReadSucceeded = ReadCachedRange(rangeIndex, m_buffer.data());
+
+	std::unique_lock<std::mutex> lock(m_mutex);
+	ScheduleRanges(rangeIndex, !cachedReadSucceeded);
+	m_rangeRequestCondition.notify_all();
+	if(cachedReadSucceeded) return;
+
+	m_requestedRange = rangeIndex;
+	m_rangeReadyCondition.wait(lock, [&]() { return (m_fetchedRanges.count(rangeIndex) != 0) || (m_failedRanges.count(rangeIndex) != 0); });
+	m_requestedRange = ~0U;
+
+	auto failedRangeIterator = m_failedRanges.find(rangeIndex);
+	if(failedRangeIterator != m_failedRanges.end())
+	{
+		auto error = std::move(failedRangeIterator->second);
+		m_failedRanges.erase(failedRangeIterator);
+		m_bufferPosition = ~0ULL;
+		throw std::runtime_error(string_format("Failed to fetch object range: %s", error.c_str()));
+	}
+
+	auto fetchedRangeIterator = m_fetchedRanges.find(rangeIndex);
+	const auto& data = fetchedRangeIterator->second;
+	memcpy(m_buffer.data(), data.data(), data.size());
+	m_fetchedRanges.erase(fetchedRangeIterator);
+}
+
+void CS3ObjectStream::WorkerThreadProc()
+{
+	//Each worker keeps its client (and connection) for all of its requests
+	CAmazonS3Client client(m_credentials, m_bucketRegion);
+	while(1)
+	{
+		uint32 rangeIndex = 0;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_rangeRequestCondition.wait(lock, [this]() { return m_workersEnd || !m_pendingRanges.empty(); });
+			if(m_workersEnd) break;
+			rangeIndex = m_pendingRanges.front();
+			m_pendingRanges.pop_front();
+			m_fetchingRanges.insert(rangeIndex);
+		}
 
-	uint64 size = std::min<uint64>(BUFFERSIZE, m_objectSize - m_bufferPosition);
-	auto range = std::make_pair(m_bufferPosition, m_bufferPosition + size - 1);
-	auto readCacheFilePath = GetCachePath() / GenerateReadCacheKey(range);
+		auto range = GetRange(rangeIndex);
+		uint64 size = range.second - range.first + 1;
 
 #ifdef _TRACEGET
-	static FILE* output = fopen("getobject.log", "wb");
-	fprintf(output, "%ld,%ld,%ld\r\n", range.first, range.second, size);
-	fflush(output);
+		static FILE* output = fopen("getobject.log", "wb");
+		fprintf(output, "%ld,%ld,%ld\r\n", range.first, range.second, size);
+		fflush(output);
 #endif
 
-	bool cachedReadSucceeded =
-	    [&]() {
-		    try
-		    {
-			    if(fs::exists(readCacheFilePath))
-			    {
-				    auto readCacheFileStream = Framework::CreateInputStdStream(readCacheFilePath.native());
-				    FRAMEWORK_MAYBE_UNUSED auto cacheRead = readCacheFileStream.Read(m_buffer.data(), size);
-				    assert(cacheRead == size);
-				    return true;
-			    }
-		    }
-		    catch(const std::exception& exception)
-		    {
-			    //Not a problem if we failed to read cache
-			    CLog::GetInstance().Print(LOG_NAME, "Failed to read cache: '%s'.\r\n", exception.what());
-		    }
-		    return false;
-	    }();
-
-	if(!cachedReadSucceeded)
-	{
-		assert(size > 0);
-		CAmazonS3Client client(CConfig::GetInstance().GetCredentials(), m_bucketRegion);
-		GetObjectRequest request;
-		request.key = m_objectKey;
-		request.bucket = m_bucketName;
-		request.range = range;
-		auto objectContent = client.GetObject(request);
-		assert(objectContent.data.size() == size);
-		memcpy(m_buffer.data(), objectContent.data.data(), size);
-
+		RangeData data;
+		std::string error;
 		try
 		{
-			auto readCacheFileStream = Framework::CreateOutputStdStream(readCacheFilePath.native());
-			readCacheFileStream.Write(objectContent.data.data(), size);
+			GetObjectRequest request;
+			request.key = m_objectKey;
+			request.bucket = m_bucketName;
+			request.range = range;
+			auto objectContent = client.GetObject(request);
+			if(objectContent.data.size() != size)
+			{
+				throw std::runtime_error("Received range size doesn't match.");
+			}
+			data.assign(objectContent.data.begin(), objectContent.data.end());
 		}
 		catch(const std::exception& exception)
 		{
-			//Not a problem if we failed to write cache
-			CLog::GetInstance().Print(LOG_NAME, "Failed to write cache: '%s'.\r\n", exception.what());
+			error = exception.what();
+		}
+
+		if(error.empty())
+		{
+			WriteCachedRange(rangeIndex, data);
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_fetchingRanges.erase(rangeIndex);
+			if(!error.empty())
+			{
+				m_failedRanges[rangeIndex] = std::move(error);
+			}
+			else
+			{
+				m_fetchedRanges[rangeIndex] = std::move(data);
+				//Drop ranges that were fetched ahead but never read, except the one being waited for
+				for(auto rangeIterator = m_fetchedRanges.begin();
+				    (m_fetchedRanges.size() > MAX_FETCHED_RANGE_COUNT) && (rangeIterator != m_fetchedRanges.end());)
+				{
+					if(rangeIterator->first == m_requestedRange)
+					{
+						rangeIterator++;
+						continue;
+					}
+					rangeIterator = m_fetchedRanges.erase(rangeIterator);
+				}
+			}
 		}
+		m_rangeReadyCondition.notify_all();
 	}
 }
@@ -1,8 +1,15 @@
 #pragma once
 
 #include <vector>
+#include <deque>
+#include <map>
+#include <set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "Singleton.h"
 #include "Stream.h"
+#include "StdStream.h"
 #include "filesystem_def.h"
 #include "amazon/AmazonS3Client.h"
 
@@ -14,9 +21,11 @@ public:
 	public:
 		CConfig();
 		CAmazonCredentials GetCredentials();
+		uint64 GetCacheBudget();
 	};
 
 	CS3ObjectStream(const char*, const char*);
+	virtual ~CS3ObjectStream();
 
 	uint64 Read(void*, uint64) override;
 	uint64 Write(const void*, uint64) override;
@@ -25,21 +34,66 @@ public:
 	bool IsEOF() override;
 
 private:
+	typedef std::vector<uint8> RangeData;
+
+	enum
+	{
+		CACHE_MAGIC = 0x434F3353, //'S3OC'
+		CACHE_VERSION = 1,
+		CACHE_HEADER_SIZE = 0x18,
+		CACHE_DATA_ALIGNMENT = 0x1000,
+	};
+
 	static fs::path GetCachePath();
-	std::string GenerateReadCacheKey(const std::pair<uint64, uint64>&) const;
+	static uint64 GetCacheEntrySize(const fs::path&);
+	static void EvictCache(const fs::path&, uint64);
+
+	fs::path GetCacheFilePath() const;
+	uint64 GetCacheDataOffset() const;
+	void OpenCacheFile();
+	bool IsRangeCached(uint32) const;
+	bool ReadCachedRange(uint32, uint8*);
+	void WriteCachedRange(uint32, const RangeData&);
+	void DisableCache(const char*, const std::exception&);
+
+	std::pair<uint64, uint64> GetRange(uint32) const;
 	void GetObjectInfo();
+	void ScheduleRanges(uint32, bool);
 	void SyncBuffer();
 
+	void WorkerThreadProc();
+
 	std::string m_bucketName;
 	std::string m_bucketRegion;
 	std::string m_objectKey;
+	CAmazonCredentials m_credentials;
 
 	//Object Metadata
 	uint64 m_objectSize = 0;
 	std::string m_objectEtag;
+	uint32 m_rangeCount = 0;
 
 	uint64 m_objectPosition = 0;
 
 	std::vector<uint8> m_buffer;
 	uint64 m_bufferPosition = ~0ULL;
+
+	//Shared with the workers, guarded by m_mutex
+	std::mutex m_mutex;
+	std::condition_variable m_rangeReadyCondition;
+	std::condition_variable m_rangeRequestCondition;
+	std::deque<uint32> m_pendingRanges;
+	std::set<uint32> m_fetchingRanges;
+	std::map<uint32, RangeData> m_fetchedRanges;
+	std::map<uint32, std::string> m_failedRanges;
+	uint32 m_requestedRange = ~0U;
+	bool m_workersEnd = false;
+
+	//Guarded by m_cacheMutex, taken after m_mutex when both are needed
+	std::mutex m_cacheMutex;
+	Framework::CStdStream m_cacheStream;
+	std::vector<uint8> m_cacheRangeBitmap;
+	bool m_cacheEnabled = false;
+
+	std::vector<std::thread> m_workers;
 };
@@ -0,0 +1,181 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include "RewindBuffer.h"
+
+void CRewindBuffer::SetMemoryBudget(uint64 memoryBudget)
+{
+	m_memoryBudget = memoryBudget;
+	EnforceMemoryBudget();
+}
+
+uint64 CRewindBuffer::GetMemoryBudget() const
+{
+	return m_memoryBudget;
+}
+
+uint64 CRewindBuffer::GetMemoryUsage() const
+{
+	return m_archiveData.size() + m_regionsSize + m_deltasSize;
+}
+
+void CRewindBuffer::Clear()
+{
+	m_hasState = false;
+	m_archiveData.clear();
+	m_regions.clear();
+	m_regionsSize = 0;
+	m_deltas.clear();
+	m_deltasSize = 0;
+}
+
+bool CRewindBuffer::IsEmpty() const
+{
+	return !m_hasState;
+}
+
+uint32 CRewindBuffer::GetStateCount() const
+{
+	return m_hasState ? static_cast<uint32>(m_deltas.size() + 1) : 0;
+}
+
+uint64 CRewindBuffer::Capture(ArchiveData archiveData, const StateMemoryRegionList& regions)
+{
+	if(!m_hasState || !IsCompatible(regions))
+	{
+		Clear();
+		m_regions.reserve(regions.size());
+		for(const auto& region : regions)
+		{
+			REGION rewindRegion;
+			rewindRegion.name = region.name;
+			rewindRegion.contents.assign(region.memory, region.memory + region.size);
+			m_regions.push_back(std::move(rewindRegion));
+			m_regionsSize += region.size;
+		}
+		m_archiveData = std::move(archiveData);
+		m_hasState = true;
+		EnforceMemoryBudget();
+		return GetMemoryUsage();
+	}
+
+	DELTA delta;
+	delta.archiveData = std::move(m_archiveData);
+	delta.size = delta.archiveData.size();
+	delta.regions.resize(regions.size());
+	try
+	{
+		for(uint32 regionIndex = 0; regionIndex < regions.size(); regionIndex++)
+		{
+			const auto& region = regions[regionIndex];
+			uint8* previousContents = m_regions[regionIndex].contents.data();
+			auto& deltaRegion = delta.regions[regionIndex];
+
+			//Only the pages that changed since the previous capture are touched past this compare
+			uint32 dirtySize = StatePageUtils::FindDirtyPages(region.memory, previousContents, region.size, deltaRegion.dirtyPages);
+			if(dirtySize != 0)
+			{
+				//XOR the previous pages in place, compress them, then bring them up to date
+				StatePageUtils::ForEachDirtyPage(deltaRegion.dirtyPages, region.size,
+				                                 [&](uint32 offset, uint32 pageSize) {
+					                                 uint8* previousPage = previousContents + offset;
+					                                 const uint8* currentPage = region.memory + offset;
+					                                 for(uint32 i = 0; i < pageSize; i++)
+					                                 {
+						                                 previousPage[i] ^= currentPage[i];
+					                                 }
+				                                 });
+				deltaRegion.data = StatePageUtils::CompressPages(previousContents, region.size, deltaRegion.dirtyPages, dirtySize);
+				StatePageUtils::ForEachDirtyPage(deltaRegion.dirtyPages, region.size,
+				                                 [&](uint32 offset, uint32 pageSize) {
+					                                 memcpy(previousContents + offset, region.memory + offset, pageSize);
+				                                 });
+			}
+
+			delta.size += deltaRegion.data.size() + (deltaRegion.dirtyPages.size() * sizeof(uint64));
+		}
+	}
+	catch(...)
+	{
+		//Latest state was already partly updated, history can't be trusted anymore
+		Clear();
+		throw;
+	}
+
+	uint64 deltaSize = delta.size;
+	m_archiveData = std::move(archiveData);
+	m_deltas.push_back(std::move(delta));
+	m_deltasSize += deltaSize;
+	EnforceMemoryBudget();
+	return deltaSize;
+}
+
+const CRewindBuffer::ArchiveData& CRewindBuffer::GetArchiveData() const
+{
+	assert(m_hasState);
+	return m_archiveData;
+}
+
+const uint8* CRewindBuffer::GetRegionContents(const STATE_MEMORY_REGION& region) const
+{
+	assert(m_hasState);
+	auto regionIterator = std::find_if(std::begin(m_regions), std::end(m_regions),
+	                                   [&region](const REGION& rewindRegion) { return rewindRegion.name == region.name; });
+	if((regionIterator == std::end(m_regions)) || (regionIterator->contents.size() != region.size))
+	{
+		throw std::runtime_error("Rewind state doesn't match memory region.");
+	}
+	return regionIterator->contents.data();
+}
+
+void CRewindBuffer::StepBack()
+{
+	if(m_deltas.empty()) return;
+
+	auto& delta = m_deltas.back();
+	try
+	{
+		for(uint32 regionIndex = 0; regionIndex < m_regions.size(); regionIndex++)
+		{
+			auto& contents = m_regions[regionIndex].contents;
+			const auto& deltaRegion = delta.regions[regionIndex];
+			if(deltaRegion.data.empty()) continue;
+			StatePageUtils::DecompressPages(contents.data(), static_cast<uint32>(contents.size()), deltaRegion.dirtyPages, deltaRegion.data, true);
+		}
+	}
+	catch(...)
+	{
+		Clear();
+		throw;
+	}
+
+	m_archiveData = std::move(delta.archiveData);
+	m_deltasSize -= delta.size;
+	m_deltas.pop_back();
+}
+
+bool CRewindBuffer::IsCompatible(const StateMemoryRegionList& regions) const
+{
+	if(regions.size() != m_regions.size()) return false;
+	for(uint32 regionIndex = 0; regionIndex < regions.size(); regionIndex++)
+	{
+		const auto& region = regions[regionIndex];
+		const auto& rewindRegion = m_regions[regionIndex];
+		if((rewindRegion.name != region.name) || (rewindRegion.contents.size() != region.size))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void CRewindBuffer::EnforceMemoryBudget()
+{
+	//Oldest states can be dropped since newer ones don't depend on them
+	while(!m_deltas.empty() && (GetMemoryUsage() > m_memoryBudget))
+	{
+		m_deltasSize -= m_deltas.front().size;
+		m_deltas.pop_front();
+	}
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <vector>
+#include "Types.h"
+#include "StateMemoryRegion.h"
+#include "StatePageUtils.h"
+
+//Keeps a bounded history of machine states to allow going back in time.
+//
+//The latest state is kept uncompressed. Every older state is kept as the XOR of its memory
+//pages with the ones of the state that followed it. Only pages that changed are stored and
+//their XOR is mostly zeros, which compresses very well. Oldest states are dropped when the
+//buffer gets over its memory budget.
+class CRewindBuffer
+{
+public:
+	typedef std::vector<uint8> ArchiveData;
+
+	CRewindBuffer() = default;
+	virtual ~CRewindBuffer() = default;
+
+	//The budget includes the latest state, which is always kept
+	void SetMemoryBudget(uint64);
+	uint64 GetMemoryBudget() const;
+	uint64 GetMemoryUsage() const;
+
+	void Clear();
+	bool IsEmpty() const;
+	uint32 GetStateCount() const;
+
+	//Returns the amount of memory needed to keep the previous state
+	uint64 Capture(ArchiveData, const StateMemoryRegionList&);
+
+	//Latest state
+	const ArchiveData& GetArchiveData() const;
+	const uint8* GetRegionContents(const STATE_MEMORY_REGION&) const;
+
+	//Drops the latest state, making the one before it the latest. The oldest state is never dropped.
+	void StepBack();
+
+private:
+	struct REGION
+	{
+		std::string name;
+		std::vector<uint8> contents;
+	};
+
+	struct DELTA_REGION
+	{
+		StatePageUtils::DirtyPageArray dirtyPages;
+		std::vector<uint8> data;
+	};
+
+	struct DELTA
+	{
+		ArchiveData archiveData;
+		std::vector<DELTA_REGION> regions;
+		uint64 size = 0;
+	};
+
+	bool IsCompatible(const StateMemoryRegionList&) const;
+	void EnforceMemoryBudget();
+
+	uint64 m_memoryBudget = 0;
+	bool m_hasState = false;
+	ArchiveData m_archiveData;
+	std::vector<REGION> m_regions;
+	uint64 m_regionsSize = 0;
+	std::deque<DELTA> m_deltas;
+	uint64 m_deltasSize = 0;
+};
@@ -0,0 +1,20 @@
+#include <cstring>
+#include "StateMemoryRegion.h"
+#include "MemoryStateFile.h"
+
+void SaveStateMemoryRegion(Framework::CZipArchiveWriter& archive, const STATE_MEMORY_REGION& region)
+{
+	archive.InsertFile(std::make_unique<CMemoryStateFile>(region.name, region.memory, region.size));
+}
+
+void LoadStateMemoryRegion(Framework::CZipArchiveReader& archive, const STATE_MEMORY_REGION& region, const StateMemoryRegionSource& regionSource)
+{
+	if(regionSource)
+	{
+		memcpy(region.memory, regionSource(region), region.size);
+	}
+	else
+	{
+		archive.BeginReadFile(region.name)->Read(region.memory, region.size);
+	}
+}
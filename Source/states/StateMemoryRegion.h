@@ -0,0 +1,25 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "Types.h"
+#include "zip/ZipArchiveWriter.h"
+#include "zip/ZipArchiveReader.h"
+
+//Large memory block that is part of the machine state (RAM, VU memories, etc.). These are
+//exposed separately so that snapshots can store them without going through a state archive.
+struct STATE_MEMORY_REGION
+{
+	const char* name = nullptr;
+	uint8* memory = nullptr;
+	uint32 size = 0;
+};
+
+typedef std::vector<STATE_MEMORY_REGION> StateMemoryRegionList;
+
+//Provides the contents of a region when loading a state archive that doesn't hold them.
+//The returned buffer must be as large as the region and stay valid until the next call.
+typedef std::function<const uint8*(const STATE_MEMORY_REGION&)> StateMemoryRegionSource;
+
+void SaveStateMemoryRegion(Framework::CZipArchiveWriter&, const STATE_MEMORY_REGION&);
+void LoadStateMemoryRegion(Framework::CZipArchiveReader&, const STATE_MEMORY_REGION&, const StateMemoryRegionSource&);
@@ -0,0 +1,107 @@
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include "maybe_unused.h"
+#include "zstd_zlibwrapper.h"
+#include "StatePageUtils.h"
+
+uint32 StatePageUtils::GetPageCount(uint32 size)
+{
+	return (size + STATE_PAGE_SIZE - 1) / STATE_PAGE_SIZE;
+}
+
+bool StatePageUtils::IsPageDirty(const DirtyPageArray& dirtyPages, uint32 pageIndex)
+{
+	return (dirtyPages[pageIndex / 64] & (1ULL << (pageIndex % 64))) != 0;
+}
+
+uint32 StatePageUtils::FindDirtyPages(const uint8* memory, const uint8* reference, uint32 size, DirtyPageArray& dirtyPages)
+{
+	uint32 pageCount = GetPageCount(size);
+	uint32 dirtySize = 0;
+	dirtyPages.assign((pageCount + 63) / 64, 0);
+	for(uint32 pageIndex = 0; pageIndex < pageCount; pageIndex++)
+	{
+		uint32 offset = pageIndex * STATE_PAGE_SIZE;
+		uint32 pageSize = std::min<uint32>(STATE_PAGE_SIZE, size - offset);
+		if(memcmp(memory + offset, reference + offset, pageSize))
+		{
+			dirtyPages[pageIndex / 64] |= (1ULL << (pageIndex % 64));
+			dirtySize += pageSize;
+		}
+	}
+	return dirtySize;
+}
+
+std::vector<uint8> StatePageUtils::CompressPages(const uint8* memory, uint32 size, const DirtyPageArray& dirtyPages, uint32 dirtySize)
+{
+	z_stream stream = {};
+	if(deflateInit(&stream, Z_BEST_SPEED) != Z_OK)
+	{
+		throw std::runtime_error("Failed to initialize page compression.");
+	}
+
+	//Output buffer is large enough to never run out of space
+	std::vector<uint8> result(deflateBound(&stream, dirtySize));
+	stream.next_out = result.data();
+	stream.avail_out = static_cast<uInt>(result.size());
+
+	ForEachDirtyPage(dirtyPages, size,
+	                 [&](uint32 offset, uint32 pageSize) {
+		                 stream.next_in = const_cast<Bytef*>(memory + offset);
+		                 stream.avail_in = pageSize;
+		                 FRAMEWORK_MAYBE_UNUSED int deflateResult = deflate(&stream, Z_NO_FLUSH);
+		                 assert((deflateResult == Z_OK) && (stream.avail_in == 0));
+	                 });
+
+	int finishResult = deflate(&stream, Z_FINISH);
+	result.resize(stream.total_out);
+	deflateEnd(&stream);
+
+	if(finishResult != Z_STREAM_END)
+	{
+		throw std::runtime_error("Failed to compress pages.");
+	}
+
+	return result;
+}
+
+void StatePageUtils::DecompressPages(uint8* memory, uint32 size, const DirtyPageArray& dirtyPages, const std::vector<uint8>& data, bool xorPages)
+{
+	z_stream stream = {};
+	if(inflateInit(&stream) != Z_OK)
+	{
+		throw std::runtime_error("Failed to initialize page decompression.");
+	}
+
+	stream.next_in = const_cast<Bytef*>(data.data());
+	stream.avail_in = static_cast<uInt>(data.size());
+
+	bool succeeded = true;
+	uint8 pageBuffer[STATE_PAGE_SIZE];
+	ForEachDirtyPage(dirtyPages, size,
+	                 [&](uint32 offset, uint32 pageSize) {
+		                 stream.next_out = xorPages ? pageBuffer : (memory + offset);
+		                 stream.avail_out = pageSize;
+		                 while(succeeded && (stream.avail_out != 0))
+		                 {
+			                 int result = inflate(&stream, Z_SYNC_FLUSH);
+			                 succeeded = (result == Z_OK) || ((result == Z_STREAM_END) && (stream.avail_out == 0));
+		                 }
+		                 if(succeeded && xorPages)
+		                 {
+			                 uint8* page = memory + offset;
+			                 for(uint32 i = 0; i < pageSize; i++)
+			                 {
+				                 page[i] ^= pageBuffer[i];
+			                 }
+		                 }
+	                 });
+
+	inflateEnd(&stream);
+
+	if(!succeeded)
+	{
+		throw std::runtime_error("Failed to decompress pages.");
+	}
+}
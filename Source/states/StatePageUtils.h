@@ -0,0 +1,39 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "Types.h"
+
+//Helpers for state captures that only keep the pages of memory regions that changed.
+//Dirty pages are tracked with one bit per page, their contents are stored compressed back to back.
+namespace StatePageUtils
+{
+	enum
+	{
+		STATE_PAGE_SIZE = 0x1000,
+	};
+
+	typedef std::vector<uint64> DirtyPageArray;
+
+	uint32 GetPageCount(uint32);
+	bool IsPageDirty(const DirtyPageArray&, uint32);
+
+	template <typename PageHandlerType>
+	void ForEachDirtyPage(const DirtyPageArray& dirtyPages, uint32 size, const PageHandlerType& pageHandler)
+	{
+		uint32 pageCount = GetPageCount(size);
+		for(uint32 pageIndex = 0; pageIndex < pageCount; pageIndex++)
+		{
+			if(!IsPageDirty(dirtyPages, pageIndex)) continue;
+			uint32 offset = pageIndex * STATE_PAGE_SIZE;
+			pageHandler(offset, std::min<uint32>(STATE_PAGE_SIZE, size - offset));
+		}
+	}
+
+	//Marks the pages that differ between both memory blocks, returns the total size of those pages
+	uint32 FindDirtyPages(const uint8*, const uint8*, uint32, DirtyPageArray&);
+
+	std::vector<uint8> CompressPages(const uint8*, uint32, const DirtyPageArray&, uint32);
+	//Pages are either copied over the memory block or XORed with its contents
+	void DecompressPages(uint8*, uint32, const DirtyPageArray&, const std::vector<uint8>&, bool);
+}
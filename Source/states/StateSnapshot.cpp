@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+#include "StateSnapshot.h"
+#include "StatePageUtils.h"
+
+CStateSnapshot::SnapshotPtr CStateSnapshot::CreateFull(ArchiveData archiveData, const StateMemoryRegionList& regions)
+{
+	auto snapshot = std::shared_ptr<CStateSnapshot>(new CStateSnapshot());
+	snapshot->m_archiveData = std::move(archiveData);
+	snapshot->m_regions.reserve(regions.size());
+	for(const auto& region : regions)
+	{
+		REGION snapshotRegion;
+		snapshotRegion.name = region.name;
+		snapshotRegion.size = region.size;
+		snapshotRegion.data.assign(region.memory, region.memory + region.size);
+		snapshot->m_regions.push_back(std::move(snapshotRegion));
+		snapshot->m_pageCount += StatePageUtils::GetPageCount(region.size);
+	}
+	snapshot->m_dirtyPageCount = snapshot->m_pageCount;
+	return snapshot;
+}
+
+CStateSnapshot::SnapshotPtr CStateSnapshot::CreateDelta(ArchiveData archiveData, const StateMemoryRegionList& regions, const SnapshotPtr& base)
+{
+	assert(base);
+	if(!base->IsFull() || !base->IsCompatible(regions))
+	{
+		throw std::runtime_error("Snapshot base doesn't match memory regions.");
+	}
+
+	auto snapshot = std::shared_ptr<CStateSnapshot>(new CStateSnapshot());
+	snapshot->m_archiveData = std::move(archiveData);
+	snapshot->m_base = base;
+	snapshot->m_pageCount = base->m_pageCount;
+	snapshot->m_regions.reserve(regions.size());
+	for(uint32 regionIndex = 0; regionIndex < regions.size(); regionIndex++)
+	{
+		const auto& region = regions[regionIndex];
+		const auto& baseRegion = base->m_regions[regionIndex];
+
+		REGION snapshotRegion;
+		snapshotRegion.name = region.name;
+		snapshotRegion.size = region.size;
+
+		//Comparing against the base's raw copy is fast enough that we don't need to track writes
+		uint32 dirtySize = StatePageUtils::FindDirtyPages(region.memory, baseRegion.data.data(), region.size, snapshotRegion.dirtyPages);
+		StatePageUtils::ForEachDirtyPage(snapshotRegion.dirtyPages, region.size,
+		                                 [&](uint32, uint32) { snapshot->m_dirtyPageCount++; });
+
+		if(dirtySize != 0)
+		{
+			snapshotRegion.data = StatePageUtils::CompressPages(region.memory, region.size, snapshotRegion.dirtyPages, dirtySize);
+		}
+
+		snapshot->m_regions.push_back(std::move(snapshotRegion));
+	}
+	return snapshot;
+}
+
+bool CStateSnapshot::IsFull() const
+{
+	return !m_base;
+}
+
+bool CStateSnapshot::IsCompatible(const StateMemoryRegionList& regions) const
+{
+	if(regions.size() != m_regions.size()) return false;
+	for(uint32 regionIndex = 0; regionIndex < regions.size(); regionIndex++)
+	{
+		const auto& region = regions[regionIndex];
+		const auto& snapshotRegion = m_regions[regionIndex];
+		if((snapshotRegion.name != region.name) || (snapshotRegion.size != region.size))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+const CStateSnapshot::SnapshotPtr& CStateSnapshot::GetBase() const
+{
+	return m_base;
+}
+
+const CStateSnapshot::ArchiveData& CStateSnapshot::GetArchiveData() const
+{
+	return m_archiveData;
+}
+
+uint64 CStateSnapshot::GetSize() const
+{
+	uint64 size = m_archiveData.size();
+	for(const auto& region : m_regions)
+	{
+		size += region.data.size();
+		size += region.dirtyPages.size() * sizeof(uint64);
+	}
+	return size;
+}
+
+uint32 CStateSnapshot::GetPageCount() const
+{
+	return m_pageCount;
+}
+
+uint32 CStateSnapshot::GetDirtyPageCount() const
+{
+	return m_dirtyPageCount;
+}
+
+const uint8* CStateSnapshot::GetRegionContents(const STATE_MEMORY_REGION& region, std::vector<uint8>& buffer) const
+{
+	const auto& snapshotRegion = FindRegion(region.name);
+	if(snapshotRegion.size != region.size)
+	{
+		throw std::runtime_error("Snapshot region size doesn't match.");
+	}
+
+	if(IsFull())
+	{
+		return snapshotRegion.data.data();
+	}
+
+	const auto& baseRegion = m_base->FindRegion(region.name);
+	buffer.resize(region.size);
+	memcpy(buffer.data(), baseRegion.data.data(), region.size);
+	if(!snapshotRegion.data.empty())
+	{
+		StatePageUtils::DecompressPages(buffer.data(), region.size, snapshotRegion.dirtyPages, snapshotRegion.data, false);
+	}
+	return buffer.data();
+}
+
+const CStateSnapshot::REGION& CStateSnapshot::FindRegion(const char* name) const
+{
+	auto regionIterator = std::find_if(std::begin(m_regions), std::end(m_regions),
+	                                   [name](const REGION& region) { return region.name == name; });
+	if(regionIterator == std::end(m_regions))
+	{
+		throw std::runtime_error("Snapshot doesn't contain region.");
+	}
+	return *regionIterator;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "Types.h"
+#include "StateMemoryRegion.h"
+#include "StatePageUtils.h"
+
+//Machine state kept in memory, meant to be captured often (checkpoints, rewind, etc.).
+//
+//Everything but the memory regions is kept as a small state archive. Full snapshots hold a raw
+//copy of the memory regions, which makes them quick to capture and to compare against. Delta
+//snapshots refer to a full snapshot (their base) and only hold the pages that differ from it,
+//compressed.
+class CStateSnapshot
+{
+public:
+	enum
+	{
+		SNAPSHOT_PAGE_SIZE = StatePageUtils::STATE_PAGE_SIZE,
+	};
+
+	typedef std::vector<uint8> ArchiveData;
+	typedef std::shared_ptr<const CStateSnapshot> SnapshotPtr;
+
+	static SnapshotPtr CreateFull(ArchiveData, const StateMemoryRegionList&);
+	static SnapshotPtr CreateDelta(ArchiveData, const StateMemoryRegionList&, const SnapshotPtr&);
+
+	bool IsFull() const;
+	bool IsCompatible(const StateMemoryRegionList&) const;
+	const SnapshotPtr& GetBase() const;
+	const ArchiveData& GetArchiveData() const;
+
+	//Memory used by this snapshot, not counting its base
+	uint64 GetSize() const;
+	uint32 GetPageCount() const;
+	uint32 GetDirtyPageCount() const;
+
+	//Returns the contents the region had when the snapshot was captured. The buffer is
+	//used as storage when the contents need to be rebuilt from the base.
+	const uint8* GetRegionContents(const STATE_MEMORY_REGION&, std::vector<uint8>&) const;
+
+private:
+	struct REGION
+	{
+		std::string name;
+		uint32 size = 0;
+		//Full snapshots: raw contents, delta snapshots: compressed dirty pages
+		std::vector<uint8> data;
+		//Delta snapshots only, one bit per page
+		StatePageUtils::DirtyPageArray dirtyPages;
+	};
+
+	CStateSnapshot() = default;
+
+	const REGION& FindRegion(const char*) const;
+
+	ArchiveData m_archiveData;
+	SnapshotPtr m_base;
+	std::vector<REGION> m_regions;
+	uint32 m_pageCount = 0;
+	uint32 m_dirtyPageCount = 0;
+};
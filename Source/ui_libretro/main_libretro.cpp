@@ -17,6 +17,9 @@
 #include "filesystem_def.h"
 #include <vector>
 #include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <stdexcept>
 
 #define LOG_NAME "LIBRETRO"
 
@@ -237,29 +240,137 @@ unsigned retro_get_region(void)
 	return RETRO_REGION_NTSC;
 }
 
+//Serialized states have a fixed layout, which allows them to be written straight to the
+//frontend's buffer without going through a zip archive for the memory regions:
+//- Header
+//- State archive, holding everything but memory regions (padded to the archive capacity)
+//- Memory regions, uncompressed, in the order given by GetStateMemoryRegions
+//The archive's capacity leaves room for its size to vary between calls, since
+//frontends expect the size given by retro_serialize_size to stay valid.
+
+#define SERIALIZED_STATE_MAGIC 0x53524C50 //'PLRS'
+#define SERIALIZED_STATE_VERSION 1
+#define SERIALIZED_STATE_ARCHIVE_SLACK (0x40000)
+#define SERIALIZED_STATE_ARCHIVE_ALIGNMENT (0x10000)
+
+struct SERIALIZED_STATE_HEADER
+{
+	uint32 magic = SERIALIZED_STATE_MAGIC;
+	uint32 version = SERIALIZED_STATE_VERSION;
+	uint32 archiveCapacity = 0;
+	uint32 archiveSize = 0;
+	uint32 regionCount = 0;
+	uint32 regionsSize = 0;
+};
+static_assert(sizeof(SERIALIZED_STATE_HEADER) == 0x18, "SERIALIZED_STATE_HEADER size must be 0x18 bytes.");
+
+static uint32 g_serializedStateArchiveCapacity = 0;
+
+static StateMemoryRegionList GetStateMemoryRegions()
+{
+	StateMemoryRegionList regions;
+	for(const auto& regionList : {m_virtualMachine->m_ee->GetStateMemoryRegions(), m_virtualMachine->m_iop->GetStateMemoryRegions(), m_virtualMachine->m_ee->m_gs->GetStateMemoryRegions()})
+	{
+		regions.insert(std::end(regions), std::begin(regionList), std::end(regionList));
+	}
+	return regions;
+}
+
+static uint32 GetStateMemoryRegionsSize(const StateMemoryRegionList& regions)
+{
+	uint32 regionsSize = 0;
+	for(const auto& region : regions)
+	{
+		regionsSize += region.size;
+	}
+	return regionsSize;
+}
+
+static void SaveStateArchive(Framework::CMemStream& archiveStream)
+{
+	//Memory regions are kept out of the archive. This needs to be done before
+	//accessing the regions since it syncs GS memory.
+	Framework::CZipArchiveWriter archive;
+
+	m_virtualMachine->m_ee->SaveState(archive, false);
+	m_virtualMachine->m_iop->SaveState(archive, false);
+	m_virtualMachine->m_ee->m_gs->SaveState(archive, false);
+
+	archive.Write(archiveStream);
+}
+
+static void UpdateSerializedStateArchiveCapacity(uint32 archiveSize)
+{
+	uint32 archiveCapacity = archiveSize + SERIALIZED_STATE_ARCHIVE_SLACK;
+	archiveCapacity = (archiveCapacity + SERIALIZED_STATE_ARCHIVE_ALIGNMENT - 1) & ~(SERIALIZED_STATE_ARCHIVE_ALIGNMENT - 1);
+	g_serializedStateArchiveCapacity = std::max<uint32>(g_serializedStateArchiveCapacity, archiveCapacity);
+}
+
 size_t retro_serialize_size(void)
 {
 	CLog::GetInstance().Print(LOG_NAME, "%s\n", __FUNCTION__);
 
-	return 40 * 1024 * 1024;
+	if(!m_virtualMachine || !m_virtualMachine->m_ee || !m_virtualMachine->m_ee->m_gs)
+	{
+		return 0;
+	}
+
+	if(g_serializedStateArchiveCapacity == 0)
+	{
+		Framework::CMemStream archiveStream;
+		SaveStateArchive(archiveStream);
+		UpdateSerializedStateArchiveCapacity(static_cast<uint32>(archiveStream.GetSize()));
+	}
+
+	return sizeof(SERIALIZED_STATE_HEADER) + g_serializedStateArchiveCapacity + GetStateMemoryRegionsSize(GetStateMemoryRegions());
 }
 
 bool retro_serialize(void* data, size_t size)
 {
 	CLog::GetInstance().Print(LOG_NAME, "%s\n", __FUNCTION__);
 
+	if(!m_virtualMachine || !m_virtualMachine->m_ee || !m_virtualMachine->m_ee->m_gs)
+	{
+		return false;
+	}
+
 	try
 	{
-		Framework::CMemStream stateStream;
-		Framework::CZipArchiveWriter archive;
+		Framework::CMemStream archiveStream;
+		SaveStateArchive(archiveStream);
+		auto regions = GetStateMemoryRegions();
+
+		SERIALIZED_STATE_HEADER header;
+		header.archiveSize = static_cast<uint32>(archiveStream.GetSize());
+		header.regionCount = static_cast<uint32>(regions.size());
+		header.regionsSize = GetStateMemoryRegionsSize(regions);
+
+		if(header.archiveSize > g_serializedStateArchiveCapacity)
+		{
+			//Let the next call to retro_serialize_size report a size that fits
+			UpdateSerializedStateArchiveCapacity(header.archiveSize);
+			CLog::GetInstance().Warn(LOG_NAME, "State archive doesn't fit in the serialized state anymore.\n");
+			return false;
+		}
+		header.archiveCapacity = g_serializedStateArchiveCapacity;
 
-		m_virtualMachine->m_ee->SaveState(archive);
-		m_virtualMachine->m_iop->SaveState(archive);
-		m_virtualMachine->m_ee->m_gs->SaveState(archive);
+		size_t stateSize = sizeof(SERIALIZED_STATE_HEADER) + header.archiveCapacity + header.regionsSize;
+		if(size < stateSize)
+		{
+			return false;
+		}
 
-		archive.Write(stateStream);
-		stateStream.Seek(0, Framework::STREAM_SEEK_DIRECTION::STREAM_SEEK_SET);
-		stateStream.Read(data, size);
+		auto output = reinterpret_cast<uint8*>(data);
+		memcpy(output, &header, sizeof(SERIALIZED_STATE_HEADER));
+		output += sizeof(SERIALIZED_STATE_HEADER);
+		memcpy(output, archiveStream.GetBuffer(), header.archiveSize);
+		memset(output + header.archiveSize, 0, header.archiveCapacity - header.archiveSize);
+		output += header.archiveCapacity;
+		for(const auto& region : regions)
+		{
+			memcpy(output, region.memory, region.size);
+			output += region.size;
+		}
 	}
 	catch(...)
 	{
@@ -273,22 +384,53 @@ bool retro_unserialize(const void* data, size_t size)
 {
 	CLog::GetInstance().Print(LOG_NAME, "%s\n", __FUNCTION__);
 
+	if(!m_virtualMachine || !m_virtualMachine->m_ee || !m_virtualMachine->m_ee->m_gs)
+	{
+		return false;
+	}
+
 	try
 	{
-		Framework::CPtrStream stateStream(data, size);
-		Framework::CZipArchiveReader archive(stateStream);
+		if(size < sizeof(SERIALIZED_STATE_HEADER))
+		{
+			return false;
+		}
 
-		try
+		SERIALIZED_STATE_HEADER header;
+		memcpy(&header, data, sizeof(SERIALIZED_STATE_HEADER));
+		if((header.magic != SERIALIZED_STATE_MAGIC) || (header.version != SERIALIZED_STATE_VERSION))
 		{
-			m_virtualMachine->m_ee->LoadState(archive);
-			m_virtualMachine->m_iop->LoadState(archive);
-			m_virtualMachine->m_ee->m_gs->LoadState(archive);
+			return false;
 		}
-		catch(...)
+
+		auto regions = GetStateMemoryRegions();
+		if((header.regionCount != regions.size()) || (header.regionsSize != GetStateMemoryRegionsSize(regions)) ||
+		   (header.archiveSize > header.archiveCapacity) ||
+		   (size < (sizeof(SERIALIZED_STATE_HEADER) + static_cast<size_t>(header.archiveCapacity) + header.regionsSize)))
 		{
-			//Any error that occurs in the previous block is critical
-			throw;
+			return false;
 		}
+
+		auto input = reinterpret_cast<const uint8*>(data) + sizeof(SERIALIZED_STATE_HEADER);
+		Framework::CPtrStream archiveStream(input, header.archiveSize);
+		Framework::CZipArchiveReader archive(archiveStream);
+
+		//Region contents are read straight from the frontend's buffer
+		auto regionsData = input + header.archiveCapacity;
+		auto regionSource =
+		    [&](const STATE_MEMORY_REGION& sourceRegion) {
+			    auto regionData = regionsData;
+			    for(const auto& region : regions)
+			    {
+				    if(!strcmp(region.name, sourceRegion.name)) return regionData;
+				    regionData += region.size;
+			    }
+			    throw std::runtime_error("Unknown state memory region.");
+		    };
+
+		m_virtualMachine->m_ee->LoadState(archive, regionSource);
+		m_virtualMachine->m_iop->LoadState(archive, regionSource);
+		m_virtualMachine->m_ee->m_gs->LoadState(archive, regionSource);
 	}
 	catch(...)
 	{
@@ -5,6 +5,7 @@
 #include <QSurface>
 #include <QWindow>
 #include <QOpenGLContext>
+#include <QOffscreenSurface>
 
 #if defined(GLES_COMPATIBILITY)
 #include "GSH_OpenGLQt.h"
@@ -14,14 +15,19 @@
 #include <CoreFoundation/CoreFoundation.h>
 #endif
 
-CGSH_OpenGLQt::CGSH_OpenGLQt(QSurface* renderSurface)
+CGSH_OpenGLQt::CGSH_OpenGLQt(QSurface* renderSurface, OffscreenSurfacePtr workerSurface)
     : m_renderSurface(renderSurface)
+    , m_workerSurface(std::move(workerSurface))
 {
 }
 
 CGSH_OpenGL::FactoryFunction CGSH_OpenGLQt::GetFactoryFunction(QSurface* renderSurface)
 {
-	return [renderSurface]() { return new CGSH_OpenGLQt(renderSurface); };
+	//The surface used by the shader warm up thread must be created on the GUI thread and deleted there
+	auto workerSurface = OffscreenSurfacePtr(new QOffscreenSurface(nullptr), [](QOffscreenSurface* surface) { surface->deleteLater(); });
+	workerSurface->setFormat(renderSurface->format());
+	workerSurface->create();
+	return [renderSurface, workerSurface]() { return new CGSH_OpenGLQt(renderSurface, workerSurface); };
 }
 
 void CGSH_OpenGLQt::InitializeImpl()
@@ -57,6 +63,32 @@ void CGSH_OpenGLQt::ReleaseImpl()
 	delete m_context;
 }
 
+bool CGSH_OpenGLQt::BeginWorkerContext()
+{
+	//Called from the warm up thread, the context is created there to have the right thread affinity
+	if(!m_workerSurface || !m_workerSurface->isValid())
+	{
+		return false;
+	}
+
+	m_workerContext = std::make_unique<QOpenGLContext>();
+	m_workerContext->setFormat(m_context->format());
+	m_workerContext->setShareContext(m_context);
+	if(!m_workerContext->create() || !m_workerContext->makeCurrent(m_workerSurface.get()))
+	{
+		m_workerContext.reset();
+		return false;
+	}
+
+	return true;
+}
+
+void CGSH_OpenGLQt::EndWorkerContext()
+{
+	m_workerContext->doneCurrent();
+	m_workerContext.reset();
+}
+
 void CGSH_OpenGLQt::PresentBackbuffer()
 {
 	bool swapBuffer = true;
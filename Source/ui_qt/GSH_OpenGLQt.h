@@ -1,14 +1,18 @@
 #pragma once
 
+#include <memory>
 #include "gs/GSH_OpenGL/GSH_OpenGL.h"
 
 class QSurface;
+class QOffscreenSurface;
 class QOpenGLContext;
 
 class CGSH_OpenGLQt : public CGSH_OpenGL
 {
 public:
-	CGSH_OpenGLQt(QSurface*);
+	typedef std::shared_ptr<QOffscreenSurface> OffscreenSurfacePtr;
+
+	CGSH_OpenGLQt(QSurface*, OffscreenSurfacePtr = OffscreenSurfacePtr());
 	virtual ~CGSH_OpenGLQt() = default;
 
 	static FactoryFunction GetFactoryFunction(QSurface*);
@@ -17,7 +21,14 @@ public:
 	void ReleaseImpl() override;
 	void PresentBackbuffer() override;
 
+protected:
+	bool BeginWorkerContext() override;
+	void EndWorkerContext() override;
+
 private:
 	QSurface* m_renderSurface = nullptr;
 	QOpenGLContext* m_context = nullptr;
+
+	OffscreenSurfacePtr m_workerSurface;
+	std::unique_ptr<QOpenGLContext> m_workerContext;
 };
@@ -31,6 +31,7 @@
 #include <QCheckBox>
 
 #include "StdStreamUtils.h"
+#include "FrameDumpStream.h"
 #include "string_format.h"
 
 #ifdef _WIN32
@@ -112,6 +113,7 @@ MainWindow::MainWindow(QWidget* parent)
 
 	//Add actions to window to make sure they can be activated with shortcuts in fullscreen mode.
 	addAction(ui->actionPause_Resume);
+	addAction(ui->actionRewind);
 	addAction(ui->actionToggleFullscreen);
 
 #ifdef WIN32
@@ -565,6 +567,7 @@ void MainWindow::on_actionSettings_triggered()
 	{
 		m_virtualMachine->ReloadSpuBlockCount();
 		m_virtualMachine->ReloadFrameRateLimit();
+		m_virtualMachine->ReloadRewindSettings();
 		UpdateCpuUsageLabel();
 		auto new_gs_index = CAppConfig::GetInstance().GetPreferenceInteger(PREF_VIDEO_GS_HANDLER);
 		if(gs_index != new_gs_index)
@@ -782,6 +785,7 @@ void MainWindow::UpdateUI()
 	ui->actionPause_when_focus_is_lost->setChecked(m_pauseFocusLost);
 	ui->actionReset->setEnabled(!m_lastOpenCommand.path.empty());
 	ui->actionPause_Resume->setEnabled(IsExecutableLoaded());
+	ui->actionRewind->setEnabled(IsExecutableLoaded());
 	SetOutputWindowSize();
 	SetupSaveLoadStateSlots();
 }
@@ -986,11 +990,6 @@ void MainWindow::ShowFrameDebugger()
 	m_frameDebugger->activateWindow();
 }
 
-fs::path MainWindow::GetFrameDumpDirectoryPath()
-{
-	return CAppConfig::GetInstance().GetBasePath() / fs::path("framedumps/");
-}
-
 void MainWindow::DumpNextFrame()
 {
 	m_virtualMachine->m_ee->m_gs->TriggerFrameDump(
@@ -1068,6 +1067,29 @@ void MainWindow::on_actionReset_triggered()
 	}
 }
 
+void MainWindow::on_actionRewind_triggered()
+{
+	if(m_virtualMachine == nullptr) return;
+	if(!m_virtualMachine->GetRewindInfo().enabled)
+	{
+		m_msgLabel->setText(QString("Rewind is disabled, it can be enabled in the settings."));
+		return;
+	}
+	auto future = m_virtualMachine->Rewind();
+	m_continuationChecker->GetContinuationManager().Register(std::move(future),
+	                                                         [this](const bool& succeeded) {
+		                                                         if(succeeded)
+		                                                         {
+			                                                         auto rewindInfo = m_virtualMachine->GetRewindInfo();
+			                                                         m_msgLabel->setText(QString("Rewound, %1 state(s) left (capture cost: %2us last, %3us worst).").arg(rewindInfo.stateCount).arg(rewindInfo.lastCaptureTime).arg(rewindInfo.maxCaptureTime));
+		                                                         }
+		                                                         else
+		                                                         {
+			                                                         m_msgLabel->setText(QString("No state to rewind to."));
+		                                                         }
+	                                                         });
+}
+
 void MainWindow::on_actionMemory_Card_Manager_triggered()
 {
 	MemoryCardManagerDialog mcm(this);
@@ -1097,6 +1119,100 @@ void MainWindow::on_actionCapture_Screen_triggered()
 	                                                                        });
 }
 
+fs::path MainWindow::GetFrameDumpDirectoryPath()
+{
+	return CAppConfig::GetInstance().GetBasePath() / fs::path("framedumps/");
+}
+
+void MainWindow::on_actionRecord_Frame_Dump_Stream_triggered()
+{
+	auto gs = m_virtualMachine->GetGSHandler();
+	if(gs == nullptr) return;
+	if(m_frameDumpStreamActive)
+	{
+		gs->EndFrameDumpStream();
+		m_frameDumpStreamActive = false;
+		ui->actionRecord_Frame_Dump_Stream->setChecked(false);
+		m_msgLabel->setText(QString("Stopped recording frame dump stream."));
+		return;
+	}
+	try
+	{
+		auto frameDumpDirectoryPath = GetFrameDumpDirectoryPath();
+		Framework::PathUtils::EnsurePathExists(frameDumpDirectoryPath);
+		for(unsigned int i = 0; i < UINT_MAX; i++)
+		{
+			auto frameDumpFileName = string_format("framedump_stream_%08d.dmps", i);
+			auto frameDumpPath = frameDumpDirectoryPath / fs::path(frameDumpFileName);
+			if(!fs::exists(frameDumpPath))
+			{
+				auto dumpStream = std::make_unique<Framework::CStdStream>(frameDumpPath.string().c_str(), "wb");
+				gs->BeginFrameDumpStream(std::make_shared<CFrameDumpStreamWriter>(std::move(dumpStream)));
+				m_frameDumpStreamActive = true;
+				ui->actionRecord_Frame_Dump_Stream->setChecked(true);
+				m_msgLabel->setText(QString("Recording frame dump stream to '%1'.").arg(frameDumpFileName.c_str()));
+				return;
+			}
+		}
+	}
+	catch(...)
+	{
+	}
+	ui->actionRecord_Frame_Dump_Stream->setChecked(false);
+	m_msgLabel->setText(QString("Failed to start recording frame dump stream."));
+}
+
+fs::path MainWindow::GetGuestProfileDirectoryPath()
+{
+	return CAppConfig::GetInstance().GetBasePath() / fs::path("profiles/");
+}
+
+void MainWindow::on_actionProfile_Guest_Code_triggered()
+{
+	if(m_virtualMachine == nullptr) return;
+	if(!m_guestProfilingActive)
+	{
+		m_virtualMachine->StartGuestProfiling();
+		m_guestProfilingActive = true;
+		ui->actionProfile_Guest_Code->setChecked(true);
+		m_msgLabel->setText(QString("Started profiling guest code."));
+		return;
+	}
+	m_virtualMachine->StopGuestProfiling();
+	m_guestProfilingActive = false;
+	ui->actionProfile_Guest_Code->setChecked(false);
+	try
+	{
+		auto profileDirectoryPath = GetGuestProfileDirectoryPath();
+		Framework::PathUtils::EnsurePathExists(profileDirectoryPath);
+		for(unsigned int i = 0; i < UINT_MAX; i++)
+		{
+			auto profileFileName = string_format("guest_profile_%08d.folded", i);
+			auto profilePath = profileDirectoryPath / fs::path(profileFileName);
+			if(!fs::exists(profilePath))
+			{
+				auto future = m_virtualMachine->SaveGuestProfile(profilePath);
+				m_continuationChecker->GetContinuationManager().Register(std::move(future),
+				                                                         [this, profileFileName = profileFileName](const bool& succeeded) {
+					                                                         if(succeeded)
+					                                                         {
+						                                                         m_msgLabel->setText(QString("Saved guest profile to '%1'.").arg(profileFileName.c_str()));
+					                                                         }
+					                                                         else
+					                                                         {
+						                                                         m_msgLabel->setText(QString("Failed to save guest profile."));
+					                                                         }
+				                                                         });
+				return;
+			}
+		}
+	}
+	catch(...)
+	{
+	}
+	m_msgLabel->setText(QString("Failed to save guest profile."));
+}
+
 void MainWindow::on_actionList_Bootables_triggered()
 {
 	ui->stackedWidget->setCurrentIndex(1 - ui->stackedWidget->currentIndex());
@@ -51,11 +51,13 @@ public:
 	void ShowMainWindow();
 	void ShowDebugger();
 	void ShowFrameDebugger();
-	fs::path GetFrameDumpDirectoryPath();
 	void DumpNextFrame();
 	void ToggleGsDraw();
 #endif
 
+	fs::path GetFrameDumpDirectoryPath();
+	fs::path GetGuestProfileDirectoryPath();
+
 private:
 	enum class BootType
 	{
@@ -110,6 +112,8 @@ private:
 	CPS2VM* m_virtualMachine = nullptr;
 	bool m_deactivatePause = false;
 	bool m_pauseFocusLost = true;
+	bool m_frameDumpStreamActive = false;
+	bool m_guestProfilingActive = false;
 	std::shared_ptr<CInputProviderQtKey> m_qtKeyInputProvider;
 	std::shared_ptr<CInputProviderQtMouse> m_qtMouseInputProvider;
 	LastOpenCommand m_lastOpenCommand;
@@ -158,11 +162,14 @@ private slots:
 	void outputWindow_mouseReleaseEvent(QMouseEvent*);
 	void on_actionPause_when_focus_is_lost_triggered(bool checked);
 	void on_actionReset_triggered();
+	void on_actionRewind_triggered();
 	void on_actionMemory_Card_Manager_triggered();
 	void on_actionVFS_Manager_triggered();
 	void on_actionController_Manager_triggered();
 	void on_actionToggleFullscreen_triggered();
 	void on_actionCapture_Screen_triggered();
+	void on_actionRecord_Frame_Dump_Stream_triggered();
+	void on_actionProfile_Guest_Code_triggered();
 	void HandleOnExecutableChange();
 	void on_actionList_Bootables_triggered();
 };
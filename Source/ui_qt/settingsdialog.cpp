@@ -85,6 +85,9 @@ void SettingsDialog::LoadPreferences()
 	ui->comboBox_system_language->setCurrentIndex(CAppConfig::GetInstance().GetPreferenceInteger(PREF_SYSTEM_LANGUAGE));
 	ui->checkBox_limitFrameRate->setChecked(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_LIMIT_FRAMERATE));
 	ui->checkBox_showEECPUUsage->setChecked(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_UI_SHOWEECPUUSAGE));
+	ui->checkBox_enableRewind->setChecked(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_REWIND_ENABLED));
+	ui->spinBox_rewindInterval->setValue(CAppConfig::GetInstance().GetPreferenceInteger(PREF_PS2_REWIND_INTERVAL));
+	ui->spinBox_rewindMemoryBudget->setValue(CAppConfig::GetInstance().GetPreferenceInteger(PREF_PS2_REWIND_MEMORY_BUDGET));
 	ui->edit_arcadeRoms_dir->setText(PathToQString(CAppConfig::GetInstance().GetPreferencePath(PREF_PS2_ARCADEROMS_DIRECTORY)));
 	ui->checkBox_enableArcadeIOServer->setChecked(CAppConfig::GetInstance().GetPreferenceBoolean(PREF_PS2_ARCADE_IO_SERVER_ENABLED));
 	ui->lineEdit_arcadeIOServerPort->setText(QString::number(CAppConfig::GetInstance().GetPreferenceInteger(PREF_PS2_ARCADE_IO_SERVER_PORT)));
@@ -119,6 +122,21 @@ void SettingsDialog::on_checkBox_showEECPUUsage_clicked(bool checked)
 	CAppConfig::GetInstance().SetPreferenceBoolean(PREF_UI_SHOWEECPUUSAGE, checked);
 }
 
+void SettingsDialog::on_checkBox_enableRewind_clicked(bool checked)
+{
+	CAppConfig::GetInstance().SetPreferenceBoolean(PREF_PS2_REWIND_ENABLED, checked);
+}
+
+void SettingsDialog::on_spinBox_rewindInterval_valueChanged(int value)
+{
+	CAppConfig::GetInstance().SetPreferenceInteger(PREF_PS2_REWIND_INTERVAL, value);
+}
+
+void SettingsDialog::on_spinBox_rewindMemoryBudget_valueChanged(int value)
+{
+	CAppConfig::GetInstance().SetPreferenceInteger(PREF_PS2_REWIND_MEMORY_BUDGET, value);
+}
+
 void SettingsDialog::on_button_browseArcadeRomsDir_clicked()
 {
 	auto prevDir = PathToQString(CAppConfig::GetInstance().GetPreferencePath(PREF_PS2_ARCADEROMS_DIRECTORY));
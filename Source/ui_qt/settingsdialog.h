@@ -35,6 +35,9 @@ private slots:
 	void on_comboBox_system_language_currentIndexChanged(int index);
 	void on_checkBox_limitFrameRate_clicked(bool checked);
 	void on_checkBox_showEECPUUsage_clicked(bool checked);
+	void on_checkBox_enableRewind_clicked(bool checked);
+	void on_spinBox_rewindInterval_valueChanged(int value);
+	void on_spinBox_rewindMemoryBudget_valueChanged(int value);
 	void on_button_browseArcadeRomsDir_clicked();
 	void on_checkBox_enableArcadeIOServer_clicked(bool checked);
 	void on_lineEdit_arcadeIOServerPort_textChanged(const QString& value);
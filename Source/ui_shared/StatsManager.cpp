@@ -12,6 +12,7 @@ void CStatsManager::OnNewFrame(CPS2VM* virtualMachine)
 		m_cpuUtilisation.eeIdleTicks += cpuUtilisation.eeIdleTicks;
 		m_cpuUtilisation.iopTotalTicks += cpuUtilisation.iopTotalTicks;
 		m_cpuUtilisation.iopIdleTicks += cpuUtilisation.iopIdleTicks;
+		m_rewindInfo = virtualMachine->GetRewindInfo();
 	}
 
 #ifdef PROFILE
@@ -64,6 +65,12 @@ CPS2VM::CPU_UTILISATION_INFO CStatsManager::GetCpuUtilisationInfo()
 	return m_cpuUtilisation;
 }
 
+CPS2VM::REWIND_INFO CStatsManager::GetRewindInfo()
+{
+	std::lock_guard<std::mutex> statsLock(m_statsMutex);
+	return m_rewindInfo;
+}
+
 #ifdef PROFILE
 
 std::string CStatsManager::GetProfilingInfo()
@@ -107,6 +114,17 @@ std::string CStatsManager::GetProfilingInfo()
 		result += string_format("IOP Usage: %6.2f%%\r\n", iopUsageRatio);
 	}
 
+	if(m_rewindInfo.enabled)
+	{
+		result += string_format("\r\nRewind:    %d states, %6.2fMB / %6.2fMB\r\n",
+		                        m_rewindInfo.stateCount,
+		                        static_cast<double>(m_rewindInfo.memoryUsage) / (1024.0 * 1024.0),
+		                        static_cast<double>(m_rewindInfo.memoryBudget) / (1024.0 * 1024.0));
+		result += string_format("Capture:   %6.2fms, %6.2fKB\r\n",
+		                        static_cast<double>(m_rewindInfo.lastCaptureTime) / 1000.0,
+		                        static_cast<double>(m_rewindInfo.lastCaptureSize) / 1024.0);
+	}
+
 	return result;
 }
 
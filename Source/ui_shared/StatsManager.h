@@ -18,6 +18,7 @@ public:
 	uint32 GetFrames();
 	uint32 GetDrawCalls();
 	CPS2VM::CPU_UTILISATION_INFO GetCpuUtilisationInfo();
+	CPS2VM::REWIND_INFO GetRewindInfo();
 #ifdef PROFILE
 	std::string GetProfilingInfo();
 #endif
@@ -31,6 +32,7 @@ private:
 	uint32 m_drawCalls = 0;
 
 	CPS2VM::CPU_UTILISATION_INFO m_cpuUtilisation;
+	CPS2VM::REWIND_INFO m_rewindInfo;
 
 #ifdef PROFILE
 	struct ZONEINFO
@@ -19,8 +19,35 @@ void CJUnitTestReportWriter::ReportTestEntry(const std::string& testName, const
 {
 	auto testCaseNode = std::make_unique<Framework::Xml::CNode>("testcase", true);
 	testCaseNode->InsertAttribute("name", testName.c_str());
+	testCaseNode->InsertAttribute("time", string_format("%0.3f", result.metrics.wallTime).c_str());
 
-	if(!result.succeeded)
+	{
+		auto propertiesNode = std::make_unique<Framework::Xml::CNode>("properties", true);
+		auto insertProperty =
+		    [&propertiesNode](const char* name, const std::string& value) {
+			    auto propertyNode = std::make_unique<Framework::Xml::CNode>("property", true);
+			    propertyNode->InsertAttribute("name", name);
+			    propertyNode->InsertAttribute("value", value.c_str());
+			    propertiesNode->InsertNode(std::move(propertyNode));
+		    };
+		const auto& metrics = result.metrics;
+		insertProperty("eeCycles", string_format("%llu", static_cast<unsigned long long>(metrics.eeCycles)));
+		insertProperty("frames", string_format("%u", metrics.frameCount));
+		insertProperty("eeUtilisation", string_format("%0.3f", metrics.eeUtilisation));
+		insertProperty("iopUtilisation", string_format("%0.3f", metrics.iopUtilisation));
+		insertProperty("vu0Utilisation", string_format("%0.3f", metrics.vu0Utilisation));
+		insertProperty("vu1Utilisation", string_format("%0.3f", metrics.vu1Utilisation));
+		testCaseNode->InsertNode(std::move(propertiesNode));
+	}
+
+	if(!result.error.empty())
+	{
+		auto errorNode = std::make_unique<Framework::Xml::CNode>("error", true);
+		errorNode->InsertAttribute("message", result.error.c_str());
+		testCaseNode->InsertNode(std::move(errorNode));
+		m_errorCount++;
+	}
+	else if(!result.succeeded)
 	{
 		std::string failureDetails;
 		for(const auto& lineDiff : result.lineDiffs)
@@ -33,18 +60,27 @@ void CJUnitTestReportWriter::ReportTestEntry(const std::string& testName, const
 			failureDetails += failureLine;
 		}
 		auto resultNode = std::make_unique<Framework::Xml::CNode>("failure", true);
+		if(result.timedOut)
+		{
+			resultNode->InsertAttribute("message", "Test timed out.");
+		}
 		resultNode->InsertTextNode(failureDetails.c_str());
 		testCaseNode->InsertNode(std::move(resultNode));
+		m_failureCount++;
 	}
 
 	m_testSuiteNode->InsertNode(std::move(testCaseNode));
 
 	m_testCount++;
+	m_totalTime += result.metrics.wallTime;
 }
 
 void CJUnitTestReportWriter::Write(const fs::path& reportPath)
 {
 	m_testSuiteNode->InsertAttribute("tests", string_format("%d", m_testCount).c_str());
+	m_testSuiteNode->InsertAttribute("failures", string_format("%d", m_failureCount).c_str());
+	m_testSuiteNode->InsertAttribute("errors", string_format("%d", m_errorCount).c_str());
+	m_testSuiteNode->InsertAttribute("time", string_format("%0.3f", m_totalTime).c_str());
 	auto testOutputFileStream = Framework::CreateOutputStdStream(reportPath.native());
 	Framework::Xml::CWriter::WriteDocument(testOutputFileStream, m_reportNode.get());
 }
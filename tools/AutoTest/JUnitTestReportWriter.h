@@ -18,4 +18,8 @@ private:
 	NodePtr m_reportNode;
 	Framework::Xml::CNode* m_testSuiteNode = nullptr;
 	unsigned int m_testCount = 0;
+	unsigned int m_failureCount = 0;
+	unsigned int m_errorCount = 0;
+	//Sum of every test's time, tests running in parallel make it longer than the actual run
+	double m_totalTime = 0;
 };
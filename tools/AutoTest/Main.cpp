@@ -1,7 +1,12 @@
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
 #include "PS2VM.h"
 #include "filesystem_def.h"
 #include "StdStream.h"
 #include "StdStreamUtils.h"
+#include "string_format.h"
 #include "iop/IopBios.h"
 #include "JUnitTestReportWriter.h"
 #include "gs/GSH_Null.h"
@@ -110,18 +115,75 @@ TESTRESULT GetTestResult(const fs::path& testFilePath)
 	return result;
 }
 
-void ExecuteEeTest(const fs::path& testFilePath, const std::string& gsHandlerName)
+struct TESTOPTIONS
+{
+	std::string gsHandlerName = DEFAULT_GS_HANDLER_NAME;
+	//In seconds, 0 means no limit
+	uint32 timeout = 0;
+};
+
+struct TESTRUN
+{
+	bool timedOut = false;
+	TESTMETRICS metrics;
+};
+
+typedef std::vector<fs::path> TestPathArray;
+
+//Virtual machine setup and teardown go through process-wide configuration, tests running in parallel take turns for those
+static std::mutex g_virtualMachineSetupMutex;
+
+TESTMETRICS GetTestMetrics(const CPS2VM::EXECUTION_STATS& stats)
+{
+	auto getRatio =
+	    [](uint64 value, uint64 total) {
+		    return (total != 0) ? static_cast<float>(static_cast<double>(value) / static_cast<double>(total)) : 0.f;
+	    };
+
+	TESTMETRICS metrics;
+	metrics.eeCycles = stats.eeTotalTicks;
+	metrics.frameCount = stats.frameCount;
+	metrics.eeUtilisation = getRatio(stats.eeTotalTicks - stats.eeIdleTicks, stats.eeTotalTicks);
+	metrics.iopUtilisation = getRatio(stats.iopTotalTicks - stats.iopIdleTicks, stats.iopTotalTicks);
+	metrics.vu0Utilisation = getRatio(stats.vu0RunningTicks, stats.eeTotalTicks);
+	metrics.vu1Utilisation = getRatio(stats.vu1RunningTicks, stats.eeTotalTicks);
+	return metrics;
+}
+
+TESTRUN WaitForTestEnd(CPS2VM& virtualMachine, const std::atomic<bool>& executionOver, uint32 timeout)
+{
+	TESTRUN run;
+	auto startTime = std::chrono::steady_clock::now();
+	while(!executionOver)
+	{
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		if((timeout != 0) && ((std::chrono::steady_clock::now() - startTime) >= std::chrono::seconds(timeout)))
+		{
+			run.timedOut = true;
+			break;
+		}
+	}
+
+	virtualMachine.Pause();
+	run.metrics = GetTestMetrics(virtualMachine.GetExecutionStats());
+	run.metrics.wallTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	return run;
+}
+
+TESTRUN ExecuteEeTest(const fs::path& testFilePath, const TESTOPTIONS& options)
 {
 	auto resultFilePath = testFilePath;
 	resultFilePath.replace_extension(".result");
 	auto resultStream = new Framework::CStdStream(resultFilePath.string().c_str(), "wb");
 
-	bool executionOver = false;
+	std::atomic<bool> executionOver = false;
 
 	//Setup virtual machine
+	std::unique_lock<std::mutex> setupLock(g_virtualMachineSetupMutex);
 	CPS2VM virtualMachine;
 	virtualMachine.Initialize();
-	virtualMachine.CreateGSHandler(GetGsHandlerFactoryFunction(gsHandlerName));
+	virtualMachine.CreateGSHandler(GetGsHandlerFactoryFunction(options.gsHandlerName));
+	virtualMachine.SetTurboMode(true, true);
 	auto connection = virtualMachine.m_ee->m_os->OnRequestExit.Connect(
 	    [&executionOver]() {
 		    executionOver = true;
@@ -131,19 +193,18 @@ void ExecuteEeTest(const fs::path& testFilePath, const std::string& gsHandlerNam
 		auto iopOs = dynamic_cast<CIopBios*>(virtualMachine.m_iop->m_bios.get());
 		iopOs->GetIoman()->SetFileStream(Iop::CIoman::FID_STDOUT, resultStream);
 	}
+	setupLock.unlock();
 	virtualMachine.Resume();
 
-	while(!executionOver)
-	{
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
-	}
+	auto run = WaitForTestEnd(virtualMachine, executionOver, options.timeout);
 
-	virtualMachine.Pause();
+	setupLock.lock();
 	virtualMachine.DestroyGSHandler();
 	virtualMachine.Destroy();
+	return run;
 }
 
-void ExecuteIopTest(const fs::path& testFilePath)
+TESTRUN ExecuteIopTest(const fs::path& testFilePath, const TESTOPTIONS& options)
 {
 	//Read in the module data
 	std::vector<uint8> moduleData;
@@ -158,12 +219,14 @@ void ExecuteIopTest(const fs::path& testFilePath)
 	resultFilePath.replace_extension(".result");
 	auto resultStream = new Framework::CStdStream(resultFilePath.string().c_str(), "wb");
 
-	bool executionOver = false;
+	std::atomic<bool> executionOver = false;
 	CIopBios::ModuleStartedEvent::Connection connection;
 	//Setup virtual machine
+	std::unique_lock<std::mutex> setupLock(g_virtualMachineSetupMutex);
 	CPS2VM virtualMachine;
 	virtualMachine.Initialize();
 	virtualMachine.CreateGSHandler(CGSH_Null::GetFactoryFunction());
+	virtualMachine.SetTurboMode(true, true);
 	{
 		auto iopOs = dynamic_cast<CIopBios*>(virtualMachine.m_iop->m_bios.get());
 		int32 rootModuleId = iopOs->LoadModuleFromHost(moduleData.data());
@@ -177,18 +240,93 @@ void ExecuteIopTest(const fs::path& testFilePath)
 		iopOs->StartModule(CIopBios::MODULESTARTREQUEST_SOURCE::REMOTE, rootModuleId, "", nullptr, 0);
 		iopOs->GetIoman()->SetFileStream(Iop::CIoman::FID_STDOUT, resultStream);
 	}
+	setupLock.unlock();
 	virtualMachine.Resume();
 
-	while(!executionOver)
+	auto run = WaitForTestEnd(virtualMachine, executionOver, options.timeout);
+
+	setupLock.lock();
+	virtualMachine.Destroy();
+	return run;
+}
+
+TESTRUN ExecuteTest(const fs::path& testPath, const TESTOPTIONS& options)
+{
+	if(testPath.extension() == ".irx")
 	{
-		std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		return ExecuteIopTest(testPath, options);
 	}
+	else
+	{
+		return ExecuteEeTest(testPath, options);
+	}
+}
 
-	virtualMachine.Pause();
-	virtualMachine.Destroy();
+void WriteTestRun(const fs::path& runPath, const TESTRUN& run)
+{
+	const auto& metrics = run.metrics;
+	auto runString = string_format(
+	    "timedout %d\n"
+	    "walltime %f\n"
+	    "eecycles %llu\n"
+	    "frames %u\n"
+	    "eeutilisation %f\n"
+	    "ioputilisation %f\n"
+	    "vu0utilisation %f\n"
+	    "vu1utilisation %f\n",
+	    run.timedOut ? 1 : 0, metrics.wallTime, static_cast<unsigned long long>(metrics.eeCycles), metrics.frameCount,
+	    metrics.eeUtilisation, metrics.iopUtilisation, metrics.vu0Utilisation, metrics.vu1Utilisation);
+	auto runStream = Framework::CreateOutputStdStream(runPath.native());
+	runStream.Write(runString.data(), runString.size());
+}
+
+TESTRUN ReadTestRun(const fs::path& runPath)
+{
+	TESTRUN run;
+	auto& metrics = run.metrics;
+	auto runStream = Framework::CreateInputStdStream(runPath.native());
+	for(const auto& line : ReadLines(runStream))
+	{
+		char name[32] = {};
+		double value = 0;
+		if(sscanf(line.c_str(), "%31s %lf", name, &value) != 2) continue;
+		if(!strcmp(name, "timedout")) run.timedOut = (value != 0);
+		else if(!strcmp(name, "walltime")) metrics.wallTime = value;
+		else if(!strcmp(name, "eecycles")) metrics.eeCycles = static_cast<uint64>(value);
+		else if(!strcmp(name, "frames")) metrics.frameCount = static_cast<uint32>(value);
+		else if(!strcmp(name, "eeutilisation")) metrics.eeUtilisation = static_cast<float>(value);
+		else if(!strcmp(name, "ioputilisation")) metrics.iopUtilisation = static_cast<float>(value);
+		else if(!strcmp(name, "vu0utilisation")) metrics.vu0Utilisation = static_cast<float>(value);
+		else if(!strcmp(name, "vu1utilisation")) metrics.vu1Utilisation = static_cast<float>(value);
+	}
+	return run;
+}
+
+//Runs the test in another instance of this program, a test crashing or corrupting the process won't affect others
+TESTRUN ExecuteTestInChildProcess(const std::string& executablePath, const fs::path& testPath, const TESTOPTIONS& options)
+{
+	auto runPath = testPath;
+	runPath.replace_extension(".run");
+	fs::remove(runPath);
+
+	auto commandLine = string_format("\"%s\" --gshandler %s --timeout %u --runtest \"%s\" --runpath \"%s\"",
+	                                 executablePath.c_str(), options.gsHandlerName.c_str(), options.timeout,
+	                                 testPath.string().c_str(), runPath.string().c_str());
+#ifdef _WIN32
+	//cmd.exe strips the outer quotes of the command
+	commandLine = "\"" + commandLine + "\"";
+#endif
+	int exitCode = std::system(commandLine.c_str());
+	if((exitCode != 0) || !fs::exists(runPath))
+	{
+		throw std::runtime_error(string_format("Test process exited abnormally (code %d).", exitCode));
+	}
+	auto run = ReadTestRun(runPath);
+	fs::remove(runPath);
+	return run;
 }
 
-void ScanAndExecuteTests(const fs::path& testDirPath, const TestReportWriterPtr& testReportWriter, const std::string& gsHandlerName)
+void ScanTests(const fs::path& testDirPath, TestPathArray& testPaths)
 {
 	fs::directory_iterator endIterator;
 	for(auto testPathIterator = fs::directory_iterator(testDirPath);
@@ -197,32 +335,88 @@ void ScanAndExecuteTests(const fs::path& testDirPath, const TestReportWriterPtr&
 		auto testPath = testPathIterator->path();
 		if(fs::is_directory(testPath))
 		{
-			ScanAndExecuteTests(testPath, testReportWriter, gsHandlerName);
+			ScanTests(testPath, testPaths);
 			continue;
 		}
-		if(testPath.extension() == ".elf")
+		if((testPath.extension() == ".elf") || (testPath.extension() == ".irx"))
 		{
-			printf("Testing '%s': ", testPath.string().c_str());
-			ExecuteEeTest(testPath, gsHandlerName);
-			auto result = GetTestResult(testPath);
-			printf("%s.\r\n", result.succeeded ? "SUCCEEDED" : "FAILED");
-			if(testReportWriter)
-			{
-				testReportWriter->ReportTestEntry(testPath.string(), result);
-			}
+			testPaths.push_back(testPath);
 		}
-		else if(testPath.extension() == ".irx")
+	}
+}
+
+//Tests are handed out to the workers one at a time, the report lists them in scan order whatever the order they completed in
+void ExecuteTests(const TestPathArray& testPaths, const TestReportWriterPtr& testReportWriter, const TESTOPTIONS& options,
+                  unsigned int jobCount, const std::string& childExecutablePath)
+{
+	std::vector<TESTRESULT> results(testPaths.size());
+	std::atomic<size_t> nextTestIndex = 0;
+	std::mutex outputMutex;
+
+	auto workerProc =
+	    [&]() {
+		    while(1)
+		    {
+			    size_t testIndex = nextTestIndex++;
+			    if(testIndex >= testPaths.size()) break;
+			    const auto& testPath = testPaths[testIndex];
+
+			    TESTRESULT result;
+			    try
+			    {
+				    auto run = childExecutablePath.empty() ? ExecuteTest(testPath, options) : ExecuteTestInChildProcess(childExecutablePath, testPath, options);
+				    result = GetTestResult(testPath);
+				    result.timedOut = run.timedOut;
+				    result.succeeded = result.succeeded && !run.timedOut;
+				    result.metrics = run.metrics;
+			    }
+			    catch(const std::exception& exception)
+			    {
+				    result.succeeded = false;
+				    result.error = exception.what();
+			    }
+
+			    {
+				    std::lock_guard<std::mutex> outputLock(outputMutex);
+				    const char* status = result.succeeded ? "SUCCEEDED" : (!result.error.empty() ? "ERROR" : (result.timedOut ? "TIMED OUT" : "FAILED"));
+				    printf("Testing '%s': %s (%0.2fs).\r\n", testPath.string().c_str(), status, result.metrics.wallTime);
+				    if(!result.error.empty())
+				    {
+					    printf("\t%s\r\n", result.error.c_str());
+				    }
+			    }
+			    results[testIndex] = std::move(result);
+		    }
+	    };
+
+	if(jobCount <= 1)
+	{
+		workerProc();
+	}
+	else
+	{
+		std::vector<std::thread> workers;
+		for(unsigned int i = 0; i < jobCount; i++)
 		{
-			printf("Testing '%s': ", testPath.string().c_str());
-			ExecuteIopTest(testPath);
-			auto result = GetTestResult(testPath);
-			printf("%s.\r\n", result.succeeded ? "SUCCEEDED" : "FAILED");
-			if(testReportWriter)
-			{
-				testReportWriter->ReportTestEntry(testPath.string(), result);
-			}
+			workers.emplace_back(workerProc);
+		}
+		for(auto& worker : workers)
+		{
+			worker.join();
+		}
+	}
+
+	unsigned int failedCount = 0;
+	for(unsigned int i = 0; i < testPaths.size(); i++)
+	{
+		const auto& result = results[i];
+		if(!result.succeeded) failedCount++;
+		if(testReportWriter)
+		{
+			testReportWriter->ReportTestEntry(testPaths[i].string(), result);
 		}
 	}
+	printf("%u test(s) executed, %u failed.\r\n", static_cast<uint32>(testPaths.size()), failedCount);
 }
 
 int main(int argc, const char** argv)
@@ -249,14 +443,21 @@ int main(int argc, const char** argv)
 		printf("\t --junitreport <path>\t Writes JUnit format report at <path>.\r\n");
 		printf("\t --gshandler <%s>\tSelects which GS handler to instantiate (default is '%s').\r\n",
 		       validGsHandlerNamesString.c_str(), DEFAULT_GS_HANDLER_NAME);
+		printf("\t --jobs <count>\t Runs <count> tests at the same time, 0 uses one per hardware thread (default is 1).\r\n");
+		printf("\t --timeout <seconds>\t Fails tests that run for longer than <seconds> (default is no limit).\r\n");
+		printf("\t --isolate\t Runs every test in its own process.\r\n");
 		return -1;
 	}
 
 	TestReportWriterPtr testReportWriter;
 	fs::path autoTestRoot;
 	fs::path reportPath;
-	std::string gsHandlerName = DEFAULT_GS_HANDLER_NAME;
-	assert(g_validGsHandlersNames.find(gsHandlerName) != std::end(g_validGsHandlersNames));
+	TESTOPTIONS options;
+	unsigned int jobCount = 1;
+	bool isolate = false;
+	fs::path runTestPath;
+	fs::path runPath;
+	assert(g_validGsHandlersNames.find(options.gsHandlerName) != std::end(g_validGsHandlersNames));
 
 	for(int i = 1; i < argc; i++)
 	{
@@ -278,12 +479,61 @@ int main(int argc, const char** argv)
 				printf("Error: GS handler name must be specified for --gshandler option.\r\n");
 				return -1;
 			}
-			gsHandlerName = argv[i + 1];
-			if(g_validGsHandlersNames.find(gsHandlerName) == std::end(g_validGsHandlersNames))
+			options.gsHandlerName = argv[i + 1];
+			if(g_validGsHandlersNames.find(options.gsHandlerName) == std::end(g_validGsHandlersNames))
+			{
+				printf("Error: Invalid GS handler name '%s'.\r\n", options.gsHandlerName.c_str());
+				return -1;
+			}
+			i++;
+		}
+		else if(!strcmp(argv[i], "--jobs"))
+		{
+			if((i + 1) >= argc)
+			{
+				printf("Error: Count must be specified for --jobs option.\r\n");
+				return -1;
+			}
+			jobCount = strtoul(argv[i + 1], nullptr, 10);
+			if(jobCount == 0)
+			{
+				jobCount = std::max<unsigned int>(std::thread::hardware_concurrency(), 1);
+			}
+			i++;
+		}
+		else if(!strcmp(argv[i], "--timeout"))
+		{
+			if((i + 1) >= argc)
+			{
+				printf("Error: Time must be specified for --timeout option.\r\n");
+				return -1;
+			}
+			options.timeout = strtoul(argv[i + 1], nullptr, 10);
+			i++;
+		}
+		else if(!strcmp(argv[i], "--isolate"))
+		{
+			isolate = true;
+		}
+		//--runtest and --runpath are used by --isolate to run a single test in a child process
+		else if(!strcmp(argv[i], "--runtest"))
+		{
+			if((i + 1) >= argc)
+			{
+				printf("Error: Path must be specified for --runtest option.\r\n");
+				return -1;
+			}
+			runTestPath = fs::path(argv[i + 1]);
+			i++;
+		}
+		else if(!strcmp(argv[i], "--runpath"))
+		{
+			if((i + 1) >= argc)
 			{
-				printf("Error: Invalid GS handler name '%s'.\r\n", gsHandlerName.c_str());
+				printf("Error: Path must be specified for --runpath option.\r\n");
 				return -1;
 			}
+			runPath = fs::path(argv[i + 1]);
 			i++;
 		}
 		else
@@ -293,15 +543,38 @@ int main(int argc, const char** argv)
 		}
 	}
 
+	if(!runTestPath.empty())
+	{
+		try
+		{
+			WriteTestRun(runPath, ExecuteTest(runTestPath, options));
+		}
+		catch(const std::exception& exception)
+		{
+			printf("Error: Failed to execute test: %s\r\n", exception.what());
+			return -1;
+		}
+		return 0;
+	}
+
 	if(autoTestRoot.empty())
 	{
 		printf("Error: No test directory specified.\r\n");
 		return -1;
 	}
 
+	//Windowed GS handlers all use the same window
+	if((jobCount > 1) && !isolate && (options.gsHandlerName != GS_HANDLER_NAME_NULL))
+	{
+		printf("Error: Running tests in parallel requires --isolate with GS handler '%s'.\r\n", options.gsHandlerName.c_str());
+		return -1;
+	}
+
 	try
 	{
-		ScanAndExecuteTests(autoTestRoot, testReportWriter, gsHandlerName);
+		TestPathArray testPaths;
+		ScanTests(autoTestRoot, testPaths);
+		ExecuteTests(testPaths, testReportWriter, options, jobCount, isolate ? argv[0] : std::string());
 	}
 	catch(const std::exception& exception)
 	{
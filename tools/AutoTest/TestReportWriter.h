@@ -1,6 +1,7 @@
 #pragma once
 
 #include "filesystem_def.h"
+#include "Types.h"
 #include <string>
 #include <memory>
 #include <vector>
@@ -11,12 +12,30 @@ struct LINEDIFF
 	std::string result;
 };
 
+struct TESTMETRICS
+{
+	//Time spent running the test, in seconds
+	double wallTime = 0;
+	uint64 eeCycles = 0;
+	uint32 frameCount = 0;
+
+	//Fraction of the emulated time each processor was busy
+	float eeUtilisation = 0;
+	float iopUtilisation = 0;
+	float vu0Utilisation = 0;
+	float vu1Utilisation = 0;
+};
+
 struct TESTRESULT
 {
 	typedef std::vector<LINEDIFF> LineDiffArray;
 
 	bool succeeded = false;
+	bool timedOut = false;
+	//Set if the test couldn't run to completion (ie.: the process running it crashed)
+	std::string error;
 	LineDiffArray lineDiffs;
+	TESTMETRICS metrics;
 };
 
 class CTestReportWriter
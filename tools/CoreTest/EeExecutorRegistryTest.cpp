@@ -0,0 +1,62 @@
+#include <atomic>
+#include <memory>
+#include <thread>
+#include "EeExecutorRegistryTest.h"
+#include "AlignedAlloc.h"
+#include "Ps2Const.h"
+#include "MIPS.h"
+#include "ee/EeExecutor.h"
+
+class CRegistryTestExecutor : public CEeExecutor
+{
+public:
+	using CEeExecutor::CEeExecutor;
+	using CEeExecutor::SetMemoryProtected;
+};
+
+void CEeExecutorRegistryTest::Execute()
+{
+#if defined(_WIN32) || defined(__unix__) || defined(__ANDROID__)
+	enum
+	{
+		FAULT_COUNT = 2000,
+		PROTECTED_ADDRESS = 0x100000,
+	};
+
+	size_t pageSize = framework_getpagesize();
+	auto faultRam = reinterpret_cast<uint8*>(framework_aligned_alloc(PS2::EE_RAM_SIZE, pageSize));
+	auto churnRam = reinterpret_cast<uint8*>(framework_aligned_alloc(PS2::EE_RAM_SIZE, pageSize));
+
+	CMIPS faultCpu(MEMORYMAP_ENDIAN_LSBF);
+	CRegistryTestExecutor faultExecutor(faultCpu, faultRam);
+	faultExecutor.AddExceptionHandler();
+
+	//Other executors come and go while faults are handled, like virtual machines being created and destroyed
+	std::atomic<bool> faultsDone = false;
+	std::thread churnThread(
+	    [&]() {
+		    CMIPS churnCpu(MEMORYMAP_ENDIAN_LSBF);
+		    while(!faultsDone)
+		    {
+			    auto churnExecutor = std::make_unique<CEeExecutor>(churnCpu, churnRam);
+			    churnExecutor->AddExceptionHandler();
+			    churnExecutor->RemoveExceptionHandler();
+		    }
+	    });
+
+	for(uint32 i = 0; i < FAULT_COUNT; i++)
+	{
+		faultExecutor.SetMemoryProtected(faultRam + PROTECTED_ADDRESS, pageSize, true);
+		//Faults, the handler removes the protection and the write goes through
+		faultRam[PROTECTED_ADDRESS] = static_cast<uint8>(i);
+		TEST_VERIFY(faultRam[PROTECTED_ADDRESS] == static_cast<uint8>(i));
+	}
+
+	faultsDone = true;
+	churnThread.join();
+	faultExecutor.RemoveExceptionHandler();
+
+	framework_aligned_free(churnRam);
+	framework_aligned_free(faultRam);
+#endif
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Test.h"
+
+class CEeExecutorRegistryTest : public CTest
+{
+public:
+	void Execute() override;
+};
@@ -0,0 +1,109 @@
+#include <cstring>
+#include "FrameDumpStreamTest.h"
+
+enum
+{
+	FRAME_COUNT = 7,
+	KEYFRAME_INTERVAL = 2,
+	FULL_KEYFRAME_INTERVAL = 2,
+	IMAGE_SIZE = 0x40,
+};
+
+void CFrameDumpStreamTest::Execute()
+{
+	//Stream is owned by the writer, but stays readable until the writer is destroyed
+	auto stream = new Framework::CMemStream();
+	CFrameDumpStreamWriter writer(CFrameDumpStreamWriter::StreamPtr(stream), KEYFRAME_INTERVAL, FULL_KEYFRAME_INTERVAL);
+	auto frameRams = WriteCapture(writer);
+
+	CheckRoundTrip(*stream, frameRams);
+	CheckTruncated(*stream, frameRams);
+}
+
+//Every frame has a register packet and an image packet, and changes one page of GS RAM.
+//Returns GS RAM's contents at the start of every frame.
+CFrameDumpStreamTest::FrameRamArray CFrameDumpStreamTest::WriteCapture(CFrameDumpStreamWriter& writer)
+{
+	FrameRamArray frameRams;
+	std::vector<uint8> gsRam(CGSHandler::RAMSIZE, 0);
+	uint64 gsRegisters[CGSHandler::REGISTER_MAX] = {};
+
+	for(uint32 frameIndex = 0; frameIndex < FRAME_COUNT; frameIndex++)
+	{
+		//Same as the GS handler, keyframes are written before the frame's first packet
+		gsRegisters[CGSHandler::GS_REG_FRAME_1] = frameIndex;
+		if(writer.IsKeyFrameNeeded())
+		{
+			writer.WriteKeyFrame(gsRam.data(), gsRegisters, frameIndex);
+		}
+		frameRams.push_back(gsRam);
+
+		CGSHandler::RegisterWrite registerWrite(CGSHandler::GS_REG_PRIM, frameIndex);
+		CGsPacketMetadata metadata(frameIndex % 3);
+		writer.AddRegisterPacket(&registerWrite, 1, &metadata);
+
+		uint8 imageData[IMAGE_SIZE];
+		memset(imageData, frameIndex, sizeof(imageData));
+		writer.AddImagePacket(imageData, sizeof(imageData));
+
+		writer.EndFrame();
+
+		memset(gsRam.data() + (frameIndex * FrameDumpStream::KEYFRAME_PAGE_SIZE), frameIndex + 1, FrameDumpStream::KEYFRAME_PAGE_SIZE);
+	}
+	writer.Finish();
+
+	return frameRams;
+}
+
+void CFrameDumpStreamTest::CheckFrame(CFrameDumpStreamReader& reader, uint32 frameIndex, const FrameRamArray& frameRams)
+{
+	CFrameDump frameDump;
+	uint32 leadInPacketCount = reader.ReadFrame(frameIndex, frameDump);
+
+	//State comes from the keyframe that starts the frame's block
+	uint32 keyFrameIndex = frameIndex - (frameIndex % KEYFRAME_INTERVAL);
+	TEST_VERIFY(leadInPacketCount == ((frameIndex - keyFrameIndex) * 2));
+	TEST_VERIFY(!memcmp(frameDump.GetInitialGsRam(), frameRams[keyFrameIndex].data(), CGSHandler::RAMSIZE));
+	TEST_VERIFY(frameDump.GetInitialGsRegisters()[CGSHandler::GS_REG_FRAME_1] == keyFrameIndex);
+	TEST_VERIFY(frameDump.GetInitialSMODE2() == keyFrameIndex);
+
+	const auto& packets = frameDump.GetPackets();
+	TEST_VERIFY(packets.size() == (leadInPacketCount + 2));
+	for(uint32 i = keyFrameIndex; i <= frameIndex; i++)
+	{
+		const auto& registerPacket = packets[(i - keyFrameIndex) * 2];
+		TEST_VERIFY(registerPacket.registerWrites.size() == 1);
+		TEST_VERIFY(registerPacket.registerWrites[0].first == CGSHandler::GS_REG_PRIM);
+		TEST_VERIFY(registerPacket.registerWrites[0].second == i);
+		TEST_VERIFY(registerPacket.metadata.pathIndex == (i % 3));
+
+		const auto& imagePacket = packets[((i - keyFrameIndex) * 2) + 1];
+		TEST_VERIFY(imagePacket.registerWrites.empty());
+		TEST_VERIFY(imagePacket.imageData.size() == IMAGE_SIZE);
+		TEST_VERIFY(imagePacket.imageData[0] == i);
+	}
+}
+
+void CFrameDumpStreamTest::CheckRoundTrip(Framework::CMemStream& stream, const FrameRamArray& frameRams)
+{
+	CFrameDumpStreamReader reader(stream);
+	TEST_VERIFY(reader.GetFrameCount() == FRAME_COUNT);
+
+	//Out of order, some frames need partial keyframes to be applied on top of full ones
+	for(uint32 frameIndex : {5, 0, 3, 6, 2, 1, 4})
+	{
+		CheckFrame(reader, frameIndex, frameRams);
+	}
+}
+
+void CFrameDumpStreamTest::CheckTruncated(Framework::CMemStream& stream, const FrameRamArray& frameRams)
+{
+	//Capture interrupted in the middle of its last block, only complete blocks can be read
+	Framework::CMemStream truncatedStream;
+	truncatedStream.Write(stream.GetBuffer(), stream.GetSize() - 1);
+	truncatedStream.Seek(0, Framework::STREAM_SEEK_SET);
+
+	CFrameDumpStreamReader reader(truncatedStream);
+	TEST_VERIFY(reader.GetFrameCount() == (FRAME_COUNT - (FRAME_COUNT % KEYFRAME_INTERVAL)));
+	CheckFrame(reader, reader.GetFrameCount() - 1, frameRams);
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+#include "Test.h"
+#include "MemStream.h"
+#include "FrameDumpStream.h"
+
+class CFrameDumpStreamTest : public CTest
+{
+public:
+	void Execute() override;
+
+private:
+	typedef std::vector<std::vector<uint8>> FrameRamArray;
+
+	static FrameRamArray WriteCapture(CFrameDumpStreamWriter&);
+	static void CheckFrame(CFrameDumpStreamReader&, uint32, const FrameRamArray&);
+
+	void CheckRoundTrip(Framework::CMemStream&, const FrameRamArray&);
+	void CheckTruncated(Framework::CMemStream&, const FrameRamArray&);
+};
@@ -0,0 +1,83 @@
+#include <cstring>
+#include "GprUpperHalfHintTest.h"
+#include "ee/EeBasicBlock.h"
+
+class CGprUpperHalfHintTestBlock : public CEeBasicBlock
+{
+public:
+	using CEeBasicBlock::CEeBasicBlock;
+	using CEeBasicBlock::ComputeGprUpperHalfCompileHints;
+};
+
+CGprUpperHalfHintTest::CGprUpperHalfHintTest()
+    : m_cpu(MEMORYMAP_ENDIAN_LSBF)
+    , m_cpuArch(MIPS_REGSIZE_64)
+{
+	m_cpu.m_pMemoryMap->InsertReadMap(0, RAM_SIZE - 1, m_ram, 0x01);
+	m_cpu.m_pMemoryMap->InsertInstructionMap(0, RAM_SIZE - 1, m_ram, 0x01);
+	m_cpu.m_pArch = &m_cpuArch;
+}
+
+void CGprUpperHalfHintTest::Execute()
+{
+	CheckDeadUpperHalf();
+	CheckUpperHalfReadByDaddu();
+	CheckUpperHalfReadBySd();
+}
+
+std::vector<uint32> CGprUpperHalfHintTest::ComputeHints(const AssembleFunction& assembleFunction)
+{
+	memset(m_ram, 0, sizeof(m_ram));
+	unsigned int programSize = 0;
+	{
+		CMIPSAssembler assembler(reinterpret_cast<uint32*>(m_ram + BLOCK_ADDRESS));
+		assembleFunction(assembler);
+		programSize = assembler.GetProgramSize();
+	}
+	TEST_VERIFY(programSize != 0);
+
+	uint32 endAddress = BLOCK_ADDRESS + ((programSize - 1) * 4);
+	CGprUpperHalfHintTestBlock block(m_cpu, BLOCK_ADDRESS, endAddress);
+	auto hints = block.ComputeGprUpperHalfCompileHints();
+	TEST_VERIFY(hints.size() == programSize);
+	return hints;
+}
+
+void CGprUpperHalfHintTest::CheckDeadUpperHalf()
+{
+	//T0 is overwritten before anything reads it, first store of its upper half can be skipped
+	auto hints = ComputeHints(
+	    [](CMIPSAssembler& assembler) {
+		    assembler.ADDU(CMIPS::T0, CMIPS::A0, CMIPS::A1);
+		    assembler.ADDU(CMIPS::T0, CMIPS::A2, CMIPS::A3);
+	    });
+	TEST_VERIFY((hints[0] & CMA_MIPSIV::COMPILEHINT_SKIPUPPERHALF) != 0);
+	//Last writer is always kept since successors might read it
+	TEST_VERIFY((hints[1] & CMA_MIPSIV::COMPILEHINT_SKIPUPPERHALF) == 0);
+}
+
+void CGprUpperHalfHintTest::CheckUpperHalfReadByDaddu()
+{
+	//DADDU reads the whole 64 bits of T0, its upper half must be written
+	auto hints = ComputeHints(
+	    [](CMIPSAssembler& assembler) {
+		    assembler.ADDU(CMIPS::T0, CMIPS::A0, CMIPS::A1);
+		    assembler.DADDU(CMIPS::T1, CMIPS::T0, CMIPS::R0);
+		    assembler.ADDU(CMIPS::T0, CMIPS::A2, CMIPS::A3);
+	    });
+	TEST_VERIFY((hints[0] & CMA_MIPSIV::COMPILEHINT_SKIPUPPERHALF) == 0);
+	TEST_VERIFY((hints[2] & CMA_MIPSIV::COMPILEHINT_SKIPUPPERHALF) == 0);
+}
+
+void CGprUpperHalfHintTest::CheckUpperHalfReadBySd()
+{
+	//SD stores the whole 64 bits of T0, its upper half must be written
+	auto hints = ComputeHints(
+	    [](CMIPSAssembler& assembler) {
+		    assembler.ADDU(CMIPS::T0, CMIPS::A0, CMIPS::A1);
+		    assembler.SD(CMIPS::T0, 0, CMIPS::A2);
+		    assembler.ADDU(CMIPS::T0, CMIPS::A2, CMIPS::A3);
+	    });
+	TEST_VERIFY((hints[0] & CMA_MIPSIV::COMPILEHINT_SKIPUPPERHALF) == 0);
+	TEST_VERIFY((hints[2] & CMA_MIPSIV::COMPILEHINT_SKIPUPPERHALF) == 0);
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include "Test.h"
+#include "MIPS.h"
+#include "MA_MIPSIV.h"
+#include "MIPSAssembler.h"
+
+class CGprUpperHalfHintTest : public CTest
+{
+public:
+	CGprUpperHalfHintTest();
+
+	void Execute() override;
+
+private:
+	enum
+	{
+		RAM_SIZE = 0x1000,
+		BLOCK_ADDRESS = 0x100,
+	};
+
+	typedef std::function<void(CMIPSAssembler&)> AssembleFunction;
+
+	std::vector<uint32> ComputeHints(const AssembleFunction&);
+
+	void CheckDeadUpperHalf();
+	void CheckUpperHalfReadByDaddu();
+	void CheckUpperHalfReadBySd();
+
+	CMIPS m_cpu;
+	CMA_MIPSIV m_cpuArch;
+	uint8 m_ram[RAM_SIZE];
+};
@@ -0,0 +1,71 @@
+#include <string>
+#include "GuestProfilerTest.h"
+#include "GuestProfiler.h"
+#include "MemStream.h"
+#include "MIPS.h"
+
+void CGuestProfilerTest::Execute()
+{
+	enum
+	{
+		MAIN_ADDRESS = 0x1000,
+		FUNC_ADDRESS = 0x2000,
+		UNKNOWN_ADDRESS = 0x3000,
+		FUNCTION_SIZE = 0x100,
+	};
+
+	CMIPS cpu(MEMORYMAP_ENDIAN_LSBF);
+	cpu.m_pAddrTranslator = CMIPS::TranslateAddress64;
+
+	CGuestProfiler::SymbolMap symbols;
+	for(const auto& symbolPair : {std::make_pair(MAIN_ADDRESS, "main"), std::make_pair(FUNC_ADDRESS, "func")})
+	{
+		CGuestProfiler::FUNCTION_SYMBOL symbol;
+		symbol.end = symbolPair.first + FUNCTION_SIZE;
+		symbol.name = symbolPair.second;
+		symbols[symbolPair.first] = symbol;
+	}
+
+	CGuestProfiler profiler;
+	profiler.SetContext(CGuestProfiler::CONTEXT_EE, "EE", &cpu);
+	profiler.SetSymbols(CGuestProfiler::CONTEXT_EE, std::move(symbols));
+
+	//Sampling is due once every interval, and never when stopped
+	TEST_VERIFY(!profiler.IsSamplingDue());
+	profiler.Start(3);
+	for(uint32 i = 0; i < 2; i++)
+	{
+		TEST_VERIFY(!profiler.IsSamplingDue());
+		TEST_VERIFY(!profiler.IsSamplingDue());
+		TEST_VERIFY(profiler.IsSamplingDue());
+	}
+
+	//Without analysis info, the call stack is made of the current function and its caller
+	cpu.m_State.nPC = FUNC_ADDRESS + 0x10;
+	cpu.m_State.nGPR[CMIPS::RA].nV0 = MAIN_ADDRESS + 0x20;
+	for(uint32 i = 0; i < 3; i++)
+	{
+		profiler.SampleCallStack(CGuestProfiler::CONTEXT_EE, false);
+	}
+	profiler.SampleCallStack(CGuestProfiler::CONTEXT_EE, true);
+	profiler.SampleCallStack(CGuestProfiler::CONTEXT_EE, true);
+	cpu.m_State.nPC = UNKNOWN_ADDRESS;
+	profiler.SampleAddress(CGuestProfiler::CONTEXT_EE);
+	TEST_VERIFY(profiler.GetSampleCount() == 6);
+
+	profiler.Stop();
+	TEST_VERIFY(!profiler.IsActive());
+	TEST_VERIFY(!profiler.IsSamplingDue());
+
+	Framework::CMemStream stream;
+	profiler.WriteFoldedStacks(stream);
+	std::string foldedStacks(reinterpret_cast<const char*>(stream.GetBuffer()), stream.GetSize());
+	TEST_VERIFY(foldedStacks ==
+	            "EE;[idle] 2\n"
+	            "EE;main;func 3\n"
+	            "EE;sub_00003000 1\n");
+
+	//Starting again drops previous samples
+	profiler.Start();
+	TEST_VERIFY(profiler.GetSampleCount() == 0);
+}
@@ -0,0 +1,136 @@
+#include <cstring>
+#include "IdleLoopTest.h"
+#include "BasicBlock.h"
+
+class CIdleLoopTestBlock : public CBasicBlock
+{
+public:
+	using CBasicBlock::CBasicBlock;
+	using CBasicBlock::IsIdleLoopBlock;
+};
+
+CIdleLoopTest::CIdleLoopTest()
+    : m_cpu(MEMORYMAP_ENDIAN_LSBF)
+    , m_cpuArch(MIPS_REGSIZE_64)
+{
+	m_cpu.m_pMemoryMap->InsertReadMap(0, RAM_SIZE - 1, m_ram, 0x01);
+	m_cpu.m_pMemoryMap->InsertInstructionMap(0, RAM_SIZE - 1, m_ram, 0x01);
+	m_cpu.m_pArch = &m_cpuArch;
+}
+
+void CIdleLoopTest::Execute()
+{
+	CheckCountdownLoop();
+	CheckPollingLoop();
+	CheckUnloadedCompare();
+	CheckSelfModifyingLoad();
+	CheckUnconditionalLoop();
+	CheckEeLoads();
+}
+
+bool CIdleLoopTest::IsIdleLoop(const AssembleFunction& assembleFunction, bool eeLoadsAllowed)
+{
+	memset(m_ram, 0, sizeof(m_ram));
+	unsigned int programSize = 0;
+	{
+		CMIPSAssembler assembler(reinterpret_cast<uint32*>(m_ram + LOOP_ADDRESS));
+		assembleFunction(assembler);
+		programSize = assembler.GetProgramSize();
+	}
+	TEST_VERIFY(programSize >= 2);
+
+	uint32 endAddress = LOOP_ADDRESS + ((programSize - 1) * 4);
+	CIdleLoopTestBlock block(m_cpu, LOOP_ADDRESS, endAddress);
+	return block.IsIdleLoopBlock(eeLoadsAllowed);
+}
+
+void CIdleLoopTest::CheckCountdownLoop()
+{
+	//Counter is modified at every iteration, loop will exit on its own
+	bool isIdle = IsIdleLoop(
+	    [](CMIPSAssembler& assembler) {
+		    auto loopLabel = assembler.CreateLabel();
+		    assembler.MarkLabel(loopLabel);
+		    assembler.ADDIU(CMIPS::A0, CMIPS::A0, 0xFFFF);
+		    assembler.BNE(CMIPS::A0, CMIPS::R0, loopLabel);
+		    assembler.NOP();
+	    },
+	    false);
+	TEST_VERIFY(!isIdle);
+}
+
+void CIdleLoopTest::CheckPollingLoop()
+{
+	//Waits for a flag in memory to be set by something else
+	bool isIdle = IsIdleLoop(
+	    [](CMIPSAssembler& assembler) {
+		    auto loopLabel = assembler.CreateLabel();
+		    assembler.MarkLabel(loopLabel);
+		    assembler.LW(CMIPS::V0, 0x0000, CMIPS::A0);
+		    assembler.ANDI(CMIPS::V0, CMIPS::V0, 0x0001);
+		    assembler.BEQ(CMIPS::V0, CMIPS::R0, loopLabel);
+		    assembler.NOP();
+	    },
+	    false);
+	TEST_VERIFY(isIdle);
+}
+
+void CIdleLoopTest::CheckUnloadedCompare()
+{
+	//Loads something, but the branch depends on a register that isn't changed by the loop
+	bool isIdle = IsIdleLoop(
+	    [](CMIPSAssembler& assembler) {
+		    auto loopLabel = assembler.CreateLabel();
+		    assembler.MarkLabel(loopLabel);
+		    assembler.LW(CMIPS::T0, 0x0000, CMIPS::A0);
+		    assembler.BNE(CMIPS::V0, CMIPS::R0, loopLabel);
+		    assembler.NOP();
+	    },
+	    false);
+	TEST_VERIFY(!isIdle);
+}
+
+void CIdleLoopTest::CheckSelfModifyingLoad()
+{
+	//Walks a linked list, the address changes at every iteration
+	bool isIdle = IsIdleLoop(
+	    [](CMIPSAssembler& assembler) {
+		    auto loopLabel = assembler.CreateLabel();
+		    assembler.MarkLabel(loopLabel);
+		    assembler.LW(CMIPS::A0, 0x0000, CMIPS::A0);
+		    assembler.BNE(CMIPS::A0, CMIPS::R0, loopLabel);
+		    assembler.NOP();
+	    },
+	    false);
+	TEST_VERIFY(!isIdle);
+}
+
+void CIdleLoopTest::CheckUnconditionalLoop()
+{
+	//Spins until an interrupt happens
+	bool isIdle = IsIdleLoop(
+	    [](CMIPSAssembler& assembler) {
+		    auto loopLabel = assembler.CreateLabel();
+		    assembler.MarkLabel(loopLabel);
+		    assembler.BEQ(CMIPS::R0, CMIPS::R0, loopLabel);
+		    assembler.NOP();
+	    },
+	    false);
+	TEST_VERIFY(isIdle);
+}
+
+void CIdleLoopTest::CheckEeLoads()
+{
+	auto assembleFunction =
+	    [](CMIPSAssembler& assembler) {
+		    auto loopLabel = assembler.CreateLabel();
+		    assembler.MarkLabel(loopLabel);
+		    assembler.LD(CMIPS::V0, 0x0000, CMIPS::A0);
+		    assembler.BEQ(CMIPS::V0, CMIPS::R0, loopLabel);
+		    assembler.NOP();
+	    };
+
+	//LD is only valid on the EE
+	TEST_VERIFY(IsIdleLoop(assembleFunction, true));
+	TEST_VERIFY(!IsIdleLoop(assembleFunction, false));
+}
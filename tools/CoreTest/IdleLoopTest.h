@@ -0,0 +1,37 @@
+#pragma once
+
+#include <functional>
+#include "Test.h"
+#include "MIPS.h"
+#include "MA_MIPSIV.h"
+#include "MIPSAssembler.h"
+
+class CIdleLoopTest : public CTest
+{
+public:
+	CIdleLoopTest();
+
+	void Execute() override;
+
+private:
+	enum
+	{
+		RAM_SIZE = 0x1000,
+		LOOP_ADDRESS = 0x100,
+	};
+
+	typedef std::function<void(CMIPSAssembler&)> AssembleFunction;
+
+	bool IsIdleLoop(const AssembleFunction&, bool);
+
+	void CheckCountdownLoop();
+	void CheckPollingLoop();
+	void CheckUnloadedCompare();
+	void CheckSelfModifyingLoad();
+	void CheckUnconditionalLoop();
+	void CheckEeLoads();
+
+	CMIPS m_cpu;
+	CMA_MIPSIV m_cpuArch;
+	uint8 m_ram[RAM_SIZE];
+};
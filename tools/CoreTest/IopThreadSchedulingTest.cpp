@@ -0,0 +1,41 @@
+#include "IopThreadSchedulingTest.h"
+#include "Ps2Const.h"
+#include "iop/IopBios.h"
+#include "iop/Iop_SubSystem.h"
+
+void CIopThreadSchedulingTest::Execute()
+{
+	enum
+	{
+		THREAD_PROC_ADDRESS = 0x1000,
+	};
+
+	Iop::CSubSystem subSystem(true);
+	subSystem.Reset();
+	auto bios = static_cast<CIopBios*>(subSystem.m_bios.get());
+	bios->Reset(PS2::IOP_BASE_RAM_SIZE, std::shared_ptr<Iop::CSifMan>());
+
+	//Lower value means higher priority, threads are started in the opposite order they should run
+	uint32 lowThreadId = bios->CreateThread(THREAD_PROC_ADDRESS, 0x40, 0, 0, 0);
+	uint32 highThreadId = bios->CreateThread(THREAD_PROC_ADDRESS, 0x10, 0, 0, 0);
+	uint32 mediumThreadId = bios->CreateThread(THREAD_PROC_ADDRESS, 0x20, 0, 0, 0);
+	TEST_VERIFY(static_cast<int32>(lowThreadId) > 0);
+	TEST_VERIFY(static_cast<int32>(highThreadId) > 0);
+	TEST_VERIFY(static_cast<int32>(mediumThreadId) > 0);
+
+	TEST_VERIFY(bios->StartThreadArgs(lowThreadId, 0, 0) == 0);
+	TEST_VERIFY(bios->StartThreadArgs(highThreadId, 0, 0) == 0);
+	TEST_VERIFY(bios->StartThread(mediumThreadId, 0) == 0);
+
+	for(uint32 expectedThreadId : {highThreadId, mediumThreadId, lowThreadId})
+	{
+		bios->Reschedule();
+		TEST_VERIFY(bios->GetCurrentThreadIdRaw() == static_cast<int32>(expectedThreadId));
+		TEST_VERIFY(bios->GetThread(expectedThreadId)->priority == bios->GetThread(expectedThreadId)->initPriority);
+		bios->ExitThread();
+	}
+
+	//No thread left to run
+	bios->Reschedule();
+	TEST_VERIFY(bios->GetCurrentThreadIdRaw() == -1);
+}
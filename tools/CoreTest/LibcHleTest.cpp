@@ -0,0 +1,137 @@
+#include <cstring>
+#include <utility>
+#include "LibcHleTest.h"
+#include "ee/Ee_LibcHle.h"
+
+CLibcHleTest::CLibcHleTest()
+    : m_cpu(MEMORYMAP_ENDIAN_LSBF, true)
+{
+	m_cpu.m_pAddrTranslator = CMIPS::TranslateAddress64;
+	m_cpu.MapPages(0, DIRECT_SIZE, m_ram);
+	m_cpu.m_pMemoryMap->InsertReadMap(PROXY_ADDRESS, MEMORY_SIZE - 1, m_proxyRam, 0x01);
+	m_cpu.m_pMemoryMap->InsertWriteMap(PROXY_ADDRESS, MEMORY_SIZE - 1, m_proxyRam, 0x01);
+}
+
+void CLibcHleTest::Execute()
+{
+	CheckMemcpy();
+	CheckMemcpyOverlap();
+	CheckMemset();
+	CheckStrcpy();
+
+	//No pattern is available for these
+	TEST_VERIFY(Ee::LibcHle::GetFunctionHandler("strlen") == nullptr);
+	TEST_VERIFY(Ee::LibcHle::GetFunctionHandler("strcmp") == nullptr);
+}
+
+void CLibcHleTest::Reset()
+{
+	for(uint32 address = 0; address < MEMORY_SIZE; address++)
+	{
+		*GetMemory(address) = static_cast<uint8>(address * 7);
+	}
+	m_cpu.m_State.cycleQuota = 0;
+}
+
+uint8* CLibcHleTest::GetMemory(uint32 address)
+{
+	return (address < DIRECT_SIZE) ? (m_ram + address) : (m_proxyRam + (address - PROXY_ADDRESS));
+}
+
+uint32 CLibcHleTest::CallHandler(const char* name, uint32 arg0, uint32 arg1, uint32 arg2)
+{
+	auto handler = Ee::LibcHle::GetFunctionHandler(name);
+	TEST_VERIFY(handler);
+	m_cpu.m_State.nGPR[CMIPS::A0].nD0 = static_cast<int32>(arg0);
+	m_cpu.m_State.nGPR[CMIPS::A1].nD0 = static_cast<int32>(arg1);
+	m_cpu.m_State.nGPR[CMIPS::A2].nD0 = static_cast<int32>(arg2);
+	handler(&m_cpu);
+	//Guest routines are charged for their work
+	TEST_VERIFY(m_cpu.m_State.cycleQuota < 0);
+	return m_cpu.m_State.nGPR[CMIPS::V0].nV0;
+}
+
+void CLibcHleTest::CheckMemcpy()
+{
+	//Crosses page boundaries on both sides, the second copy ends in the proxied page
+	for(const auto& copyParams : {std::make_pair(0x0F80U, 0x1F40U), std::make_pair(0x0FF0U, 0x2F00U), std::make_pair(0x2F80U, 0x1000U)})
+	{
+		static const uint32 size = 0x180;
+		uint32 srcAddress = copyParams.first;
+		uint32 dstAddress = copyParams.second;
+		Reset();
+		uint8 expected[size];
+		for(uint32 i = 0; i < size; i++)
+		{
+			expected[i] = *GetMemory(srcAddress + i);
+		}
+		uint8 before = *GetMemory(dstAddress - 1);
+		uint8 after = *GetMemory(dstAddress + size);
+		TEST_VERIFY(CallHandler("memcpy", dstAddress, srcAddress, size) == dstAddress);
+		for(uint32 i = 0; i < size; i++)
+		{
+			TEST_VERIFY(*GetMemory(dstAddress + i) == expected[i]);
+		}
+		TEST_VERIFY(*GetMemory(dstAddress - 1) == before);
+		TEST_VERIFY(*GetMemory(dstAddress + size) == after);
+	}
+}
+
+void CLibcHleTest::CheckMemcpyOverlap()
+{
+	//Forward copy over its own source repeats the first bytes, in direct and proxied memory
+	for(uint32 srcAddress : {0x0FF8U, 0x3100U})
+	{
+		static const uint32 size = 0x20;
+		static const uint32 distance = 3;
+		Reset();
+		uint8 expected[size + distance];
+		for(uint32 i = 0; i < (size + distance); i++)
+		{
+			expected[i] = (i < distance) ? *GetMemory(srcAddress + i) : expected[i - distance];
+		}
+		TEST_VERIFY(CallHandler("memcpy", srcAddress + distance, srcAddress, size) == (srcAddress + distance));
+		for(uint32 i = 0; i < (size + distance); i++)
+		{
+			TEST_VERIFY(*GetMemory(srcAddress + i) == expected[i]);
+		}
+	}
+}
+
+void CLibcHleTest::CheckMemset()
+{
+	static const uint32 dstAddress = 0x2F10;
+	static const uint32 size = 0x200;
+	Reset();
+	uint8 before = *GetMemory(dstAddress - 1);
+	uint8 after = *GetMemory(dstAddress + size);
+	//Only the lower byte of the value is used
+	TEST_VERIFY(CallHandler("memset", dstAddress, 0x1A5, size) == dstAddress);
+	for(uint32 i = 0; i < size; i++)
+	{
+		TEST_VERIFY(*GetMemory(dstAddress + i) == 0xA5);
+	}
+	TEST_VERIFY(*GetMemory(dstAddress - 1) == before);
+	TEST_VERIFY(*GetMemory(dstAddress + size) == after);
+}
+
+void CLibcHleTest::CheckStrcpy()
+{
+	//Source crosses into the next page, destination crosses into the proxied page
+	static const uint32 srcAddress = 0x1FF0;
+	static const uint32 dstAddress = 0x2FF8;
+	static const char* string = "A string longer than a few words";
+	uint32 length = static_cast<uint32>(strlen(string));
+	Reset();
+	for(uint32 i = 0; i <= length; i++)
+	{
+		*GetMemory(srcAddress + i) = string[i];
+	}
+	uint8 after = *GetMemory(dstAddress + length + 1);
+	TEST_VERIFY(CallHandler("strcpy", dstAddress, srcAddress, 0) == dstAddress);
+	for(uint32 i = 0; i <= length; i++)
+	{
+		TEST_VERIFY(*GetMemory(dstAddress + i) == static_cast<uint8>(string[i]));
+	}
+	TEST_VERIFY(*GetMemory(dstAddress + length + 1) == after);
+}
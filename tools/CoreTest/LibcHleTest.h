@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Test.h"
+#include "MIPS.h"
+
+class CLibcHleTest : public CTest
+{
+public:
+	CLibcHleTest();
+
+	void Execute() override;
+
+private:
+	enum
+	{
+		//Pages below this are accessed through the page table, the last one only through the memory map
+		DIRECT_SIZE = 3 * MIPS_PAGE_SIZE,
+		PROXY_ADDRESS = DIRECT_SIZE,
+		MEMORY_SIZE = DIRECT_SIZE + MIPS_PAGE_SIZE,
+	};
+
+	void Reset();
+	uint8* GetMemory(uint32);
+	uint32 CallHandler(const char*, uint32, uint32, uint32);
+
+	void CheckMemcpy();
+	void CheckMemcpyOverlap();
+	void CheckMemset();
+	void CheckStrcpy();
+
+	CMIPS m_cpu;
+	uint8 m_ram[DIRECT_SIZE];
+	uint8 m_proxyRam[MIPS_PAGE_SIZE];
+};
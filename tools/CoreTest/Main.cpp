@@ -0,0 +1,38 @@
+#include <functional>
+#include "EeExecutorRegistryTest.h"
+#include "FrameDumpStreamTest.h"
+#include "GprUpperHalfHintTest.h"
+#include "GuestProfilerTest.h"
+#include "IdleLoopTest.h"
+#include "IopThreadSchedulingTest.h"
+#include "LibcHleTest.h"
+#include "RewindBufferTest.h"
+#include "StateSnapshotTest.h"
+
+typedef std::function<CTest*()> TestFactoryFunction;
+
+// clang-format off
+static const TestFactoryFunction s_factories[] =
+{
+	[]() { return new CEeExecutorRegistryTest(); },
+	[]() { return new CFrameDumpStreamTest(); },
+	[]() { return new CGprUpperHalfHintTest(); },
+	[]() { return new CGuestProfilerTest(); },
+	[]() { return new CIdleLoopTest(); },
+	[]() { return new CIopThreadSchedulingTest(); },
+	[]() { return new CLibcHleTest(); },
+	[]() { return new CRewindBufferTest(); },
+	[]() { return new CStateSnapshotTest(); },
+};
+// clang-format on
+
+int main(int argc, const char** argv)
+{
+	for(const auto& factory : s_factories)
+	{
+		auto test = factory();
+		test->Execute();
+		delete test;
+	}
+	return 0;
+}
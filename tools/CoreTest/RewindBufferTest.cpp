@@ -0,0 +1,72 @@
+#include <cstring>
+#include "RewindBufferTest.h"
+#include "states/RewindBuffer.h"
+
+void CRewindBufferTest::Execute()
+{
+	enum
+	{
+		PAGE_COUNT = 0x10,
+		MEMORY_SIZE = PAGE_COUNT * StatePageUtils::STATE_PAGE_SIZE,
+		FRAME_COUNT = 4,
+	};
+
+	std::vector<uint8> memory(MEMORY_SIZE);
+	STATE_MEMORY_REGION region;
+	region.name = "RAM";
+	region.memory = memory.data();
+	region.size = MEMORY_SIZE;
+	StateMemoryRegionList regions = {region};
+
+	//Every frame changes a different page, only that page ends up in the previous state's delta
+	CRewindBuffer rewindBuffer;
+	rewindBuffer.SetMemoryBudget(~0ULL);
+	std::vector<std::vector<uint8>> frameMemories;
+	for(uint32 frame = 0; frame < FRAME_COUNT; frame++)
+	{
+		memset(memory.data() + (frame * StatePageUtils::STATE_PAGE_SIZE), frame + 1, StatePageUtils::STATE_PAGE_SIZE);
+		frameMemories.push_back(memory);
+		CRewindBuffer::ArchiveData archiveData = {static_cast<uint8>(frame)};
+		uint64 captureSize = rewindBuffer.Capture(archiveData, regions);
+		if(frame == 0)
+		{
+			TEST_VERIFY(captureSize == rewindBuffer.GetMemoryUsage());
+		}
+		else
+		{
+			TEST_VERIFY(captureSize < StatePageUtils::STATE_PAGE_SIZE);
+		}
+	}
+	TEST_VERIFY(rewindBuffer.GetStateCount() == FRAME_COUNT);
+
+	//Rewinding gives back every frame, latest first, and stops at the oldest one
+	for(uint32 frame = FRAME_COUNT; frame-- > 0;)
+	{
+		const auto& archiveData = rewindBuffer.GetArchiveData();
+		TEST_VERIFY(archiveData.size() == 1);
+		TEST_VERIFY(archiveData[0] == frame);
+		auto contents = rewindBuffer.GetRegionContents(region);
+		TEST_VERIFY(!memcmp(contents, frameMemories[frame].data(), MEMORY_SIZE));
+		rewindBuffer.StepBack();
+	}
+	TEST_VERIFY(rewindBuffer.GetStateCount() == 1);
+	TEST_VERIFY(!memcmp(rewindBuffer.GetRegionContents(region), frameMemories[0].data(), MEMORY_SIZE));
+
+	//Going over budget drops the oldest states, the latest one is always kept
+	for(uint32 frame = 1; frame < FRAME_COUNT; frame++)
+	{
+		memset(memory.data() + (frame * StatePageUtils::STATE_PAGE_SIZE), frame + 0x10, StatePageUtils::STATE_PAGE_SIZE);
+		CRewindBuffer::ArchiveData archiveData = {static_cast<uint8>(frame)};
+		rewindBuffer.Capture(archiveData, regions);
+	}
+	TEST_VERIFY(rewindBuffer.GetStateCount() == FRAME_COUNT);
+	rewindBuffer.SetMemoryBudget(0);
+	TEST_VERIFY(rewindBuffer.GetStateCount() == 1);
+	TEST_VERIFY(rewindBuffer.GetMemoryUsage() == (MEMORY_SIZE + 1));
+	TEST_VERIFY(rewindBuffer.GetArchiveData()[0] == (FRAME_COUNT - 1));
+	TEST_VERIFY(!memcmp(rewindBuffer.GetRegionContents(region), memory.data(), MEMORY_SIZE));
+
+	rewindBuffer.Clear();
+	TEST_VERIFY(rewindBuffer.IsEmpty());
+	TEST_VERIFY(rewindBuffer.GetMemoryUsage() == 0);
+}
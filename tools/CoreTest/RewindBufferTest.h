@@ -0,0 +1,9 @@
+#pragma once
+
+#include "Test.h"
+
+class CRewindBufferTest : public CTest
+{
+public:
+	void Execute() override;
+};
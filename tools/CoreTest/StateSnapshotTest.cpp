@@ -0,0 +1,54 @@
+#include "StateSnapshotTest.h"
+#include "PS2VM.h"
+#include "gs/GSH_Null.h"
+
+void CStateSnapshotTest::Execute()
+{
+	enum
+	{
+		//Two addresses far enough to be in different snapshot pages
+		TEST_ADDRESS_0 = 0x100000,
+		TEST_ADDRESS_1 = 0x180000,
+	};
+
+	CPS2VM virtualMachine;
+	virtualMachine.Initialize();
+	virtualMachine.CreateGSHandler(CGSH_Null::GetFactoryFunction());
+
+	auto ram = virtualMachine.m_ee->m_ram;
+	auto& gpr = virtualMachine.m_ee->m_EE.m_State.nGPR[CMIPS::T0].nV0;
+
+	ram[TEST_ADDRESS_0] = 0x11;
+	ram[TEST_ADDRESS_1] = 0x22;
+	gpr = 0x1234;
+	auto fullSnapshot = virtualMachine.CaptureStateSnapshot().get();
+	TEST_VERIFY(fullSnapshot);
+	TEST_VERIFY(fullSnapshot->IsFull());
+
+	//Only one page changes, next capture only needs to keep that one
+	ram[TEST_ADDRESS_0] = 0x33;
+	gpr = 0x5678;
+	auto deltaSnapshot = virtualMachine.CaptureStateSnapshot().get();
+	TEST_VERIFY(deltaSnapshot);
+	TEST_VERIFY(!deltaSnapshot->IsFull());
+	TEST_VERIFY(deltaSnapshot->GetBase() == fullSnapshot);
+	TEST_VERIFY(deltaSnapshot->GetDirtyPageCount() == 1);
+
+	ram[TEST_ADDRESS_0] = 0x44;
+	ram[TEST_ADDRESS_1] = 0x55;
+	gpr = 0x9ABC;
+
+	TEST_VERIFY(virtualMachine.RestoreStateSnapshot(deltaSnapshot).get());
+	TEST_VERIFY(ram[TEST_ADDRESS_0] == 0x33);
+	TEST_VERIFY(ram[TEST_ADDRESS_1] == 0x22);
+	TEST_VERIFY(gpr == 0x5678);
+
+	TEST_VERIFY(virtualMachine.RestoreStateSnapshot(fullSnapshot).get());
+	TEST_VERIFY(ram[TEST_ADDRESS_0] == 0x11);
+	TEST_VERIFY(ram[TEST_ADDRESS_1] == 0x22);
+	TEST_VERIFY(gpr == 0x1234);
+
+	TEST_VERIFY(!virtualMachine.RestoreStateSnapshot(CPS2VM::StateSnapshotPtr()).get());
+
+	virtualMachine.Destroy();
+}
@@ -0,0 +1,342 @@
+#include <algorithm>
+#include <cstring>
+#include <chrono>
+#include <limits>
+#include <memory>
+#include <set>
+#include <vector>
+#include "FrameDump.h"
+#include "FrameDumpStream.h"
+#include "StdStreamUtils.h"
+#include "filesystem_def.h"
+#include "string_format.h"
+#include "gs/GSH_Null.h"
+#if HAS_GSH_VULKAN
+#include "gs/GSH_Vulkan/GSH_VulkanOffscreen.h"
+#endif
+
+#define GS_HANDLER_NAME_NULL "null"
+#define GS_HANDLER_NAME_VULKAN "vulkan"
+
+#define DEFAULT_GS_HANDLER_NAME GS_HANDLER_NAME_NULL
+#define DEFAULT_ITERATION_COUNT 10
+
+#define FRAME_DUMP_STREAM_EXTENSION ".dmps"
+
+static std::set<std::string> g_validGsHandlersNames =
+    {
+        GS_HANDLER_NAME_NULL,
+#if HAS_GSH_VULKAN
+        GS_HANDLER_NAME_VULKAN,
+#endif
+};
+
+typedef std::chrono::high_resolution_clock Clock;
+typedef std::chrono::duration<double> Seconds;
+
+struct DUMPSTATS
+{
+	uint64 packetCount = 0;
+	uint64 registerWriteCount = 0;
+	uint64 drawCount = 0;
+	uint64 transferBytes = 0;
+};
+
+struct PHASETIMES
+{
+	double init = 0;
+	double submit = 0;
+	double finish = 0;
+
+	double GetTotal() const
+	{
+		return init + submit + finish;
+	}
+};
+
+std::unique_ptr<CGSHandler> CreateGsHandler(const std::string& gsHandlerName)
+{
+	if(gsHandlerName == GS_HANDLER_NAME_NULL)
+	{
+		return std::make_unique<CGSH_Null>();
+	}
+#if HAS_GSH_VULKAN
+	else if(gsHandlerName == GS_HANDLER_NAME_VULKAN)
+	{
+		//Any Vulkan driver will do, including software ones such as lavapipe
+		return std::make_unique<CGSH_VulkanOffscreen>();
+	}
+#endif
+	else
+	{
+		throw std::runtime_error("Unknown GS handler name.");
+	}
+}
+
+//Frame dump streams hold many frames, only one of them is replayed along with the lead-in from its keyframe
+void LoadFrameDump(const fs::path& dumpPath, int frameIndex, CFrameDump& frameDump)
+{
+	auto inputStream = Framework::CreateInputStdStream(dumpPath.native());
+	if(dumpPath.extension() == FRAME_DUMP_STREAM_EXTENSION)
+	{
+		CFrameDumpStreamReader reader(inputStream);
+		uint32 frameCount = reader.GetFrameCount();
+		if(frameCount == 0)
+		{
+			throw std::runtime_error("Frame dump stream doesn't contain any frame.");
+		}
+		uint32 streamFrameIndex = (frameIndex < 0) ? (frameCount - 1) : static_cast<uint32>(frameIndex);
+		reader.ReadFrame(streamFrameIndex, frameDump);
+	}
+	else
+	{
+		frameDump.Read(inputStream);
+	}
+	frameDump.IdentifyDrawingKicks();
+}
+
+DUMPSTATS ComputeDumpStats(const CFrameDump& frameDump)
+{
+	DUMPSTATS stats;
+	for(const auto& packet : frameDump.GetPackets())
+	{
+		stats.packetCount++;
+		stats.registerWriteCount += packet.registerWrites.size();
+		stats.transferBytes += packet.imageData.size();
+	}
+	stats.drawCount = frameDump.GetDrawingKicks().size();
+	return stats;
+}
+
+PHASETIMES ReplayFrameDump(CGSHandler* gs, CFrameDump& frameDump)
+{
+	PHASETIMES times;
+
+	auto initStart = Clock::now();
+	gs->Reset();
+	gs->InitFromFrameDump(&frameDump);
+	gs->Finish(true);
+	auto submitStart = Clock::now();
+
+	//Same as what the GIF does, process the writes of every packet as they come
+	for(const auto& packet : frameDump.GetPackets())
+	{
+		if(packet.registerWrites.empty())
+		{
+			gs->ProcessWriteBuffer(nullptr);
+			gs->FeedImageData(packet.imageData.data(), packet.imageData.size());
+		}
+		else
+		{
+			for(const auto& registerWrite : packet.registerWrites)
+			{
+				gs->WriteRegister(registerWrite);
+			}
+			gs->ProcessWriteBuffer(&packet.metadata);
+		}
+	}
+	gs->ProcessWriteBuffer(nullptr);
+	auto finishStart = Clock::now();
+
+	//Submission is asynchronous, wait for the GS thread to be done with everything
+	gs->Finish(true);
+	auto finishEnd = Clock::now();
+
+	times.init = Seconds(submitStart - initStart).count();
+	times.submit = Seconds(finishStart - submitStart).count();
+	times.finish = Seconds(finishEnd - finishStart).count();
+	return times;
+}
+
+std::string MakePhaseJson(const char* name, const std::vector<PHASETIMES>& times, double PHASETIMES::*phase)
+{
+	double total = 0;
+	double minTime = std::numeric_limits<double>::max();
+	double maxTime = 0;
+	for(const auto& time : times)
+	{
+		double value = time.*phase;
+		total += value;
+		minTime = std::min(minTime, value);
+		maxTime = std::max(maxTime, value);
+	}
+	return string_format("\t\t\"%s\": { \"avg_ms\": %f, \"min_ms\": %f, \"max_ms\": %f }",
+	                     name, (total * 1000.0) / times.size(), minTime * 1000.0, maxTime * 1000.0);
+}
+
+std::string MakeReportJson(const fs::path& dumpPath, const std::string& gsHandlerName, const DUMPSTATS& stats, const std::vector<PHASETIMES>& times)
+{
+	double totalTime = 0;
+	for(const auto& time : times)
+	{
+		totalTime += time.GetTotal();
+	}
+	double iterationCount = static_cast<double>(times.size());
+	double packetsPerSecond = (stats.packetCount * iterationCount) / totalTime;
+	double drawsPerSecond = (stats.drawCount * iterationCount) / totalTime;
+	double transferMbPerSecond = ((stats.transferBytes * iterationCount) / (1024.0 * 1024.0)) / totalTime;
+
+	std::string result;
+	result += "{\n";
+	result += string_format("\t\"dump\": \"%s\",\n", dumpPath.filename().string().c_str());
+	result += string_format("\t\"gs_handler\": \"%s\",\n", gsHandlerName.c_str());
+	result += string_format("\t\"iterations\": %d,\n", static_cast<int>(times.size()));
+	result += string_format("\t\"packets\": %llu,\n", static_cast<unsigned long long>(stats.packetCount));
+	result += string_format("\t\"register_writes\": %llu,\n", static_cast<unsigned long long>(stats.registerWriteCount));
+	result += string_format("\t\"draws\": %llu,\n", static_cast<unsigned long long>(stats.drawCount));
+	result += string_format("\t\"transfer_bytes\": %llu,\n", static_cast<unsigned long long>(stats.transferBytes));
+	result += string_format("\t\"packets_per_second\": %f,\n", packetsPerSecond);
+	result += string_format("\t\"draws_per_second\": %f,\n", drawsPerSecond);
+	result += string_format("\t\"transfer_mb_per_second\": %f,\n", transferMbPerSecond);
+	result += "\t\"phases\": {\n";
+	result += MakePhaseJson("init", times, &PHASETIMES::init) + ",\n";
+	result += MakePhaseJson("submit", times, &PHASETIMES::submit) + ",\n";
+	result += MakePhaseJson("finish", times, &PHASETIMES::finish) + "\n";
+	result += "\t}\n";
+	result += "}\n";
+	return result;
+}
+
+int main(int argc, const char** argv)
+{
+	if(argc < 2)
+	{
+		std::string validGsHandlerNamesString;
+		for(const auto& name : g_validGsHandlersNames)
+		{
+			if(!validGsHandlerNamesString.empty())
+			{
+				validGsHandlerNamesString += "|";
+			}
+			validGsHandlerNamesString += name;
+		}
+
+		printf("Usage: GsReplayBench [options] frameDumpPath\r\n");
+		printf("Options: \r\n");
+		printf("\t --gshandler <%s>\tSelects which GS handler to instantiate (default is '%s').\r\n",
+		       validGsHandlerNamesString.c_str(), DEFAULT_GS_HANDLER_NAME);
+		printf("\t --iterations <count>\tNumber of times the frame dump is replayed (default is %d).\r\n", DEFAULT_ITERATION_COUNT);
+		printf("\t --output <path>\tWrites JSON report at <path> instead of the standard output.\r\n");
+		printf("\t --frame <index>\tFrame to replay from a frame dump stream (%s), default is the last one.\r\n", FRAME_DUMP_STREAM_EXTENSION);
+		return -1;
+	}
+
+	fs::path dumpPath;
+	fs::path outputPath;
+	std::string gsHandlerName = DEFAULT_GS_HANDLER_NAME;
+	int iterationCount = DEFAULT_ITERATION_COUNT;
+	int frameIndex = -1;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(!strcmp(argv[i], "--gshandler"))
+		{
+			if((i + 1) >= argc)
+			{
+				printf("Error: GS handler name must be specified for --gshandler option.\r\n");
+				return -1;
+			}
+			gsHandlerName = argv[i + 1];
+			if(g_validGsHandlersNames.find(gsHandlerName) == std::end(g_validGsHandlersNames))
+			{
+				printf("Error: Invalid GS handler name '%s'.\r\n", gsHandlerName.c_str());
+				return -1;
+			}
+			i++;
+		}
+		else if(!strcmp(argv[i], "--iterations"))
+		{
+			if((i + 1) >= argc)
+			{
+				printf("Error: Count must be specified for --iterations option.\r\n");
+				return -1;
+			}
+			iterationCount = atoi(argv[i + 1]);
+			if(iterationCount <= 0)
+			{
+				printf("Error: Invalid iteration count '%s'.\r\n", argv[i + 1]);
+				return -1;
+			}
+			i++;
+		}
+		else if(!strcmp(argv[i], "--output"))
+		{
+			if((i + 1) >= argc)
+			{
+				printf("Error: Path must be specified for --output option.\r\n");
+				return -1;
+			}
+			outputPath = fs::path(argv[i + 1]);
+			i++;
+		}
+		else if(!strcmp(argv[i], "--frame"))
+		{
+			if((i + 1) >= argc)
+			{
+				printf("Error: Index must be specified for --frame option.\r\n");
+				return -1;
+			}
+			frameIndex = atoi(argv[i + 1]);
+			if(frameIndex < 0)
+			{
+				printf("Error: Invalid frame index '%s'.\r\n", argv[i + 1]);
+				return -1;
+			}
+			i++;
+		}
+		else
+		{
+			dumpPath = argv[i];
+			break;
+		}
+	}
+
+	if(dumpPath.empty())
+	{
+		printf("Error: No frame dump specified.\r\n");
+		return -1;
+	}
+
+	try
+	{
+		CFrameDump frameDump;
+		LoadFrameDump(dumpPath, frameIndex, frameDump);
+
+		auto stats = ComputeDumpStats(frameDump);
+
+		auto gs = CreateGsHandler(gsHandlerName);
+		gs->SetLoggingEnabled(false);
+		gs->Initialize();
+
+		//Warm up run, shaders and other caches get filled here
+		ReplayFrameDump(gs.get(), frameDump);
+
+		std::vector<PHASETIMES> times;
+		times.reserve(iterationCount);
+		for(int i = 0; i < iterationCount; i++)
+		{
+			times.push_back(ReplayFrameDump(gs.get(), frameDump));
+		}
+
+		gs->Release();
+		gs.reset();
+
+		auto report = MakeReportJson(dumpPath, gsHandlerName, stats, times);
+		if(outputPath.empty())
+		{
+			printf("%s", report.c_str());
+		}
+		else
+		{
+			auto outputStream = Framework::CreateOutputStdStream(outputPath.native());
+			outputStream.Write(report.c_str(), report.size());
+		}
+	}
+	catch(const std::exception& exception)
+	{
+		printf("Error: Failed to run benchmark: %s\r\n", exception.what());
+		return -1;
+	}
+
+	return 0;
+}
@@ -1,6 +1,8 @@
 #include <cstdio>
 #include <cassert>
 #include <cstring>
+#include <chrono>
+#include "string_format.h"
 #include "Ps2Const.h"
 #include "iop/IopBios.h"
 #include "iop/Iop_McServ.h"
@@ -10,6 +12,7 @@
 #include "PathUtils.h"
 #include "StdStreamUtils.h"
 #include "GameTestSheet.h"
+#include "PS2VM_Preferences.h"
 
 #define MCSERV_CMD(a) (Iop::CMcServ::a | Iop::CMcServ::CMD_FLAG_DIRECT)
 
@@ -100,8 +103,188 @@ void ExecuteTest(const CGameTestSheet::TEST& test)
 	}
 }
 
+uint32 InvokeGetDir(Iop::CMcServ* mcServ, const std::string& query, std::vector<Iop::CMcServ::ENTRY>& entries)
+{
+	uint32 result = 0;
+
+	Iop::CMcServ::CMD cmd;
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.maxEntries = static_cast<int32>(entries.size());
+	strncpy(cmd.name, query.c_str(), sizeof(cmd.name) - 1);
+
+	mcServ->Invoke(MCSERV_CMD(CMD_ID_GETDIR), reinterpret_cast<uint32*>(&cmd), sizeof(cmd), &result, sizeof(uint32), reinterpret_cast<uint8*>(entries.data()));
+	return result;
+}
+
+uint32 InvokeFileCommand(Iop::CMcServ* mcServ, uint32 method, const std::string& name, uint32 flags = 0, uint8* ram = nullptr)
+{
+	uint32 result = 0;
+
+	Iop::CMcServ::CMD cmd;
+	memset(&cmd, 0, sizeof(cmd));
+	cmd.flags = flags;
+	strncpy(cmd.name, name.c_str(), sizeof(cmd.name) - 1);
+
+	mcServ->Invoke(method, reinterpret_cast<uint32*>(&cmd), sizeof(cmd), &result, sizeof(uint32), ram);
+	return result;
+}
+
+//Checks that GetDir sees changes made through the module without having to rebuild the directory index,
+//and that changes made on the host behind the index's back don't prevent files from being modified.
+void ExecuteIndexUpdateTest()
+{
+	auto mcPathPreference = Iop::CMcServ::GetMcPathPreference(0);
+	auto memoryCardPath = fs::path("./memorycard_index");
+	fs::remove_all(memoryCardPath);
+	Framework::PathUtils::EnsurePathExists(memoryCardPath / "BASLUS-20000");
+
+	CAppConfig::GetInstance().RegisterPreferencePath(mcPathPreference, "");
+	CAppConfig::GetInstance().SetPreferencePath(mcPathPreference, memoryCardPath);
+	CAppConfig::GetInstance().RegisterPreferenceBoolean(PREF_PS2_MC_DIRECTORYINDEX_WATCH_ENABLED, false);
+	CAppConfig::GetInstance().SetPreferenceBoolean(PREF_PS2_MC_DIRECTORYINDEX_WATCH_ENABLED, false);
+
+	Iop::CSubSystem subSystem(true);
+	subSystem.Reset();
+	auto bios = static_cast<CIopBios*>(subSystem.m_bios.get());
+	bios->Reset(PS2::IOP_BASE_RAM_SIZE, std::shared_ptr<Iop::CSifMan>());
+	auto mcServ = bios->GetMcServ();
+
+	std::vector<Iop::CMcServ::ENTRY> entries(4);
+
+	//Builds the index
+	CHECK(InvokeGetDir(mcServ, "/BASLUS-20000/*", entries) == 2);
+
+	//Write
+	{
+		auto handle = InvokeFileCommand(mcServ, MCSERV_CMD(CMD_ID_OPEN), "/BASLUS-20000/SAVEDATA",
+		                                Iop::CMcServ::OPEN_FLAG_CREAT | Iop::CMcServ::OPEN_FLAG_WRONLY);
+		CHECK(static_cast<int32>(handle) >= 0);
+
+		uint8 data[0x100] = {};
+		uint32 result = 0;
+		Iop::CMcServ::FILECMD cmd;
+		memset(&cmd, 0, sizeof(cmd));
+		cmd.handle = handle;
+		cmd.size = sizeof(data);
+		mcServ->Invoke(MCSERV_CMD(CMD_ID_WRITE), reinterpret_cast<uint32*>(&cmd), sizeof(cmd), &result, sizeof(uint32), data);
+		CHECK(result == sizeof(data));
+
+		//Size must be up to date even before the file is closed
+		CHECK(InvokeGetDir(mcServ, "/BASLUS-20000/SAVEDATA", entries) == 1);
+		CHECK(entries[0].size == sizeof(data));
+
+		mcServ->Invoke(MCSERV_CMD(CMD_ID_CLOSE), reinterpret_cast<uint32*>(&cmd), sizeof(cmd), &result, sizeof(uint32), nullptr);
+		CHECK(result == 0);
+		CHECK(InvokeGetDir(mcServ, "/BASLUS-20000/*", entries) == 3);
+	}
+
+	//Rename
+	{
+		Iop::CMcServ::ENTRY entry;
+		memset(&entry, 0, sizeof(entry));
+		strcpy(reinterpret_cast<char*>(entry.name), "SAVEDATA.BAK");
+		auto result = InvokeFileCommand(mcServ, MCSERV_CMD(CMD_ID_SETFILEINFO), "/BASLUS-20000/SAVEDATA",
+		                                Iop::CMcServ::MC_FILE_ATTR_FILE, reinterpret_cast<uint8*>(&entry));
+		CHECK(result == 0);
+		CHECK(InvokeGetDir(mcServ, "/BASLUS-20000/SAVEDATA", entries) == 0);
+		CHECK(InvokeGetDir(mcServ, "/BASLUS-20000/SAVEDATA.BAK", entries) == 1);
+		CHECK(entries[0].size == 0x100);
+	}
+
+	//Delete
+	{
+		auto result = InvokeFileCommand(mcServ, MCSERV_CMD(CMD_ID_DELETE), "/BASLUS-20000/SAVEDATA.BAK");
+		CHECK(result == 0);
+		CHECK(InvokeGetDir(mcServ, "/BASLUS-20000/SAVEDATA.BAK", entries) == 0);
+		CHECK(InvokeGetDir(mcServ, "/BASLUS-20000/*", entries) == 2);
+	}
+
+	//File created on the host after the index was built, unknown to the index
+	{
+		auto fileStream = Framework::CreateOutputStdStream((memoryCardPath / "BASLUS-20000" / "icon.sys").native());
+		fileStream.Write32(0);
+	}
+	{
+		auto result = InvokeFileCommand(mcServ, MCSERV_CMD(CMD_ID_DELETE), "/BASLUS-20000/icon.sys");
+		CHECK(result == 0);
+		CHECK(!fs::exists(memoryCardPath / "BASLUS-20000" / "icon.sys"));
+	}
+
+	fs::remove_all(memoryCardPath);
+}
+
+//Simulates a game looking for its saves at boot: list the root directory, then look for a file in every save.
+//Cold passes reset the module before every query, which is close to what was done before directory indices.
+void ExecuteBenchmark(unsigned int saveCount, unsigned int passCount)
+{
+	auto mcPathPreference = Iop::CMcServ::GetMcPathPreference(0);
+	auto memoryCardPath = fs::path("./memorycard_benchmark");
+	fs::remove_all(memoryCardPath);
+
+	for(unsigned int i = 0; i < saveCount; i++)
+	{
+		auto savePath = memoryCardPath / string_format("BASLUS-2%04d", i);
+		Framework::PathUtils::EnsurePathExists(savePath);
+		for(const char* fileName : {"icon.sys", "view.ico", "SAVEDATA"})
+		{
+			auto fileStream = Framework::CreateOutputStdStream((savePath / fileName).native());
+			fileStream.Write32(i);
+		}
+	}
+
+	CAppConfig::GetInstance().RegisterPreferencePath(mcPathPreference, "");
+	CAppConfig::GetInstance().SetPreferencePath(mcPathPreference, memoryCardPath);
+
+	Iop::CSubSystem subSystem(true);
+	subSystem.Reset();
+	auto bios = static_cast<CIopBios*>(subSystem.m_bios.get());
+	bios->Reset(PS2::IOP_BASE_RAM_SIZE, std::shared_ptr<Iop::CSifMan>());
+	auto mcServ = bios->GetMcServ();
+
+	std::vector<Iop::CMcServ::ENTRY> entries(saveCount + 2);
+
+	auto runPass = [&](bool cold) {
+		uint32 foundCount = 0;
+		auto startTime = std::chrono::steady_clock::now();
+		if(cold) mcServ->SetModuleVersion(0);
+		CHECK(InvokeGetDir(mcServ, "/*", entries) == (saveCount + 2));
+		for(unsigned int i = 0; i < saveCount; i++)
+		{
+			if(cold) mcServ->SetModuleVersion(0);
+			foundCount += InvokeGetDir(mcServ, string_format("/BASLUS-2%04d/icon.sys", i), entries);
+		}
+		CHECK(foundCount == saveCount);
+		return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime);
+	};
+
+	for(bool cold : {true, false})
+	{
+		std::chrono::microseconds totalTime(0);
+		for(unsigned int i = 0; i < passCount; i++)
+		{
+			totalTime += runPass(cold);
+		}
+		auto queryCount = static_cast<double>(passCount) * (saveCount + 1);
+		printf("%s: %u saves, %u passes, %.3fms per pass, %.3fus per query.\n",
+		       cold ? "Cold" : "Indexed", saveCount, passCount,
+		       static_cast<double>(totalTime.count()) / (1000.0 * passCount),
+		       static_cast<double>(totalTime.count()) / queryCount);
+	}
+
+	fs::remove_all(memoryCardPath);
+}
+
 int main(int argc, const char** argv)
 {
+	//McServTest --benchmark [saveCount] [passCount]
+	if((argc >= 2) && !strcmp(argv[1], "--benchmark"))
+	{
+		unsigned int saveCount = (argc >= 3) ? atoi(argv[2]) : 100;
+		unsigned int passCount = (argc >= 4) ? atoi(argv[3]) : 10;
+		ExecuteBenchmark(saveCount, passCount);
+		return 0;
+	}
+
 	auto testsPath = fs::path("./tests/");
 
 	fs::directory_iterator endDirectoryIterator;
@@ -120,5 +303,7 @@ int main(int argc, const char** argv)
 		}
 	}
 
+	ExecuteIndexUpdateTest();
+
 	return 0;
 }
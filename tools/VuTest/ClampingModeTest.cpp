@@ -0,0 +1,78 @@
+#include "ClampingModeTest.h"
+#include "VuAssembler.h"
+#include "Ps2Const.h"
+
+void CClampingModeTest::Execute(CTestVm& virtualMachine)
+{
+	virtualMachine.Reset();
+
+	auto microMem = reinterpret_cast<uint32*>(virtualMachine.m_microMem);
+
+	CVuAssembler assembler(microMem);
+
+	//SUB clamps both operands
+	assembler.Write(
+	    CVuAssembler::Upper::SUB(CVuAssembler::DEST_XYZW, CVuAssembler::VF2, CVuAssembler::VF1, CVuAssembler::VF3),
+	    CVuAssembler::Lower::NOP());
+
+	//ADDbc doesn't clamp the broadcasted operand
+	assembler.Write(
+	    CVuAssembler::Upper::ADDbc(CVuAssembler::DEST_XYZW, CVuAssembler::VF4, CVuAssembler::VF3, CVuAssembler::VF1, CVuAssembler::BC_X),
+	    CVuAssembler::Lower::NOP());
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP() | CVuAssembler::Upper::E_BIT,
+	    CVuAssembler::Lower::NOP());
+
+	assembler.Write(
+	    CVuAssembler::Upper::NOP(),
+	    CVuAssembler::Lower::NOP());
+
+	//Run the same program with every mode without resetting the executor
+	//to make sure blocks compiled with another mode are not reused
+	ExecuteWithMode(virtualMachine, FpUtils::CLAMPING_MODE_FULL);
+	ExecuteWithMode(virtualMachine, FpUtils::CLAMPING_MODE_RESULT);
+	ExecuteWithMode(virtualMachine, FpUtils::CLAMPING_MODE_NONE);
+	ExecuteWithMode(virtualMachine, FpUtils::CLAMPING_MODE_FULL);
+}
+
+void CClampingModeTest::ExecuteWithMode(CTestVm& virtualMachine, FpUtils::CLAMPING_MODE clampingMode)
+{
+	static const uint32 g_posInf = 0x7F800000;
+	static const uint32 g_negInf = 0xFF800000;
+	static const uint32 g_posMax = 0x7F7FFFFF;
+	static const uint32 g_negMax = 0xFF7FFFFF;
+
+	virtualMachine.m_cpu.m_clampingMode = clampingMode;
+	virtualMachine.m_executor.ClearActiveBlocksInRange(0, PS2::MICROMEM1SIZE, false);
+
+	auto& state = virtualMachine.m_cpu.m_State;
+
+	state.nCOP2[1].nV0 = g_posInf;
+	state.nCOP2[1].nV1 = g_negInf;
+	state.nCOP2[1].nV2 = Float::_2;
+	state.nCOP2[1].nV3 = Float::_1;
+
+	state.nCOP2[3].nV0 = Float::_1;
+	state.nCOP2[3].nV1 = Float::_1;
+	state.nCOP2[3].nV2 = Float::_1;
+	state.nCOP2[3].nV3 = Float::_1;
+
+	virtualMachine.ExecuteTest(0);
+
+	bool clampsValues = (clampingMode != FpUtils::CLAMPING_MODE_NONE);
+
+	TEST_VERIFY(state.nCOP2[2].nV0 == (clampsValues ? g_posMax : g_posInf));
+	TEST_VERIFY(state.nCOP2[2].nV1 == (clampsValues ? g_negMax : g_negInf));
+	TEST_VERIFY(state.nCOP2[2].nV2 == Float::_1);
+	TEST_VERIFY(state.nCOP2[2].nV3 == Float::_0);
+
+	//Only clamping the result gets rid of the INF operand that isn't clamped
+	uint32 addResult = (clampingMode == FpUtils::CLAMPING_MODE_RESULT) ? g_posMax : g_posInf;
+	TEST_VERIFY(state.nCOP2[4].nV0 == addResult);
+	TEST_VERIFY(state.nCOP2[4].nV1 == addResult);
+	TEST_VERIFY(state.nCOP2[4].nV2 == addResult);
+	TEST_VERIFY(state.nCOP2[4].nV3 == addResult);
+
+	virtualMachine.m_cpu.m_clampingMode = FpUtils::CLAMPING_MODE_FULL;
+}
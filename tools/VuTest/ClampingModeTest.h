@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Test.h"
+
+class CClampingModeTest : public CTest
+{
+public:
+	void Execute(CTestVm&) override;
+
+private:
+	void ExecuteWithMode(CTestVm&, FpUtils::CLAMPING_MODE);
+};
@@ -4,6 +4,7 @@
 #include "FpUtils.h"
 #include "AddTest.h"
 #include "BranchTest.h"
+#include "ClampingModeTest.h"
 #include "DynamicStallTest.h"
 #include "DynamicStallTest2.h"
 #include "FdivEfuMixTest.h"
@@ -31,6 +32,7 @@ static const TestFactoryFunction s_factories[] =
 {
 	[]() { return new CAddTest(); },
 	[]() { return new CBranchTest(); },
+	[]() { return new CClampingModeTest(); },
 	[]() { return new CDynamicStallTest(); },
 	[]() { return new CDynamicStallTest2(); },
 	[]() { return new CFdivEfuMixTest(); },